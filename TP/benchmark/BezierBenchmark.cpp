@@ -0,0 +1,472 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Vroom/Core/Log.h>
+
+#include "BasisCache.h"
+#include "Bezier.h"
+#include "BezierTriangle.h"
+#include "NurbsSurface.h"
+#include "WorkerPool.h"
+
+// Headless Bezier benchmark: no window nor GL context, only Bezier::polygonize.
+// Sweeps degrees x resolutions for every evaluation mode, with cold and warm caches, and direct evaluation at every SIMD level of the CPU:
+// - cold: a new surface per run, with an empty BasisCache, so basis tables and buffers are built again,
+// - warm: the same surface polygonized again after a control point change,
+// - shared: another new surface of the same degree and resolution, which finds its basis tables in BasisCache.
+// Results go to one file per mode and cache state in the extractedData/data.txt format, and to results.json.
+// results.json also holds the error of every mode and SIMD level against scalar direct evaluation.
+// NURBS surfaces of one span, the same patches as rational B-splines, are timed as well and compared with the Bezier patch.
+// Triangular patches are timed at subdivision level = resolution, a grid of about half the samples: throughputs are in samples per second for both.
+
+struct BenchmarkSettings
+{
+	std::vector<uint32_t> degrees = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+	std::vector<uint32_t> resolutions = { 10, 100, 1000 };
+	uint32_t repetitions = 5;
+	uint32_t threadCount = 0;
+	uint32_t anchorInterval = Bezier::DefaultAnchorInterval;
+	bool specializedKernels = true;
+	// Empty runs every supported level
+	std::vector<SimdLevel> simdLevels;
+	Bezier::MeshLayout meshLayout = Bezier::MeshLayout::FlatShaded;
+	Bezier::NormalMode normalMode = Bezier::NormalMode::FiniteDifference;
+	std::filesystem::path outputDirectory = "benchmarkResults";
+};
+
+struct Measure
+{
+	const char* mode;
+	const char* simd;
+	const char* cache;
+	uint32_t degree;
+	uint32_t resolution;
+	double minSeconds;
+	double medianSeconds;
+	double p95Seconds;
+	double samplesPerSecond;
+	Bezier::EvaluationError error;
+};
+
+static std::vector<uint32_t> ParseList(const std::string& list)
+{
+	std::vector<uint32_t> values;
+	std::stringstream stream(list);
+
+	for (std::string value; std::getline(stream, value, ',');)
+		values.push_back(static_cast<uint32_t>(std::stoul(value)));
+
+	return values;
+}
+
+static bool ParseArguments(int argc, char** argv, BenchmarkSettings& settings)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (argument == "--quick")
+		{
+			settings.degrees = { 1, 3 };
+			settings.resolutions = { 10, 50 };
+			settings.repetitions = 3;
+			continue;
+		}
+
+		if (argument == "--generic-kernels")
+		{
+			settings.specializedKernels = false;
+			continue;
+		}
+
+		if (!value)
+		{
+			std::cerr << "Missing value after " << argument << std::endl;
+			return false;
+		}
+
+		if (argument == "--degrees")
+			settings.degrees = ParseList(value);
+		else if (argument == "--resolutions")
+			settings.resolutions = ParseList(value);
+		else if (argument == "--repetitions")
+			settings.repetitions = std::max(static_cast<uint32_t>(std::stoul(value)), 1u);
+		else if (argument == "--threads")
+			settings.threadCount = static_cast<uint32_t>(std::stoul(value));
+		else if (argument == "--anchor-interval")
+			settings.anchorInterval = std::max(static_cast<uint32_t>(std::stoul(value)), 1u);
+		else if (argument == "--simd")
+		{
+			const std::string level = value;
+			if (level == "avx512")
+				settings.simdLevels = { SimdLevel::AVX512 };
+			else if (level == "avx2")
+				settings.simdLevels = { SimdLevel::AVX2 };
+			else
+				settings.simdLevels = { SimdLevel::Scalar };
+		}
+		else if (argument == "--layout")
+			settings.meshLayout = std::string(value) == "indexed" ? Bezier::MeshLayout::IndexedGrid : Bezier::MeshLayout::FlatShaded;
+		else if (argument == "--normals")
+			settings.normalMode = std::string(value) == "analytic" ? Bezier::NormalMode::Analytic : Bezier::NormalMode::FiniteDifference;
+		else if (argument == "--output")
+			settings.outputDirectory = value;
+		else
+		{
+			std::cerr << "Unknown argument " << argument << std::endl;
+			return false;
+		}
+
+		i++;
+	}
+
+	return true;
+}
+
+static Bezier MakeBezier(const BenchmarkSettings& settings, Bezier::EvaluationMode mode, SimdLevel simdLevel, uint32_t degree, uint32_t resolution)
+{
+	Bezier bezier(degree, degree, resolution, resolution);
+	bezier.setEvaluationMode(mode);
+	bezier.setSimdLevel(simdLevel);
+	bezier.setMeshLayout(settings.meshLayout);
+	bezier.setNormalMode(settings.normalMode);
+	bezier.setThreadCount(settings.threadCount);
+	bezier.setSpecializedKernels(settings.specializedKernels);
+	bezier.setAnchorInterval(settings.anchorInterval);
+
+	// Same layout as MyScene, with a fixed seed so that runs are comparable
+	std::srand(degree);
+
+	for (uint32_t u = 0; u <= degree; u++)
+		for (uint32_t v = 0; v <= degree; v++)
+			bezier.setControlPoint(u, v, { static_cast<float>(u) / degree * 10.f, static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX) * 2.f, static_cast<float>(v) / degree * 10.f });
+
+	return bezier;
+}
+
+static BezierTriangle MakeTriangle(const BenchmarkSettings& settings, uint32_t degree, uint32_t level)
+{
+	BezierTriangle triangle(degree, level);
+	triangle.setThreadCount(settings.threadCount);
+
+	// The same spread as MakeBezier, over half of the square
+	std::srand(degree);
+
+	for (uint32_t i = 0; i <= degree; i++)
+		for (uint32_t j = 0; i + j <= degree; j++)
+			triangle.setControlPoint(i, j, { static_cast<float>(i) / degree * 10.f, static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX) * 2.f, static_cast<float>(j) / degree * 10.f });
+
+	return triangle;
+}
+
+static NurbsSurface MakeNurbs(const BenchmarkSettings& settings, const Bezier& bezier, uint32_t resolution)
+{
+	const uint32_t degree = bezier.getDegreeU();
+
+	NurbsSurface nurbs(degree, degree, degree + 1, degree + 1, resolution, resolution);
+	nurbs.setThreadCount(settings.threadCount);
+
+	for (uint32_t u = 0; u <= degree; u++)
+		for (uint32_t v = 0; v <= degree; v++)
+			nurbs.setControlPoint(u, v, bezier.getControlPoint(u, v));
+
+	return nurbs;
+}
+
+// Both grids are indexed, with analytic normals
+static Bezier::EvaluationError CompareMeshes(const vrm::MeshData& evaluated, const vrm::MeshData& exact)
+{
+	Bezier::EvaluationError error;
+	double squaredErrorSum = 0.0;
+	float minNormalCosine = 1.f;
+
+	for (size_t i = 0; i < std::min(evaluated.getVertexCount(), exact.getVertexCount()); i++)
+	{
+		const float positionError = glm::length(evaluated.getVertices()[i].position - exact.getVertices()[i].position);
+		error.maxPositionError = std::max(error.maxPositionError, positionError);
+		squaredErrorSum += static_cast<double>(positionError) * positionError;
+		minNormalCosine = std::min(minNormalCosine, glm::dot(evaluated.getVertices()[i].normal, exact.getVertices()[i].normal));
+	}
+
+	error.rmsPositionError = exact.getVertexCount() > 0 ? static_cast<float>(std::sqrt(squaredErrorSum / static_cast<double>(exact.getVertexCount()))) : 0.f;
+	error.maxNormalAngle = glm::degrees(std::acos(std::clamp(minNormalCosine, -1.f, 1.f)));
+
+	return error;
+}
+
+static double Seconds(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+	return std::chrono::duration<double>(end - begin).count();
+}
+
+static Measure Summarize(const char* mode, const char* simd, const char* cache, uint32_t degree, uint32_t resolution, double samples, std::vector<double> seconds)
+{
+	std::sort(seconds.begin(), seconds.end());
+
+	auto percentile = [&](double p)
+	{
+		const size_t rank = static_cast<size_t>(p * static_cast<double>(seconds.size() - 1) + 0.5);
+		return seconds[std::min(rank, seconds.size() - 1)];
+	};
+
+	const double median = percentile(0.5);
+
+	return { mode, simd, cache, degree, resolution, seconds.front(), median, percentile(0.95), median > 0.0 ? samples / median : 0.0, {} };
+}
+
+static void WriteDataFile(const std::filesystem::path& path, const std::vector<Measure>& measures, const char* mode, const char* simd, const char* cache)
+{
+	std::ofstream file(path);
+	file << "Degree U and V | Resolution U and V | Compute Time\n";
+
+	for (const Measure& measure : measures)
+		if (std::string(measure.mode) == mode && std::string(measure.simd) == simd && std::string(measure.cache) == cache)
+			file << measure.degree << " | " << measure.resolution << " | " << measure.medianSeconds << "\n";
+}
+
+static void WriteJson(const std::filesystem::path& path, const BenchmarkSettings& settings, const std::vector<Measure>& measures)
+{
+	std::ofstream file(path);
+
+	file << "{\n";
+	file << "  \"threads\": " << (settings.threadCount == 0 ? WorkerPool::HardwareThreadCount() : settings.threadCount) << ",\n";
+	file << "  \"layout\": \"" << (settings.meshLayout == Bezier::MeshLayout::IndexedGrid ? "indexed" : "flat") << "\",\n";
+	file << "  \"normals\": \"" << (settings.normalMode == Bezier::NormalMode::Analytic ? "analytic" : "finiteDifference") << "\",\n";
+	file << "  \"specializedKernels\": " << (settings.specializedKernels ? "true" : "false") << ",\n";
+	file << "  \"anchorInterval\": " << settings.anchorInterval << ",\n";
+	file << "  \"bestSimdLevel\": \"" << SimdDeCasteljau::LevelName(SimdDeCasteljau::BestLevel()) << "\",\n";
+	file << "  \"repetitions\": " << settings.repetitions << ",\n";
+
+	const BasisCache::Stats basisStats = BasisCache::Get().getStats();
+	file << "  \"basisCache\": { \"hits\": " << basisStats.hits << ", \"misses\": " << basisStats.misses << ", \"evictions\": " << basisStats.evictions << " },\n";
+	file << "  \"results\": [\n";
+
+	for (size_t i = 0; i < measures.size(); i++)
+	{
+		const Measure& m = measures[i];
+		file << "    { \"mode\": \"" << m.mode << "\", \"simd\": \"" << m.simd << "\", \"cache\": \"" << m.cache << "\", \"degree\": " << m.degree << ", \"resolution\": " << m.resolution
+			<< ", \"minSeconds\": " << m.minSeconds << ", \"medianSeconds\": " << m.medianSeconds << ", \"p95Seconds\": " << m.p95Seconds
+			<< ", \"samplesPerSecond\": " << m.samplesPerSecond << ", \"maxPositionError\": " << m.error.maxPositionError << ", \"rmsPositionError\": " << m.error.rmsPositionError
+			<< ", \"maxNormalAngleDegrees\": " << m.error.maxNormalAngle << " }" << (i + 1 < measures.size() ? "," : "") << "\n";
+	}
+
+	file << "  ]\n";
+	file << "}\n";
+}
+
+int main(int argc, char** argv)
+{
+	Log::Init();
+
+	BenchmarkSettings settings;
+	if (!ParseArguments(argc, argv, settings))
+	{
+		std::cerr << "Usage: BezierBenchmark [--quick] [--generic-kernels] [--degrees 1,2,3] [--resolutions 10,100] [--repetitions n] [--threads n] [--anchor-interval n] [--simd scalar|avx2|avx512] [--layout flat|indexed] [--normals finiteDifference|analytic] [--output directory]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (settings.simdLevels.empty())
+		for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512 })
+			if (SimdDeCasteljau::IsSupported(level))
+				settings.simdLevels.push_back(level);
+
+	// Only direct evaluation is batched, the other modes run their scalar kernels once
+	struct Run
+	{
+		Bezier::EvaluationMode mode;
+		const char* modeName;
+		SimdLevel simdLevel;
+	};
+
+	std::vector<Run> runs;
+
+	for (SimdLevel level : settings.simdLevels)
+	{
+		if (!SimdDeCasteljau::IsSupported(level))
+		{
+			VRM_LOG_WARN("Skipping direct evaluation with {}, unsupported on this CPU", SimdDeCasteljau::LevelName(level));
+			continue;
+		}
+
+		runs.push_back({ Bezier::EvaluationMode::Direct, "direct", level });
+	}
+
+	runs.push_back({ Bezier::EvaluationMode::Separable, "separable", SimdLevel::Scalar });
+	runs.push_back({ Bezier::EvaluationMode::ForwardDifference, "forwardDifference", SimdLevel::Scalar });
+
+	// Starts the worker pool outside of any measure
+	MakeBezier(settings, Bezier::EvaluationMode::Separable, SimdLevel::Scalar, 1, 2).polygonize();
+
+	std::vector<Measure> measures;
+
+	// Timings of every cache state, by name
+	using Timings = std::vector<std::pair<const char*, std::vector<double>>>;
+
+	// Samples of a resolution x resolution grid, unless given
+	auto record = [&](const char* modeName, const char* simdName, uint32_t degree, uint32_t resolution, const Timings& timings, const Bezier::EvaluationError& error, double samples = 0.0)
+	{
+		if (samples == 0.0)
+			samples = static_cast<double>(resolution) * resolution;
+
+		for (const auto& [cache, seconds] : timings)
+		{
+			Measure measure = Summarize(modeName, simdName, cache, degree, resolution, samples, seconds);
+			measure.error = error;
+			VRM_LOG_INFO("{:>17} {:>6} {:<6} degree {:>2} resolution {:>5}: min {:.6f}s, median {:.6f}s, p95 {:.6f}s, {:.3e} samples/s, max error {:.2e}",
+				measure.mode, measure.simd, measure.cache, measure.degree, measure.resolution, measure.minSeconds, measure.medianSeconds, measure.p95Seconds, measure.samplesPerSecond, measure.error.maxPositionError);
+			measures.push_back(measure);
+		}
+	};
+
+	for (const auto& [mode, modeName, simdLevel] : runs)
+	{
+		const char* simdName = SimdDeCasteljau::LevelName(simdLevel);
+
+		for (uint32_t degree : settings.degrees)
+		{
+			for (uint32_t resolution : settings.resolutions)
+			{
+				std::vector<double> cold, warm, shared;
+				Bezier::EvaluationError error;
+
+				for (uint32_t run = 0; run < settings.repetitions; run++)
+				{
+					BasisCache::Get().clear();
+					Bezier bezier = MakeBezier(settings, mode, simdLevel, degree, resolution);
+
+					std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+					bezier.polygonize();
+					std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+					cold.push_back(Seconds(begin, end));
+
+					// Invalidates the mesh only, basis tables and derivative net storage stay
+					bezier.setControlPoint(0, 0, bezier.getControlPoint(0, 0));
+
+					begin = std::chrono::steady_clock::now();
+					bezier.polygonize();
+					end = std::chrono::steady_clock::now();
+					warm.push_back(Seconds(begin, end));
+
+					Bezier other = MakeBezier(settings, mode, simdLevel, degree, resolution);
+
+					begin = std::chrono::steady_clock::now();
+					other.polygonize();
+					end = std::chrono::steady_clock::now();
+					shared.push_back(Seconds(begin, end));
+
+					// Outside of the measures, and once: the surface is the same for every run
+					if (run == 0 && (mode != Bezier::EvaluationMode::Direct || simdLevel != SimdLevel::Scalar))
+						error = bezier.measureEvaluationError();
+				}
+
+				record(modeName, simdName, degree, resolution, { { "cold", cold }, { "warm", warm }, { "shared", shared } }, error);
+			}
+		}
+	}
+
+	for (uint32_t degree : settings.degrees)
+	{
+		for (uint32_t resolution : settings.resolutions)
+		{
+			std::vector<double> cold, warm;
+			Bezier::EvaluationError error;
+
+			for (uint32_t run = 0; run < settings.repetitions; run++)
+			{
+				Bezier bezier = MakeBezier(settings, Bezier::EvaluationMode::Direct, SimdLevel::Scalar, degree, resolution);
+				NurbsSurface nurbs = MakeNurbs(settings, bezier, resolution);
+
+				std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				nurbs.polygonize();
+				std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				cold.push_back(Seconds(begin, end));
+
+				// Invalidates the mesh only, the basis tables stay
+				nurbs.setControlPoint(0, 0, nurbs.getControlPoint(0, 0));
+
+				begin = std::chrono::steady_clock::now();
+				nurbs.polygonize();
+				end = std::chrono::steady_clock::now();
+				warm.push_back(Seconds(begin, end));
+
+				if (run == 0)
+				{
+					bezier.setMeshLayout(Bezier::MeshLayout::IndexedGrid);
+					bezier.setNormalMode(Bezier::NormalMode::Analytic);
+					error = CompareMeshes(nurbs.polygonize(), bezier.polygonize());
+				}
+			}
+
+			record("nurbs", SimdDeCasteljau::LevelName(SimdLevel::Scalar), degree, resolution, { { "cold", cold }, { "warm", warm } }, error);
+		}
+	}
+
+	for (uint32_t degree : settings.degrees)
+	{
+		for (uint32_t resolution : settings.resolutions)
+		{
+			std::vector<double> cold, warm;
+			Bezier::EvaluationError error;
+
+			for (uint32_t run = 0; run < settings.repetitions; run++)
+			{
+				BezierTriangle triangle = MakeTriangle(settings, degree, resolution);
+
+				std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				triangle.polygonize();
+				std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				cold.push_back(Seconds(begin, end));
+
+				// Invalidates the mesh and the nets, the power tables stay
+				triangle.setControlPoint(0, 0, triangle.getControlPoint(0, 0));
+
+				begin = std::chrono::steady_clock::now();
+				triangle.polygonize();
+				end = std::chrono::steady_clock::now();
+				warm.push_back(Seconds(begin, end));
+
+				if (run == 0)
+					error = triangle.measureEvaluationError();
+			}
+
+			record("triangle", SimdDeCasteljau::LevelName(SimdLevel::Scalar), degree, resolution, { { "cold", cold }, { "warm", warm } }, error, static_cast<double>(BarycentricBasis::PointCount(resolution)));
+		}
+	}
+
+	std::filesystem::create_directories(settings.outputDirectory);
+
+	for (const auto& [mode, modeName, simdLevel] : runs)
+	{
+		// Scalar runs keep their historical file names
+		const char* simdName = SimdDeCasteljau::LevelName(simdLevel);
+		const std::string suffix = simdLevel == SimdLevel::Scalar ? std::string() : std::string("_") + simdName;
+
+		for (const char* cache : { "cold", "warm", "shared" })
+			WriteDataFile(settings.outputDirectory / (std::string("data_") + modeName + suffix + "_" + cache + ".txt"), measures, modeName, simdName, cache);
+	}
+
+	for (const char* cache : { "cold", "warm" })
+	{
+		WriteDataFile(settings.outputDirectory / (std::string("data_nurbs_") + cache + ".txt"), measures, "nurbs", SimdDeCasteljau::LevelName(SimdLevel::Scalar), cache);
+		WriteDataFile(settings.outputDirectory / (std::string("data_triangle_") + cache + ".txt"), measures, "triangle", SimdDeCasteljau::LevelName(SimdLevel::Scalar), cache);
+	}
+
+	WriteJson(settings.outputDirectory / "results.json", settings, measures);
+
+	const BasisCache::Stats basisStats = BasisCache::Get().getStats();
+	VRM_LOG_INFO("Basis cache: {} hits, {} misses, {} evictions", basisStats.hits, basisStats.misses, basisStats.evictions);
+
+	VRM_LOG_INFO("Results written to {}", settings.outputDirectory.string());
+
+	return EXIT_SUCCESS;
+}
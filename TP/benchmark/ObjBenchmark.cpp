@@ -0,0 +1,426 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Vroom/Asset/AssetData/MeshOptimizer.h>
+#include <Vroom/Asset/Parsing/MeshCache.h>
+#include <Vroom/Asset/Parsing/ObjParsing.h>
+#include <Vroom/Core/Log.h>
+
+#include <OBJ_Loader/OBJ_Loader.h>
+
+// Headless OBJ import benchmark: parse throughput in MB/s of the source text, on generated files of increasing size.
+// Each file is an n x n grid of quads with positions, texture coordinates and normals, split in two materials:
+// - obj: ObjParsing, for every thread count asked,
+// - objl: the OBJ_Loader parser it replaced, as a baseline,
+// - cache: the same meshes mapped from their .vmesh file, throughput still counted in bytes of OBJ text,
+// Then MeshOptimizer is timed on the parsed meshes, in triangles per second, with their vertex cache statistics before and after.
+// Parsers go to the results of results.json, the optimizer to its optimization entries. Generated files are removed afterwards unless asked otherwise.
+
+struct BenchmarkSettings
+{
+	std::vector<uint32_t> gridSizes = { 100, 400, 1000 };
+	std::vector<uint32_t> threadCounts = { 1, 0 };
+	uint32_t repetitions = 5;
+	bool baseline = true;
+	bool keepFiles = false;
+	std::filesystem::path outputDirectory = "objBenchmarkResults";
+};
+
+struct Measure
+{
+	std::string parser;
+	uint32_t threads;
+	uint32_t gridSize;
+	double megabytes;
+	double minSeconds;
+	double medianSeconds;
+	double p95Seconds;
+	double megabytesPerSecond;
+	size_t vertexCount;
+	size_t triangleCount;
+};
+
+struct OptimizationMeasure
+{
+	uint32_t gridSize;
+	double minSeconds;
+	double medianSeconds;
+	double trianglesPerSecond;
+	vrm::MeshOptimizer::Report report;
+};
+
+static std::vector<uint32_t> ParseList(const std::string& list)
+{
+	std::vector<uint32_t> values;
+	std::stringstream stream(list);
+
+	for (std::string value; std::getline(stream, value, ',');)
+		values.push_back(static_cast<uint32_t>(std::stoul(value)));
+
+	return values;
+}
+
+static bool ParseArguments(int argc, char** argv, BenchmarkSettings& settings)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (argument == "--quick")
+		{
+			settings.gridSizes = { 50, 200 };
+			settings.repetitions = 2;
+			continue;
+		}
+
+		if (argument == "--no-baseline")
+		{
+			settings.baseline = false;
+			continue;
+		}
+
+		if (argument == "--keep-files")
+		{
+			settings.keepFiles = true;
+			continue;
+		}
+
+		if (!value)
+		{
+			std::cerr << "Missing value after " << argument << std::endl;
+			return false;
+		}
+
+		if (argument == "--sizes")
+			settings.gridSizes = ParseList(value);
+		else if (argument == "--threads")
+			settings.threadCounts = ParseList(value);
+		else if (argument == "--repetitions")
+			settings.repetitions = std::max(static_cast<uint32_t>(std::stoul(value)), 1u);
+		else if (argument == "--output")
+			settings.outputDirectory = value;
+		else
+		{
+			std::cerr << "Unknown argument " << argument << std::endl;
+			return false;
+		}
+
+		i++;
+	}
+
+	return true;
+}
+
+// Elements first, then faces, as exporters write them. Values are written with the 6 decimals of most exporters.
+static void WriteGrid(const std::filesystem::path& path, uint32_t n)
+{
+	std::ofstream file(path);
+	file << "# Generated by ObjBenchmark\no Grid\n";
+
+	char line[128];
+
+	for (uint32_t i = 0; i <= n; i++)
+	{
+		for (uint32_t j = 0; j <= n; j++)
+		{
+			const float u = static_cast<float>(i) / static_cast<float>(n), v = static_cast<float>(j) / static_cast<float>(n);
+			const float height = 0.1f * static_cast<float>((i * 7 + j * 13) % 17) / 17.f;
+
+			std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", u * 10.f - 5.f, height, v * 10.f - 5.f);
+			file << line;
+		}
+	}
+
+	for (uint32_t i = 0; i <= n; i++)
+	{
+		for (uint32_t j = 0; j <= n; j++)
+		{
+			std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", static_cast<float>(i) / static_cast<float>(n), static_cast<float>(j) / static_cast<float>(n));
+			file << line;
+		}
+	}
+
+	for (uint32_t i = 0; i <= n; i++)
+	{
+		for (uint32_t j = 0; j <= n; j++)
+		{
+			file << "vn 0.000000 1.000000 0.000000\n";
+		}
+	}
+
+	file << "usemtl Mat_First\n";
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		if (i == n / 2)
+			file << "usemtl Mat_Second\n";
+
+		for (uint32_t j = 0; j < n; j++)
+		{
+			const uint32_t a = i * (n + 1) + j + 1, b = a + 1, c = a + n + 1, d = c + 1;
+			file << "f " << a << '/' << a << '/' << a << ' ' << c << '/' << c << '/' << c << ' ' << d << '/' << d << '/' << d << ' ' << b << '/' << b << '/' << b << '\n';
+		}
+	}
+}
+
+static double Seconds(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+	return std::chrono::duration<double>(end - begin).count();
+}
+
+static Measure Summarize(const std::string& parser, uint32_t threads, uint32_t gridSize, double megabytes, std::vector<double> seconds, size_t vertexCount, size_t triangleCount)
+{
+	std::sort(seconds.begin(), seconds.end());
+
+	auto percentile = [&](double p)
+	{
+		const size_t rank = static_cast<size_t>(p * static_cast<double>(seconds.size() - 1) + 0.5);
+		return seconds[std::min(rank, seconds.size() - 1)];
+	};
+
+	const double median = percentile(0.5);
+
+	return { parser, threads, gridSize, megabytes, seconds.front(), median, percentile(0.95), median > 0.0 ? megabytes / median : 0.0, vertexCount, triangleCount };
+}
+
+static void WriteJson(const std::filesystem::path& path, const BenchmarkSettings& settings, const std::vector<Measure>& measures, const std::vector<OptimizationMeasure>& optimizations)
+{
+	std::ofstream file(path);
+
+	file << "{\n";
+	file << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+	file << "  \"repetitions\": " << settings.repetitions << ",\n";
+	file << "  \"results\": [\n";
+
+	for (size_t i = 0; i < measures.size(); i++)
+	{
+		const Measure& m = measures[i];
+		file << "    { \"parser\": \"" << m.parser << "\", \"threads\": " << m.threads << ", \"gridSize\": " << m.gridSize << ", \"megabytes\": " << m.megabytes
+			<< ", \"minSeconds\": " << m.minSeconds << ", \"medianSeconds\": " << m.medianSeconds << ", \"p95Seconds\": " << m.p95Seconds
+			<< ", \"megabytesPerSecond\": " << m.megabytesPerSecond << ", \"vertices\": " << m.vertexCount << ", \"triangles\": " << m.triangleCount << " }"
+			<< (i + 1 < measures.size() ? "," : "") << "\n";
+	}
+
+	file << "  ],\n";
+	file << "  \"optimization\": [\n";
+
+	for (size_t i = 0; i < optimizations.size(); i++)
+	{
+		const OptimizationMeasure& m = optimizations[i];
+		const vrm::MeshOptimizer::Report& r = m.report;
+		file << "    { \"gridSize\": " << m.gridSize << ", \"minSeconds\": " << m.minSeconds << ", \"medianSeconds\": " << m.medianSeconds
+			<< ", \"trianglesPerSecond\": " << m.trianglesPerSecond << ", \"triangles\": " << r.after.triangleCount
+			<< ", \"acmrBefore\": " << r.before.getAcmr() << ", \"acmrAfter\": " << r.after.getAcmr() << ", \"atvrBefore\": " << r.before.getAtvr() << ", \"atvrAfter\": " << r.after.getAtvr() << " }"
+			<< (i + 1 < optimizations.size() ? "," : "") << "\n";
+	}
+
+	file << "  ]\n";
+	file << "}\n";
+}
+
+int main(int argc, char** argv)
+{
+	Log::Init();
+
+	BenchmarkSettings settings;
+	if (!ParseArguments(argc, argv, settings))
+	{
+		std::cerr << "Usage: ObjBenchmark [--quick] [--sizes 100,400] [--threads 1,0] [--repetitions n] [--no-baseline] [--keep-files] [--output directory]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::filesystem::create_directories(settings.outputDirectory);
+
+	std::vector<Measure> measures;
+	std::vector<OptimizationMeasure> optimizations;
+	bool failed = false;
+
+	auto record = [&](const Measure& measure)
+	{
+		VRM_LOG_INFO("{:>5} {:>3} threads grid {:>5} ({:>7.1f} MB): min {:.4f}s, median {:.4f}s, p95 {:.4f}s, {:>8.1f} MB/s, {} vertices, {} triangles",
+			measure.parser, measure.threads, measure.gridSize, measure.megabytes, measure.minSeconds, measure.medianSeconds, measure.p95Seconds, measure.megabytesPerSecond,
+			measure.vertexCount, measure.triangleCount);
+		measures.push_back(measure);
+	};
+
+	for (uint32_t gridSize : settings.gridSizes)
+	{
+		const std::filesystem::path path = settings.outputDirectory / ("grid_" + std::to_string(gridSize) + ".obj");
+		WriteGrid(path, gridSize);
+
+		const double megabytes = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+		const size_t expectedTriangles = static_cast<size_t>(gridSize) * gridSize * 2;
+
+		for (uint32_t threads : settings.threadCounts)
+		{
+			std::vector<double> seconds;
+			size_t vertexCount = 0, triangleCount = 0;
+
+			for (uint32_t run = 0; run < settings.repetitions; run++)
+			{
+				const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				std::optional<vrm::ObjParsing::ParsingResults> results = vrm::ObjParsing::Parse(path.string(), threads);
+				const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				seconds.push_back(Seconds(begin, end));
+
+				if (!results)
+				{
+					failed = true;
+					break;
+				}
+
+				vertexCount = triangleCount = 0;
+				for (const auto& mesh : results->meshes)
+				{
+					vertexCount += mesh.meshData.getVertexCount();
+					triangleCount += mesh.meshData.getTriangleCount();
+				}
+
+				// Both materials share the vertices of the middle row
+				if (triangleCount != expectedTriangles || vertexCount != static_cast<size_t>(gridSize + 1) * (gridSize + 2))
+					failed = true;
+
+				// Written once, for the cache measure
+				if (run == 0 && threads == settings.threadCounts.front())
+				{
+					std::vector<vrm::MeshData> meshes;
+					std::vector<std::string> names, materialNames;
+
+					for (auto& mesh : results->meshes)
+					{
+						meshes.push_back(std::move(mesh.meshData));
+						names.push_back(mesh.name);
+						materialNames.push_back(mesh.materialName);
+					}
+
+					failed |= !vrm::MeshCache::Write(path.string(), meshes, names, materialNames);
+				}
+			}
+
+			record(Summarize("obj", threads == 0 ? std::thread::hardware_concurrency() : threads, gridSize, megabytes, seconds, vertexCount, triangleCount));
+		}
+
+		{
+			std::vector<double> seconds;
+			size_t vertexCount = 0, triangleCount = 0;
+
+			for (uint32_t run = 0; run < settings.repetitions; run++)
+			{
+				// The copies into MeshData are what a load keeping its mesh data does too
+				const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				vrm::MeshCache cache;
+				std::vector<vrm::MeshData> meshes;
+
+				if (cache.open(path.string()))
+				{
+					for (size_t i = 0; i < cache.getMeshCount(); i++)
+					{
+						const vrm::MeshCache::MeshView mesh = cache.getMesh(i);
+						meshes.emplace_back(std::vector<vrm::Vertex>(mesh.vertices, mesh.vertices + mesh.vertexCount), std::vector<uint32_t>(mesh.indices, mesh.indices + mesh.indexCount), mesh.primitiveType);
+					}
+				}
+				else
+					failed = true;
+
+				const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				seconds.push_back(Seconds(begin, end));
+
+				vertexCount = triangleCount = 0;
+				for (const auto& mesh : meshes)
+				{
+					vertexCount += mesh.getVertexCount();
+					triangleCount += mesh.getTriangleCount();
+				}
+			}
+
+			record(Summarize("cache", 1, gridSize, megabytes, seconds, vertexCount, triangleCount));
+		}
+
+		if (std::optional<vrm::ObjParsing::ParsingResults> results = vrm::ObjParsing::Parse(path.string()))
+		{
+			std::vector<double> seconds;
+			vrm::MeshOptimizer::Report report;
+
+			for (uint32_t run = 0; run < settings.repetitions; run++)
+			{
+				// Every run starts from the meshes as parsed
+				std::vector<vrm::MeshData> meshes;
+				for (const auto& mesh : results->meshes)
+					meshes.push_back(mesh.meshData);
+
+				report = {};
+				const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				for (auto& mesh : meshes)
+					report += vrm::MeshOptimizer::Optimize(mesh);
+				const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				seconds.push_back(Seconds(begin, end));
+
+				if (report.after.triangleCount != expectedTriangles)
+					failed = true;
+			}
+
+			std::sort(seconds.begin(), seconds.end());
+			const double median = seconds[seconds.size() / 2];
+			const double trianglesPerSecond = median > 0.0 ? static_cast<double>(report.after.triangleCount) / median : 0.0;
+
+			VRM_LOG_INFO("  opt grid {:>5}: min {:.4f}s, median {:.4f}s, {:.1f} Mtriangles/s, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}", gridSize, seconds.front(), median,
+				trianglesPerSecond / 1e6, report.before.getAcmr(), report.after.getAcmr(), report.before.getAtvr(), report.after.getAtvr());
+			optimizations.push_back({ gridSize, seconds.front(), median, trianglesPerSecond, report });
+		}
+		else
+			failed = true;
+
+		if (settings.baseline)
+		{
+			std::vector<double> seconds;
+			size_t vertexCount = 0, triangleCount = 0;
+
+			for (uint32_t run = 0; run < settings.repetitions; run++)
+			{
+				objl::Loader loader;
+
+				const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				loader.LoadFile(path.string());
+				const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				seconds.push_back(Seconds(begin, end));
+
+				vertexCount = triangleCount = 0;
+				for (const auto& mesh : loader.LoadedMeshes)
+				{
+					vertexCount += mesh.Vertices.size();
+					triangleCount += mesh.Indices.size() / 3;
+				}
+			}
+
+			record(Summarize("objl", 1, gridSize, megabytes, seconds, vertexCount, triangleCount));
+		}
+
+		if (!settings.keepFiles)
+		{
+			std::filesystem::remove(path);
+			std::filesystem::remove(vrm::MeshCache::CachePath(path.string()));
+		}
+	}
+
+	WriteJson(settings.outputDirectory / "results.json", settings, measures, optimizations);
+
+	VRM_LOG_INFO("Results written to {}", settings.outputDirectory.string());
+
+	if (failed)
+	{
+		VRM_LOG_ERROR("Some files were not parsed as generated");
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <Vroom/Asset/AssetData/MeshData.h>
+
+#include <glm/glm.hpp>
+
+#include "SimdDeCasteljau.h"
+
+/**
+ * @brief Tessellates a Bezier patch by recursively splitting its control net (de Casteljau, at mid parameters)
+ * until every sub-net is within a flatness tolerance of the bilinear patch of its corners.
+ * Sub-patches are stitched without cracks: every leaf is fanned around its centre when a neighbour is finer,
+ * so both sides of an edge share the same vertices.
+ * Vertices are evaluated once the topology is known, in batches by SimdDeCasteljau unless the level is Scalar.
+ */
+class AdaptiveTessellator
+{
+public:
+	struct Stats
+	{
+		size_t triangleCount = 0;
+		// Triangles of a uniform grid as fine as the deepest leaf
+		size_t uniformTriangleCount = 0;
+		size_t patchCount = 0;
+		uint32_t depth = 0;
+	};
+
+	static constexpr uint32_t MaxDepth = 15;
+
+public:
+	AdaptiveTessellator(const std::vector<glm::vec3>& controlPoints, uint32_t degreeU, uint32_t degreeV, SimdLevel simdLevel = SimdDeCasteljau::BestLevel());
+
+	vrm::MeshData tessellate(float flatnessTolerance, uint32_t maxDepth, Stats& stats) const;
+
+private:
+	// Square of the domain, in units of the finest possible level (2^MaxDepth per side)
+	struct Patch
+	{
+		uint32_t x, y;
+		uint32_t size;
+	};
+
+	void subdivide(const std::vector<glm::vec3>& net, const Patch& patch, uint32_t depth, float tolerance, uint32_t maxDepth, std::vector<Patch>& leaves, uint32_t& deepest) const;
+	float flatness(const std::vector<glm::vec3>& net) const;
+	void splitU(const std::vector<glm::vec3>& net, std::vector<glm::vec3>& low, std::vector<glm::vec3>& high) const;
+	void splitV(const std::vector<glm::vec3>& net, std::vector<glm::vec3>& low, std::vector<glm::vec3>& high) const;
+	// lattice holds the (x, y) point of every vertex, packed as in the vertex keys
+	void evaluateVertices(const std::vector<uint64_t>& lattice, std::vector<vrm::Vertex>& vertices) const;
+	// basis is scratch for the four Bernstein tables of a vertex, sized by basisSize() and reused across calls
+	vrm::Vertex evaluate(uint32_t x, uint32_t y, std::vector<float>& basis) const;
+	size_t basisSize() const { return static_cast<size_t>(m_DegreeU) + 1 + m_DegreeV + 1 + std::max(m_DegreeU, 1u) + std::max(m_DegreeV, 1u); }
+
+	const glm::vec3& at(const std::vector<glm::vec3>& net, uint32_t i, uint32_t j) const { return net[static_cast<size_t>(i) * (m_DegreeV + 1) + j]; }
+
+private:
+	const std::vector<glm::vec3>& m_ControlPoints;
+	uint32_t m_DegreeU, m_DegreeV;
+	SimdLevel m_SimdLevel;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Table of the barycentric Bernstein polynomials B(n, i, j, k) = n! / (i! j! k!) u^i v^j w^k at every sample of a triangular grid.
+ * Sample (a, b) of subdivision level L lies at (u, v, w) = (a, b, L - a - b) / L, so the three coordinates are multiples of 1 / L:
+ * only the powers (s / L)^e, s = 0..L and e = 0..n, are tabulated, and a basis value is a product of three of them.
+ * That keeps the table at (L + 1) (n + 1) floats, where the values of every sample would take (L + 1) (L + 2) / 2 x (n + 1) (n + 2) / 2.
+ * Multinomial coefficients are left to the caller, who folds them into the control net once.
+ */
+class BarycentricBasis
+{
+public:
+	BarycentricBasis() = default;
+	BarycentricBasis(uint32_t degree, uint32_t level);
+
+	uint32_t getDegree() const { return m_Degree; }
+	uint32_t getLevel() const { return m_Level; }
+
+	bool matches(uint32_t degree, uint32_t level) const { return m_Degree == degree && m_Level == level && !m_Powers.empty(); }
+
+	size_t getByteSize() const { return m_Powers.size() * sizeof(float); }
+
+	/**
+	 * @brief Gets (s / level)^0..degree, stored contiguously.
+	 */
+	const float* getPowers(uint32_t s) const { return m_Powers.data() + static_cast<size_t>(s) * (m_Degree + 1); }
+
+	// Points of a triangular net of the given degree, or samples of a triangular grid of level - 1
+	static size_t PointCount(uint32_t degree) { return static_cast<size_t>(degree + 1) * (degree + 2) / 2; }
+
+	/**
+	 * @brief Index of point (i, j, degree - i - j) in a triangular net stored row by row: i = 0..degree, then j = 0..degree - i.
+	 * Samples (a, b) of a grid of level L are stored the same way, at Index(L, a, b).
+	 */
+	static size_t Index(uint32_t degree, uint32_t i, uint32_t j) { return static_cast<size_t>(i) * (degree + 1) - static_cast<size_t>(i) * (i - 1) / 2 + j; }
+
+	// n! / (i! j! k!), computed as a product of two binomials
+	static float Multinomial(uint32_t degree, uint32_t i, uint32_t j);
+
+private:
+	uint32_t m_Degree = 0;
+	uint32_t m_Level = 0;
+	std::vector<float> m_Powers;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "BernsteinBasis.h"
+
+/**
+ * @brief Process-wide cache of the BernsteinBasis tables, values and reduced degree values, keyed by (degree, resolution).
+ * Surfaces of the same degree and resolution share one table: a new surface only tabulates what no other one did before.
+ * Least recently used tables are evicted once the cache holds more than its byte budget. An evicted table stays alive
+ * for as long as a surface holds it, it is only forgotten by the cache.
+ */
+class BasisCache
+{
+public:
+	static constexpr size_t DefaultByteBudget = 64 * 1024 * 1024;
+
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+		size_t entryCount = 0;
+		size_t byteSize = 0;
+	};
+
+public:
+	explicit BasisCache(size_t byteBudget = DefaultByteBudget);
+
+	BasisCache(const BasisCache&) = delete;
+	BasisCache& operator=(const BasisCache&) = delete;
+
+	/**
+	 * @brief Gets the process-wide cache.
+	 */
+	static BasisCache& Get();
+
+	/**
+	 * @brief Gets the table of a degree and resolution, tabulated on a miss. Safe to call from any thread.
+	 * Concurrent misses on the same key may tabulate it twice, the first one inserted is kept.
+	 */
+	std::shared_ptr<const BernsteinBasis> acquire(uint32_t degree, uint32_t resolution);
+
+	// Evicts tables until the cache fits. A table larger than the whole budget is returned but not kept.
+	void setByteBudget(size_t byteBudget);
+	size_t getByteBudget() const;
+
+	Stats getStats() const;
+	void resetCounters();
+	// Forgets every table, counters are kept
+	void clear();
+
+private:
+	using Key = uint64_t;
+
+	struct Entry
+	{
+		Key key;
+		std::shared_ptr<const BernsteinBasis> basis;
+	};
+
+	static Key MakeKey(uint32_t degree, uint32_t resolution) { return (static_cast<Key>(degree) << 32) | resolution; }
+
+	void evict();
+
+private:
+	mutable std::mutex m_Mutex;
+	size_t m_ByteBudget;
+	size_t m_ByteSize = 0;
+	// Most recently used first
+	std::list<Entry> m_Entries;
+	std::unordered_map<Key, std::list<Entry>::iterator> m_Index;
+	uint64_t m_Hits = 0;
+	uint64_t m_Misses = 0;
+	uint64_t m_Evictions = 0;
+};
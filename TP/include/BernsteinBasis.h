@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Table of the Bernstein polynomials B(n, 0..n) sampled at every parameter of a uniform grid.
+ * Sample s lies at t = s / resolution, which is the parametrization used by Bezier::polygonize.
+ * The degree n - 1 polynomials are tabulated as well, so that derivative control nets can be evaluated at the same samples.
+ */
+class BernsteinBasis
+{
+public:
+	BernsteinBasis() = default;
+	BernsteinBasis(uint32_t degree, uint32_t resolution);
+
+	uint32_t getDegree() const { return m_Degree; }
+	uint32_t getResolution() const { return m_Resolution; }
+
+	bool matches(uint32_t degree, uint32_t resolution) const { return m_Degree == degree && m_Resolution == resolution && !m_Values.empty(); }
+
+	// Memory held by both tables
+	size_t getByteSize() const { return (m_Values.size() + m_ReducedValues.size()) * sizeof(float); }
+
+	/**
+	 * @brief Gets the degree + 1 basis values of a sample, stored contiguously.
+	 */
+	const float* getValues(uint32_t sample) const { return m_Values.data() + static_cast<size_t>(sample) * (m_Degree + 1); }
+
+	/**
+	 * @brief Gets the reduced degree basis values B(n - 1, 0..n - 1) of a sample, stored contiguously.
+	 */
+	const float* getReducedValues(uint32_t sample) const { return m_ReducedValues.data() + static_cast<size_t>(sample) * m_Degree; }
+
+	static float SampleParameter(uint32_t sample, uint32_t resolution);
+
+	/**
+	 * @brief Evaluates B(degree, 0..degree) at t into out, which must hold degree + 1 values.
+	 * Uses the de Casteljau recurrence, so no binomial nor power is computed.
+	 */
+	static void Evaluate(uint32_t degree, float t, float* out);
+
+private:
+	uint32_t m_Degree = 0;
+	uint32_t m_Resolution = 0;
+	std::vector<float> m_Values;
+	std::vector<float> m_ReducedValues;
+};
@@ -1,54 +1,299 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stop_token>
 #include <vector>
-#include <unordered_map>
 
 #include <Vroom/Asset/AssetData/MeshData.h>
 
 #include <glm/glm.hpp>
 
-template <>
-struct std::hash<std::pair<uint32_t, uint32_t>>
-{
-	size_t operator()(const std::pair<uint32_t, uint32_t>& element) const noexcept
-	{
-		// From Boost lib (hash_combine)
-		std::hash<uint32_t> hasher;
-		size_t seed = hasher(element.first);
-		return seed ^= hasher(element.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-	}
-};
+#include "AdaptiveTessellator.h"
+#include "BernsteinBasis.h"
+#include "DegreeKernels.h"
+#include "SimdDeCasteljau.h"
 
 class Bezier
 {
+public:
+	enum class EvaluationMode
+	{
+		// One Bernstein double sum per sample
+		Direct = 0,
+		// Precomputed basis tables, control net contracted once per row then once per sample
+		Separable,
+		// Control net contracted once per row like Separable, then the row curve is stepped with forward differences: additions only per sample
+		ForwardDifference
+	};
+
+	enum class MeshLayout
+	{
+		// 6 vertices per quad, one normal per triangle
+		FlatShaded = 0,
+		// One vertex per sample, shared by the neighbouring quads through the index buffer
+		IndexedGrid
+	};
+
+	enum class NormalMode
+	{
+		// Flat shaded: one normal per triangle. Indexed grid: central differences between neighbouring samples
+		FiniteDifference = 0,
+		// Exact dS/du x dS/dv, from the derivative control nets
+		Analytic
+	};
+
+	enum class TessellationMode
+	{
+		// resolutionU x resolutionV samples
+		Uniform = 0,
+		// Control net split until flat enough, see AdaptiveTessellator. Always indexed, with analytic normals
+		Adaptive
+	};
+
+	struct VertexRange
+	{
+		size_t first = 0;
+		size_t count = 0;
+	};
+
+	// Samples covered by a tile of polygonizeTiles. Neighbouring tiles share their border samples.
+	struct Tile
+	{
+		uint32_t index;
+		uint32_t firstSampleU, sampleCountU;
+		uint32_t firstSampleV, sampleCountV;
+	};
+
+	/**
+	 * @brief Receives the tiles of polygonizeTiles, one at a time, on the calling thread.
+	 */
+	class TileSink
+	{
+	public:
+		virtual ~TileSink() = default;
+
+		// The mesh is the consumer's: upload it, write it, or let it go before the next tile is computed
+		virtual void onTile(const Tile& tile, vrm::MeshData&& mesh) = 0;
+	};
+
+	static constexpr uint32_t DefaultTileSize = 256;
+	static constexpr uint32_t DefaultAnchorInterval = 256;
+	// A level of detail gives way to the next coarser one once its quads would be smaller than 1 / LodQuadsPerViewport of the viewport height
+	static constexpr float LodQuadsPerViewport = 256.f;
+
+	// Differences between an evaluation mode and Direct evaluation, over the whole grid
+	struct EvaluationError
+	{
+		float maxPositionError = 0.f;
+		float rmsPositionError = 0.f;
+		// Largest angle between analytic normals, in degrees
+		float maxNormalAngle = 0.f;
+	};
+
 public:
 	Bezier(uint32_t degreeU, uint32_t degreeV, uint32_t resolutionU, uint32_t resolutionV);
 
 	void setControlPoint(uint32_t u, uint32_t v, const glm::vec3& p);
 	void setDegrees(uint32_t degreeU, uint32_t degreeV);
 	void setResolution(uint32_t resolutionU, uint32_t resolutionV);
+	void setEvaluationMode(EvaluationMode mode);
+	// Forward difference evaluation: samples stepped between two exact evaluations, bounding the drift of the differences
+	void setAnchorInterval(uint32_t interval);
+	void setMeshLayout(MeshLayout layout);
+	void setNormalMode(NormalMode mode);
+	// Degree specialized evaluation kernels (see DegreeKernels), on by default. Disabling them is only meant for comparisons.
+	void setSpecializedKernels(bool enabled);
+	// Instruction set of direct evaluation and adaptive tessellation vertices, the best one of the CPU by default.
+	// Scalar keeps the tabulated kernels of direct evaluation, unsupported levels fall back to the best supported one.
+	void setSimdLevel(SimdLevel level);
+	// 0 uses every hardware thread
+	void setThreadCount(uint32_t threadCount);
+	void setTessellationMode(TessellationMode mode);
+	// Adaptive tessellation: maximum distance between a sub-net and the bilinear patch of its corners
+	void setFlatnessTolerance(float tolerance);
+	void setMaxSubdivisionDepth(uint32_t depth);
+	// When enabled and the mesh is up to date, setControlPoint patches the cached mesh in place instead of invalidating it
+	void setIncrementalUpdates(bool enabled);
+	/**
+	 * @brief Coarser levels of detail added to the indexed grid of uniform tessellation, 0 by default. Level k draws every 2^k-th row and column
+	 * of the same vertices, the last ones always included so that the borders stay. Levels stop once a grid has no more samples to drop.
+	 */
+	void setLodLevelCount(uint32_t count);
+	// Indexed grid: two triangles per quad (default), or one triangle strip per quad row with restarts in between, about 3x fewer indices
+	void setPrimitiveType(vrm::MeshData::PrimitiveType primitiveType);
 
 	const glm::vec3& getControlPoint(uint32_t u, uint32_t v) const;
+	uint32_t getDegreeU() const { return m_DegreeU; }
+	uint32_t getDegreeV() const { return m_DegreeV; }
+	uint32_t getResolutionU() const { return m_ResolutionU; }
+	uint32_t getResolutionV() const { return m_ResolutionV; }
+	EvaluationMode getEvaluationMode() const { return m_EvaluationMode; }
+	uint32_t getAnchorInterval() const { return m_AnchorInterval; }
+	MeshLayout getMeshLayout() const { return m_MeshLayout; }
+	NormalMode getNormalMode() const { return m_NormalMode; }
+	TessellationMode getTessellationMode() const { return m_TessellationMode; }
+	float getFlatnessTolerance() const { return m_FlatnessTolerance; }
+	uint32_t getMaxSubdivisionDepth() const { return m_MaxSubdivisionDepth; }
+	bool getSpecializedKernels() const { return m_SpecializedKernels; }
+	SimdLevel getSimdLevel() const { return m_SimdLevel; }
+	uint32_t getThreadCount() const;
+	bool getIncrementalUpdates() const { return m_IncrementalUpdates; }
+	uint32_t getLodLevelCount() const { return m_LodLevelCount; }
+	vrm::MeshData::PrimitiveType getPrimitiveType() const { return m_PrimitiveType; }
 
 	const vrm::MeshData& polygonize() const;
+	// Same, but gives up soon after a stop is requested. The mesh is then incomplete and isMeshUpToDate stays false.
+	const vrm::MeshData& polygonize(std::stop_token stopToken) const;
+
+	/**
+	 * @brief Polygonizes if needed and hands the cached mesh over instead of copying it.
+	 * The cache is left empty: the next polygonize computes the mesh again, and incremental updates have nothing to patch until then.
+	 */
+	vrm::MeshData releaseMesh();
+	// Drops the cached mesh and tangents without computing them, for surfaces about to be copied or polygonized with other settings
+	void discardMesh();
+
+	/**
+	 * @brief Polygonizes the surface in tiles of at most tileSize x tileSize samples, in the current mesh layout and normal mode.
+	 * Only one tile is in memory at a time and the cached mesh is left untouched, so large resolutions stay within a bounded footprint.
+	 * Together, the tiles make the same surface as polygonize. Adaptive tessellation has no grid, and gives a single tile.
+	 */
+	void polygonizeTiles(TileSink& sink, uint32_t tileSize = DefaultTileSize) const;
+
+	/**
+	 * @brief Compares the current evaluation mode and SIMD level with scalar Direct evaluation, positions and analytic normals, for every sample.
+	 * Rows are evaluated a tile at a time, the cached mesh is left untouched. Meant for reports, not for frames.
+	 * No error is reported for adaptive tessellation, nor for degrees beyond those of Direct evaluation.
+	 */
+	EvaluationError measureEvaluationError() const;
+
+	// True when polygonize will return the cached mesh without computing it again
+	bool isMeshUpToDate() const { return !m_NeedsCompute; }
+	// Statistics of the last adaptive tessellation
+	const AdaptiveTessellator::Stats& getAdaptiveStats() const { return m_AdaptiveStats; }
+	// Vertices of the cached mesh changed by incremental updates since the last clearDirtyVertexRange
+	const VertexRange& getDirtyVertexRange() const { return m_DirtyVertexRange; }
+	void clearDirtyVertexRange() { m_DirtyVertexRange = {}; }
+
+private:
+	// Rows evaluated between two cancellation checks
+	static constexpr uint32_t CancellationRowCount = 16;
+
+	struct TangentFrame
+	{
+		glm::vec3 u;
+		glm::vec3 v;
+	};
+
+	// Samples [firstSampleU, firstSampleU + sampleCountU) x [firstSampleV, firstSampleV + sampleCountV) of the grid, row major
+	struct SampleWindow
+	{
+		uint32_t firstSampleU, sampleCountU;
+		uint32_t firstSampleV, sampleCountV;
+
+		uint32_t endSampleU() const { return firstSampleU + sampleCountU; }
+		uint32_t endSampleV() const { return firstSampleV + sampleCountV; }
+		size_t size() const { return static_cast<size_t>(sampleCountU) * sampleCountV; }
+		size_t index(uint32_t sampleU, uint32_t sampleV) const { return static_cast<size_t>(sampleU - firstSampleU) * sampleCountV + (sampleV - firstSampleV); }
+		// One more sample on every side, within a resolutionU x resolutionV grid
+		SampleWindow grown(uint32_t resolutionU, uint32_t resolutionV) const;
+
+		bool operator==(const SampleWindow&) const = default;
+	};
+
+	// Where evaluated samples are written: one position every stride bytes, for the samples of window.
+	// Analytic normals are evaluated as well when normals is not null, and their partial derivatives are kept in tangents when it is not null.
+	struct SampleTarget
+	{
+		glm::vec3* positions;
+		glm::vec3* normals;
+		size_t stride;
+		SampleWindow window;
+		TangentFrame* tangents = nullptr;
+
+		glm::vec3& position(size_t index) const { return At(positions, index); }
+		glm::vec3& normal(size_t index) const { return At(normals, index); }
+
+	private:
+		glm::vec3& At(glm::vec3* base, size_t index) const { return *reinterpret_cast<glm::vec3*>(reinterpret_cast<std::byte*>(base) + index * stride); }
+	};
 
 private:
 	void computeMesh() const;
+	void computeFlatShadedMesh() const;
+	void computeIndexedGridMesh() const;
+	void addLodLevels(vrm::MeshData& mesh) const;
+	SampleWindow fullWindow() const { return { 0, m_ResolutionU, 0, m_ResolutionV }; }
+	// Meshes of the samples of a window, tangents sized like the window or null
+	vrm::MeshData flatShadedMesh(const SampleWindow& window, TangentFrame* tangents) const;
+	vrm::MeshData indexedGridMesh(const SampleWindow& window, TangentFrame* tangents) const;
+	// vertices holds the samples of window, which must include the neighbours of (sampleU, sampleV)
+	glm::vec3 gridNormal(const vrm::Vertex* vertices, const SampleWindow& window, uint32_t sampleU, uint32_t sampleV) const;
+	bool patchMesh(uint32_t u, uint32_t v, const glm::vec3& delta);
+	void addDirtyVertices(size_t first, size_t count);
+	void forEachRowBlock(uint32_t rowCount, const std::function<void(uint32_t, uint32_t)>& task) const;
+	void updateBasis() const;
+	// Forward differences only tabulate the U direction
+	void updateBasisU() const;
+	void updateDerivativeNets() const;
+	void evaluateGrid(const SampleTarget& target, EvaluationMode mode, SimdLevel simdLevel) const;
+	void evaluateRowsDirect(const SampleTarget& target, uint32_t rowBegin, uint32_t rowEnd) const;
+	// Direct evaluation by batched de Casteljau, a row at a time
+	void evaluateRowsBatched(const SampleTarget& target, SimdLevel simdLevel, uint32_t rowBegin, uint32_t rowEnd) const;
+	// Separable and ForwardDifference modes, which only differ along the rows
+	void evaluateRowsSeparable(const SampleTarget& target, EvaluationMode mode, uint32_t rowBegin, uint32_t rowEnd) const;
 	glm::vec3 computeBezier(float u, float v) const;
 
 protected:
-	inline static uint32_t Binomial(uint32_t n, uint32_t k);
-	inline static uint32_t Factorial(uint32_t n);
+	inline static uint64_t Binomial(uint32_t n, uint32_t k);
 	inline static float Bernstein(uint32_t n, uint32_t k, float t);
+	static glm::vec3 EvaluateNet(const std::vector<glm::vec3>& net, uint32_t degreeU, uint32_t degreeV, float u, float v);
+	// Sum of basisU[i] * basisV[j] * net[i][j], degrees at most PascalTriangle::MaxDegree, with the specialized kernels when allowed
+	static glm::vec3 ContractNet(const glm::vec3* net, uint32_t degreeU, uint32_t degreeV, const float* basisU, const float* basisV, bool specialized);
+	// Samples [firstSample, firstSample + sampleCount) of a degree at most PascalTriangle::MaxDegree curve, stepped with forward differences.
+	// The differences are kept in double, stepped by the kernel, and computed again from the curve every anchorInterval samples.
+	static void ForwardDifferenceSamples(const DegreeKernel& kernel, uint32_t degree, const glm::vec3* points, uint32_t firstSample, uint32_t sampleCount, uint32_t resolution, uint32_t anchorInterval, glm::vec3* out, size_t outStride);
+	static glm::vec3 SurfaceNormal(const glm::vec3& tangentU, const glm::vec3& tangentV);
+	// Indices written by WriteQuadRow for columnCount kept columns, the restart of a strip included
+	static size_t QuadRowIndexCount(size_t columnCount, vrm::MeshData::PrimitiveType primitiveType);
+	/**
+	 * @brief Writes the quads between two sample rows, whose first samples are rowA and rowB, over the kept columns (offsets in the rows).
+	 * Quads are split (a, b, c), (a, c, d) as triangles, and (a, b, d), (d, b, c) as a strip, which ends on a restart unless it is the last one.
+	 */
+	static uint32_t* WriteQuadRow(uint32_t rowA, uint32_t rowB, const std::vector<uint32_t>& columns, vrm::MeshData::PrimitiveType primitiveType, bool lastRow, uint32_t* out);
 
 private:
 	uint32_t m_DegreeU, m_DegreeV;
 	uint32_t m_ResolutionU, m_ResolutionV;
 	std::vector<glm::vec3> m_ControlPoints;
+	EvaluationMode m_EvaluationMode = EvaluationMode::Separable;
+	MeshLayout m_MeshLayout = MeshLayout::FlatShaded;
+	NormalMode m_NormalMode = NormalMode::FiniteDifference;
+	TessellationMode m_TessellationMode = TessellationMode::Uniform;
+	float m_FlatnessTolerance = 0.01f;
+	uint32_t m_MaxSubdivisionDepth = 8;
+	bool m_SpecializedKernels = true;
+	uint32_t m_AnchorInterval = DefaultAnchorInterval;
+	SimdLevel m_SimdLevel = SimdDeCasteljau::BestLevel();
+	uint32_t m_ThreadCount = 0;
+	bool m_IncrementalUpdates = false;
+	uint32_t m_LodLevelCount = 0;
+	vrm::MeshData::PrimitiveType m_PrimitiveType = vrm::MeshData::PrimitiveType::Triangles;
 
+	// Shared with every surface of the same degree and resolution through BasisCache
+	mutable std::shared_ptr<const BernsteinBasis> m_BasisU, m_BasisV;
+	// Degree (n - 1) nets of dS/du and dS/dv, sized degreeU x (degreeV + 1) and (degreeU + 1) x degreeV
+	mutable std::vector<glm::vec3> m_DerivativeNetU, m_DerivativeNetV;
+	// Control points as read by batched evaluation
+	mutable SoaPoints m_SoaControlPoints;
 	mutable vrm::MeshData m_PolygonizedCache;
+	// Per sample dS/du and dS/dv, only kept for incremental updates of analytic normals
+	mutable std::vector<TangentFrame> m_TangentCache;
 	mutable bool m_NeedsCompute = true;
-
-	static std::unordered_map<std::pair<uint32_t, uint32_t>, uint32_t> s_Binomials;
-	static std::vector<uint32_t> s_Factorials;
+	mutable VertexRange m_DirtyVertexRange;
+	// Only set during polygonize(stopToken)
+	mutable std::stop_token m_StopToken;
+	mutable AdaptiveTessellator::Stats m_AdaptiveStats;
 };
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+#include "Bezier.h"
+
+/**
+ * @brief Polygonizes Bezier surfaces on a background thread, one job at a time.
+ * A new job supersedes the previous one: a pending job is dropped and a running one is cancelled.
+ * Finished surfaces wait in a result slot until the owner takes them, typically at frame start.
+ * A job may be refined progressively: every doubling of its resolution is a result of its own, a finer one replacing a coarser one not taken yet.
+ */
+class BezierJobQueue
+{
+public:
+	struct Result
+	{
+		// Polygonized: its mesh is up to date
+		Bezier bezier;
+		uint64_t jobId;
+		std::chrono::steady_clock::time_point submitTime;
+		float computeTimeSeconds;
+		// Doublings of the resolution still to come for this job, 0 for the full resolution
+		uint32_t refinementStepsLeft = 0;
+	};
+
+public:
+	BezierJobQueue();
+	~BezierJobQueue();
+
+	BezierJobQueue(const BezierJobQueue&) = delete;
+	BezierJobQueue& operator=(const BezierJobQueue&) = delete;
+
+	/**
+	 * @brief Queues the polygonization of a surface, superseding older jobs.
+	 * With refinement steps, the surface is polygonized at RefinedResolution(resolution, refinementSteps) first,
+	 * then at every doubling of it up to its own resolution.
+	 * @return The id of the job, increasing with every submission.
+	 */
+	uint64_t submit(Bezier bezier, uint32_t refinementSteps = 0);
+
+	/**
+	 * @brief Drops pending work and results, and cancels the running job.
+	 */
+	void cancel();
+
+	/**
+	 * @brief Takes the surface of the last finished job, if one finished since the last call.
+	 */
+	std::optional<Result> takeResult();
+
+	/**
+	 * @brief Gets the id of the last submitted job, 0 if none was.
+	 */
+	uint64_t getLastJobId() const;
+
+	/**
+	 * @brief Gets the resolution of a surface refinementStepsLeft doublings before its own, at least 2.
+	 */
+	static uint32_t RefinedResolution(uint32_t resolution, uint32_t refinementStepsLeft);
+
+private:
+	struct Job
+	{
+		Bezier bezier;
+		uint64_t id;
+		std::chrono::steady_clock::time_point submitTime;
+		uint32_t refinementSteps;
+	};
+
+	void workerLoop(std::stop_token stopToken);
+
+private:
+	mutable std::mutex m_Mutex;
+	std::condition_variable_any m_JobAvailable;
+
+	std::optional<Job> m_PendingJob;
+	std::optional<Result> m_Result;
+	// Stops the job taken last by the worker
+	std::stop_source m_JobStopSource;
+	uint64_t m_LastJobId = 0;
+
+	// Last member: the worker starts once everything else is built, and is joined first
+	std::jthread m_Worker;
+};
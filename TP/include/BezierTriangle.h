@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Vroom/Asset/AssetData/MeshData.h>
+
+#include <glm/glm.hpp>
+
+#include "BarycentricBasis.h"
+#include "Bezier.h"
+
+/**
+ * @brief Triangular Bezier patch of degree n: control points P(i, j, k), i + j + k = n, over barycentric coordinates (u, v, w = 1 - u - v).
+ * Corners are P(n, 0, 0) at u = 1, P(0, n, 0) at v = 1 and P(0, 0, n) at w = 1, the net being stored row by row as in BarycentricBasis::Index.
+ *
+ * Subdivision level L samples (u, v) = (a, b) / L for a + b <= L: (L + 1) (L + 2) / 2 vertices shared by L^2 triangles, in one indexed mesh.
+ * Sample rows of constant u are computed in parallel from the power tables of BarycentricBasis, kept while degree and level stay.
+ * Multinomial coefficients and derivative differences are folded into the nets once per control point change, so a sample only costs
+ * a weighted sum over the net, with analytic normals.
+ */
+class BezierTriangle
+{
+public:
+	BezierTriangle(uint32_t degree, uint32_t level);
+
+	// Point (i, j, degree - i - j)
+	void setControlPoint(uint32_t i, uint32_t j, const glm::vec3& p);
+	void setLevel(uint32_t level);
+	// 0 uses every hardware thread
+	void setThreadCount(uint32_t threadCount);
+
+	const glm::vec3& getControlPoint(uint32_t i, uint32_t j) const;
+	uint32_t getDegree() const { return m_Degree; }
+	uint32_t getLevel() const { return m_Level; }
+	// Level 0 has no sample
+	size_t getSampleCount() const { return m_Level > 0 ? BarycentricBasis::PointCount(m_Level) : 0; }
+	uint32_t getThreadCount() const;
+
+	// Exact point at (u, v, 1 - u - v), by the triangular de Casteljau algorithm
+	glm::vec3 evaluate(float u, float v) const;
+
+	// Indexed mesh with analytic normals, cached until the patch changes
+	const vrm::MeshData& polygonize() const;
+
+	/**
+	 * @brief Compares the polygonized mesh with the de Casteljau algorithm, at every sample. Meant for reports, not for frames.
+	 * Normals are compared with those of the last de Casteljau step, whose points span the tangent plane.
+	 */
+	Bezier::EvaluationError measureEvaluationError() const;
+
+	bool isMeshUpToDate() const { return !m_NeedsCompute; }
+
+private:
+	void updateBasis() const;
+	void updateNets() const;
+	void evaluateRow(vrm::Vertex* vertices, uint32_t row) const;
+	// Last de Casteljau step: the three points of degree 1 at (u, v)
+	void deCasteljau(float u, float v, glm::vec3 out[3]) const;
+
+private:
+	uint32_t m_Degree;
+	uint32_t m_Level;
+	std::vector<glm::vec3> m_ControlPoints;
+	uint32_t m_ThreadCount = 0;
+
+	mutable BarycentricBasis m_Basis;
+	// Control points times their multinomial coefficient, and the same for the degree n - 1 nets of the derivatives along u and v
+	mutable std::vector<glm::vec3> m_PositionNet, m_TangentNetU, m_TangentNetV;
+	mutable bool m_NetsUpToDate = false;
+	mutable vrm::MeshData m_PolygonizedCache;
+	mutable bool m_NeedsCompute = true;
+};
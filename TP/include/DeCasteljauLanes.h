@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "SimdDeCasteljau.h"
+
+/**
+ * @brief Entry points of one instruction set, see SimdDeCasteljau. Points are given as { x, y, z } arrays.
+ */
+struct DeCasteljauKernel
+{
+	void (*evaluateSurface)(uint32_t degreeU, uint32_t degreeV, const float* const* net, const float* u, const float* v, uint32_t count,
+		glm::vec3* positions, size_t positionStride, glm::vec3* tangentsU, glm::vec3* tangentsV, size_t tangentStride);
+};
+
+/**
+ * @brief The de Casteljau recurrence on a batch of Lanes::Width parameters.
+ * Lanes wraps one register type: Type, Width, Broadcast, Load, Store, Sub, Mul and MulAdd (a * b + c).
+ * Instantiated once per instruction set, each in a translation unit built for it. Only plain loops and Lanes calls are used here,
+ * so that no inline function shared with other translation units gets compiled for an instruction set the CPU may lack.
+ */
+template <typename Lanes>
+class DeCasteljauLanes
+{
+	using Type = typename Lanes::Type;
+	static constexpr uint32_t Width = Lanes::Width;
+
+public:
+	static void EvaluateSurface(uint32_t degreeU, uint32_t degreeV, const float* const* net, const float* u, const float* v, uint32_t count,
+		glm::vec3* positions, size_t positionStride, glm::vec3* tangentsU, glm::vec3* tangentsV, size_t tangentStride)
+	{
+		const bool tangents = tangentsU && tangentsV;
+		const uint32_t rowSize = degreeV + 1;
+
+		Type work[3][SimdDeCasteljau::MaxDegree + 1];
+		// Every column of the net reduced along U: points of a degree V curve, and of its dS/du counterpart
+		Type columns[3][SimdDeCasteljau::MaxDegree + 1];
+		Type columnDerivatives[3][SimdDeCasteljau::MaxDegree + 1];
+		Type derivatives[3];
+		alignas(64) float position[3][Width], tangentU[3][Width], tangentV[3][Width];
+		alignas(64) float batchU[Width], batchV[Width];
+
+		for (uint32_t first = 0; first < count; first += Width)
+		{
+			const uint32_t laneCount = count - first < Width ? count - first : Width;
+
+			// The last batch repeats its first parameter in the unused lanes
+			for (uint32_t lane = 0; lane < Width; lane++)
+			{
+				batchU[lane] = u[first + (lane < laneCount ? lane : 0)];
+				batchV[lane] = v[first + (lane < laneCount ? lane : 0)];
+			}
+
+			const Type batchedU = Lanes::Load(batchU);
+			const Type batchedV = Lanes::Load(batchV);
+
+			for (uint32_t j = 0; j <= degreeV; j++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+					for (uint32_t i = 0; i <= degreeU; i++)
+						work[c][i] = Lanes::Broadcast(net[c][i * rowSize + j]);
+
+				ReduceWithDerivatives(work, degreeU, batchedU, derivatives);
+
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					columns[c][j] = work[c][0];
+					columnDerivatives[c][j] = derivatives[c];
+				}
+			}
+
+			ReduceWithDerivatives(columns, degreeV, batchedV, derivatives);
+
+			for (uint32_t c = 0; c < 3; c++)
+				Lanes::Store(position[c], columns[c][0]);
+
+			if (tangents)
+			{
+				Reduce(columnDerivatives, degreeV, batchedV);
+
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					Lanes::Store(tangentU[c], columnDerivatives[c][0]);
+					Lanes::Store(tangentV[c], derivatives[c]);
+				}
+			}
+
+			for (uint32_t lane = 0; lane < laneCount; lane++)
+			{
+				Write(positions, first + lane, positionStride, position, lane);
+
+				if (tangents)
+				{
+					Write(tangentsU, first + lane, tangentStride, tangentU, lane);
+					Write(tangentsV, first + lane, tangentStride, tangentV, lane);
+				}
+			}
+		}
+	}
+
+private:
+	static Type Lerp(Type a, Type b, Type t)
+	{
+		return Lanes::MulAdd(t, Lanes::Sub(b, a), a);
+	}
+
+	// Runs the recurrence on points[c][0..degree] until stopLevel + 1 points are left, in place.
+	// The components are interleaved so that their dependency chains overlap.
+	static void ReduceTo(Type (*points)[SimdDeCasteljau::MaxDegree + 1], uint32_t degree, uint32_t stopLevel, Type t)
+	{
+		for (uint32_t level = degree; level > stopLevel; level--)
+		{
+			for (uint32_t i = 0; i < level; i++)
+			{
+				points[0][i] = Lerp(points[0][i], points[0][i + 1], t);
+				points[1][i] = Lerp(points[1][i], points[1][i + 1], t);
+				points[2][i] = Lerp(points[2][i], points[2][i + 1], t);
+			}
+		}
+	}
+
+	// The curve value ends in points[c][0]
+	static void Reduce(Type (*points)[SimdDeCasteljau::MaxDegree + 1], uint32_t degree, Type t)
+	{
+		ReduceTo(points, degree, 0, t);
+	}
+
+	// Same, and the derivatives from the last two points of the recurrence
+	static void ReduceWithDerivatives(Type (*points)[SimdDeCasteljau::MaxDegree + 1], uint32_t degree, Type t, Type* derivatives)
+	{
+		if (degree == 0)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+				derivatives[c] = Lanes::Broadcast(0.f);
+
+			return;
+		}
+
+		ReduceTo(points, degree, 1, t);
+
+		const Type scale = Lanes::Broadcast(static_cast<float>(degree));
+
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			derivatives[c] = Lanes::Mul(scale, Lanes::Sub(points[c][1], points[c][0]));
+			points[c][0] = Lerp(points[c][0], points[c][1], t);
+		}
+	}
+
+	static void Write(glm::vec3* out, uint32_t index, size_t outStride, const float (*values)[Width], uint32_t lane)
+	{
+		float* point = reinterpret_cast<float*>(reinterpret_cast<std::byte*>(out) + index * outStride);
+		point[0] = values[0][lane];
+		point[1] = values[1][lane];
+		point[2] = values[2][lane];
+	}
+};
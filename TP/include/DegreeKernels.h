@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "PascalTriangle.h"
+
+/**
+ * @brief Evaluation kernels for one degree: Bernstein basis values and contractions of control points with them.
+ * The degree is passed at runtime for the generic kernel, the specialized ones ignore it.
+ */
+struct DegreeKernel
+{
+	// B(degree, 0..degree) at t into out
+	void (*basis)(uint32_t degree, float t, float* out);
+	// Sum of weights[k] * points[k * stride] for k in [0, degree]
+	glm::vec3 (*contract)(uint32_t degree, const float* weights, const glm::vec3* points, size_t stride);
+	// contract(weights + s * (degree + 1), points, 1) for every sample s, written every outStride bytes
+	void (*contractSamples)(uint32_t degree, const float* weights, const glm::vec3* points, uint32_t sampleCount, glm::vec3* out, size_t outStride);
+	// Writes sampleCount samples of a polynomial curve from its forward differences: x, y, z of order k at differences[3 * k].
+	// The differences are stepped in place, and hold those of the next sample on return.
+	void (*stepDifferences)(uint32_t degree, double* differences, uint32_t sampleCount, glm::vec3* out, size_t outStride);
+
+	bool specialized;
+};
+
+/**
+ * @brief Kernels with the degree known at compile time: binomials are constants and every loop over the degree is unrolled.
+ */
+template <uint32_t Degree>
+struct SpecializedKernel
+{
+	static constexpr std::array<float, Degree + 1> Binomials = []()
+	{
+		std::array<float, Degree + 1> binomials{};
+
+		for (uint32_t k = 0; k <= Degree; k++)
+			binomials[k] = static_cast<float>(PascalTriangle::Binomial(Degree, k));
+
+		return binomials;
+	}();
+
+	static void Basis(uint32_t, float t, float* out)
+	{
+		BasisTerms(t, out, std::make_index_sequence<Degree>{}, std::make_index_sequence<Degree + 1>{});
+	}
+
+	static glm::vec3 Contract(uint32_t, const float* weights, const glm::vec3* points, size_t stride)
+	{
+		return ContractTerms(weights, points, stride, std::make_index_sequence<Degree + 1>{});
+	}
+
+	static void ContractSamples(uint32_t degree, const float* weights, const glm::vec3* points, uint32_t sampleCount, glm::vec3* out, size_t outStride)
+	{
+		// Loaded once, the points stay in registers for every sample
+		std::array<glm::vec3, Degree + 1> curve;
+		std::copy(points, points + Degree + 1, curve.begin());
+
+		for (uint32_t sample = 0; sample < sampleCount; sample++)
+		{
+			*out = Contract(degree, weights + static_cast<size_t>(sample) * (Degree + 1), curve.data(), 1);
+			out = reinterpret_cast<glm::vec3*>(reinterpret_cast<std::byte*>(out) + outStride);
+		}
+	}
+
+	static void StepDifferences(uint32_t, double* differences, uint32_t sampleCount, glm::vec3* out, size_t outStride)
+	{
+		// Kept in registers as much as possible across samples
+		std::array<double, 3 * (Degree + 1)> local;
+		std::copy(differences, differences + local.size(), local.begin());
+
+		for (uint32_t sample = 0; sample < sampleCount; sample++)
+		{
+			*out = glm::vec3{ static_cast<float>(local[0]), static_cast<float>(local[1]), static_cast<float>(local[2]) };
+			out = reinterpret_cast<glm::vec3*>(reinterpret_cast<std::byte*>(out) + outStride);
+
+			StepTerms(local.data(), std::make_index_sequence<3 * Degree>{});
+		}
+
+		std::copy(local.begin(), local.end(), differences);
+	}
+
+private:
+	template <size_t... K, size_t... L>
+	static void BasisTerms(float t, float* out, std::index_sequence<K...>, std::index_sequence<L...>)
+	{
+		[[maybe_unused]] const float s = 1.f - t;
+		std::array<float, Degree + 1> powersT, powersS;
+		powersT[0] = 1.f;
+		powersS[0] = 1.f;
+
+		((powersT[K + 1] = powersT[K] * t, powersS[K + 1] = powersS[K] * s), ...);
+		((out[L] = Binomials[L] * powersT[L] * powersS[Degree - L]), ...);
+	}
+
+	template <size_t... K>
+	static glm::vec3 ContractTerms(const float* weights, const glm::vec3* points, size_t stride, std::index_sequence<K...>)
+	{
+		glm::vec3 out = glm::vec3{ 0.f, 0.f, 0.f };
+		((out += weights[K] * points[K * stride]), ...);
+		return out;
+	}
+
+	// Every difference takes the next order one, lowest order first so that each reads the value of the previous sample
+	template <size_t... K>
+	static void StepTerms(double* differences, std::index_sequence<K...>)
+	{
+		((differences[K] += differences[K + 3]), ...);
+	}
+};
+
+class DegreeKernels
+{
+public:
+	// Highest degree offered by the MyScene degree sliders
+	static constexpr uint32_t MaxSpecializedDegree = 20;
+
+	/**
+	 * @brief Gets the kernel of a degree: the specialized one when allowed and available, the generic one otherwise.
+	 */
+	static const DegreeKernel& Get(uint32_t degree, bool allowSpecialized = true);
+
+	static bool IsSpecialized(uint32_t degree) { return degree <= MaxSpecializedDegree; }
+
+private:
+	static void GenericBasis(uint32_t degree, float t, float* out);
+	static glm::vec3 GenericContract(uint32_t degree, const float* weights, const glm::vec3* points, size_t stride);
+	static void GenericContractSamples(uint32_t degree, const float* weights, const glm::vec3* points, uint32_t sampleCount, glm::vec3* out, size_t outStride);
+	static void GenericStepDifferences(uint32_t degree, double* differences, uint32_t sampleCount, glm::vec3* out, size_t outStride);
+};
@@ -6,10 +6,13 @@
 
 #include <glm/gtc/constants.hpp>
 
+#include <memory>
 #include <vector>
 
 #include "imgui.h"
 #include "Bezier.h"
+#include "BezierJobQueue.h"
+#include "PatchSurface.h"
 
 class MyScene : public vrm::Scene
 {
@@ -27,10 +30,34 @@ protected:
 	void onRender() override;
 
 private:
+	// Polygonizes a new surface from m_BezierParams, in the background when asynchronous computing is on
 	void computeBezier();
+	Bezier makeBezier() const;
+	/**
+	 * @brief Shows the surface at the finest doubling step that fits in the frame budget right away,
+	 * then refines it in the background, every finer step replacing the shown mesh.
+	 */
+	void computeBezierProgressively(Bezier bezier);
+	// Halvings of the resolution of a surface for its polygonization to fit in the frame budget, at the last measured throughput
+	uint32_t previewRefinementSteps(const Bezier& bezier) const;
+	void recordThroughput(const Bezier& bezier, float seconds);
+	void showBezier(Bezier bezier);
+	// Replaces the submeshes with the mesh of m_Bezier, whole or streamed in tiles
+	void uploadMesh();
+	// Shows the surface of the last finished background job, if any
+	void showFinishedJob();
+	void moveControlPoint(uint32_t u, uint32_t v, const glm::vec3& p);
+	// Moves the point of the shown surface, patching its mesh in place when it can
+	void updateBezierControlPoint(uint32_t u, uint32_t v, const glm::vec3& p);
 	void updateControlPoints();
 
-	void profile();
+	// Builds m_PatchSurface from m_PatchParams and shows it next to the single patch
+	void computePatchSurface();
+	void movePatchControlPoint(uint32_t u, uint32_t v, const glm::vec3& p);
+	void onPatchSurfaceImGui();
+
+	void benchmarkKernels();
+	void measureEvaluationError();
 
 	void onImGui();
 
@@ -70,6 +97,28 @@ private:
 				float patchSizeV;
 			};
 		};
+
+		int evaluationMode = static_cast<int>(Bezier::EvaluationMode::Separable);
+		int anchorInterval = static_cast<int>(Bezier::DefaultAnchorInterval);
+		int simdLevel = static_cast<int>(SimdDeCasteljau::BestLevel());
+		int meshLayout = static_cast<int>(Bezier::MeshLayout::FlatShaded);
+		int normalMode = static_cast<int>(Bezier::NormalMode::FiniteDifference);
+		int threadCount = 0;
+		int tessellationMode = static_cast<int>(Bezier::TessellationMode::Uniform);
+		float flatnessTolerance = 0.01f;
+		int maxSubdivisionDepth = 8;
+		int lodLevelCount = 0;
+		int primitiveType = static_cast<int>(vrm::MeshData::PrimitiveType::Triangles);
+	};
+
+	struct PatchParams
+	{
+		int patchCounts[2] = { 4, 4 };
+		int degrees[2] = { 3, 3 };
+		int segments[2] = { 16, 16 };
+		int continuity = static_cast<int>(PatchSurface::Continuity::C1);
+		float patchSize = 5.f;
+		float verticalSpread = 2.f;
 	};
 
 private:
@@ -84,11 +133,41 @@ private:
 	bool m_ControlsEnabled = true;
 	bool m_RealTimeComputing = true;
 	bool m_ShowControlPoints = true;
+	bool m_IncrementalUpdates = true;
+	bool m_AsyncComputing = true;
+	// One submesh per tile, without ever polygonizing the whole surface at once
+	bool m_StreamTiles = false;
+	int m_TileSize = static_cast<int>(Bezier::DefaultTileSize);
+	bool m_ProgressiveRefinement = false;
+	// Reorders the uploaded surfaces for the vertex cache, overdraw and vertex fetches
+	bool m_OptimizeMeshes = false;
+	float m_FrameBudgetMs = 8.f;
+	int m_EditedControlPoint[2] = { 0, 0 };
 
 	vrm::MeshAsset m_MeshAsset;
 	Bezier m_Bezier;
 	BezierParams m_BezierParams;
 	float m_LastComputeTimeSeconds = 0.f;
+	Bezier::EvaluationError m_LastEvaluationError;
+
+	BezierJobQueue m_BezierJobs;
+	// Job of the shown surface, stale while older than the last submitted job
+	uint64_t m_DisplayedJobId = 0;
+	// From submission to display
+	float m_LastJobLatencySeconds = 0.f;
+	// Doublings of the resolution before the shown surface reaches refinementTarget
+	uint32_t m_RefinementStepsLeft = 0;
+	uint32_t m_RefinementTarget[2] = { 0, 0 };
+	// Of the last polygonization, to size previews
+	float m_SamplesPerSecond = 1e7f;
 
 	std::vector<vrm::Entity> m_ControlPoints;
+
+	bool m_ShowPatchSurface = false;
+	PatchParams m_PatchParams;
+	std::unique_ptr<PatchSurface> m_PatchSurface;
+	vrm::MeshAsset m_PatchMeshAsset;
+	vrm::Entity m_PatchEntity;
+	int m_EditedPatchControlPoint[2] = { 0, 0 };
+	float m_LastPatchComputeTimeSeconds = 0.f;
 };
\ No newline at end of file
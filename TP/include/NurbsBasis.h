@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Table of the non-zero B-spline basis functions N(span - degree .. span) and of their derivatives, at every sample of a uniform grid.
+ * Sample s lies at t = knots[degree] + (s / resolution) * (knots[controlPointCount] - knots[degree]), the parametrization of Bezier mapped to the knot domain.
+ * Samples are visited in increasing order, so the knot span is found by walking forward: O(1) amortized per sample instead of a search.
+ */
+class NurbsBasis
+{
+public:
+	static constexpr uint32_t MaxDegree = 64;
+
+public:
+	NurbsBasis() = default;
+	NurbsBasis(uint32_t degree, const std::vector<float>& knots, uint32_t resolution);
+
+	uint32_t getDegree() const { return m_Degree; }
+	uint32_t getResolution() const { return m_Resolution; }
+
+	bool matches(uint32_t degree, const std::vector<float>& knots, uint32_t resolution) const { return m_Degree == degree && m_Resolution == resolution && m_Knots == knots && !m_Spans.empty(); }
+
+	// Index of the last control point weighted by the sample: points span - degree .. span are
+	uint32_t getSpan(uint32_t sample) const { return m_Spans[sample]; }
+
+	/**
+	 * @brief Gets the degree + 1 basis values of a sample, stored contiguously.
+	 */
+	const float* getValues(uint32_t sample) const { return m_Values.data() + static_cast<size_t>(sample) * (m_Degree + 1); }
+
+	/**
+	 * @brief Gets the derivatives, with respect to the knot parameter, of the degree + 1 basis values of a sample.
+	 */
+	const float* getDerivatives(uint32_t sample) const { return m_Derivatives.data() + static_cast<size_t>(sample) * (m_Degree + 1); }
+
+	/**
+	 * @brief Evaluates N(span - degree .. span) at t and their derivatives by the Cox-de Boor recurrence. Both outputs hold degree + 1 values.
+	 * t must lie in [knots[span], knots[span + 1]), a non-empty span.
+	 */
+	static void Evaluate(uint32_t degree, const float* knots, uint32_t span, float t, float* values, float* derivatives);
+
+private:
+	uint32_t m_Degree = 0;
+	uint32_t m_Resolution = 0;
+	std::vector<float> m_Knots;
+	std::vector<uint32_t> m_Spans;
+	std::vector<float> m_Values;
+	std::vector<float> m_Derivatives;
+};
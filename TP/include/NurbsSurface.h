@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Vroom/Asset/AssetData/MeshData.h>
+
+#include <glm/glm.hpp>
+
+#include "Bezier.h"
+#include "NurbsBasis.h"
+
+/**
+ * @brief Rational B-spline surface: a controlPointCountU x controlPointCountV weighted net, with a knot vector per direction.
+ * A single span with clamped knots and unit weights is the Bezier patch of the same net, sampled at the same parameters.
+ *
+ * Sampling follows Bezier: resolutionU x resolutionV samples, t = s / resolution over the knot domain, rows computed in parallel.
+ * The basis of every sample is tabulated per direction by NurbsBasis, and kept while degree, knots and resolution stay.
+ * Rows are contracted in homogeneous coordinates, so positions and analytic normals cost the same as for a polynomial surface.
+ */
+class NurbsSurface
+{
+public:
+	using Tile = Bezier::Tile;
+	using TileSink = Bezier::TileSink;
+
+public:
+	// Clamped uniform knots and unit weights
+	NurbsSurface(uint32_t degreeU, uint32_t degreeV, uint32_t controlPointCountU, uint32_t controlPointCountV, uint32_t resolutionU, uint32_t resolutionV);
+
+	void setControlPoint(uint32_t u, uint32_t v, const glm::vec3& p);
+	// Weights must be positive
+	void setWeight(uint32_t u, uint32_t v, float weight);
+	// controlPointCount + degree + 1 non-decreasing knots, with a non-empty domain [knots[degree], knots[controlPointCount]]
+	void setKnotsU(const std::vector<float>& knots);
+	void setKnotsV(const std::vector<float>& knots);
+	void setResolution(uint32_t resolutionU, uint32_t resolutionV);
+	// 0 uses every hardware thread
+	void setThreadCount(uint32_t threadCount);
+
+	const glm::vec3& getControlPoint(uint32_t u, uint32_t v) const;
+	float getWeight(uint32_t u, uint32_t v) const;
+	const std::vector<float>& getKnotsU() const { return m_KnotsU; }
+	const std::vector<float>& getKnotsV() const { return m_KnotsV; }
+	uint32_t getDegreeU() const { return m_DegreeU; }
+	uint32_t getDegreeV() const { return m_DegreeV; }
+	uint32_t getControlPointCountU() const { return m_ControlPointCountU; }
+	uint32_t getControlPointCountV() const { return m_ControlPointCountV; }
+	uint32_t getThreadCount() const;
+
+	// Indexed grid with analytic normals, cached until the surface changes
+	const vrm::MeshData& polygonize() const;
+
+	/**
+	 * @brief Polygonizes the surface in tiles of at most tileSize x tileSize samples, like Bezier::polygonizeTiles.
+	 * The cached mesh is left untouched.
+	 */
+	void polygonizeTiles(TileSink& sink, uint32_t tileSize = Bezier::DefaultTileSize) const;
+
+	bool isMeshUpToDate() const { return !m_NeedsCompute; }
+
+	// Clamped knots: degree + 1 copies of 0 and 1, and evenly spaced interior knots
+	static std::vector<float> ClampedUniformKnots(uint32_t degree, uint32_t controlPointCount);
+
+private:
+	struct SampleWindow
+	{
+		uint32_t firstSampleU, sampleCountU;
+		uint32_t firstSampleV, sampleCountV;
+
+		size_t size() const { return static_cast<size_t>(sampleCountU) * sampleCountV; }
+	};
+
+	void updateBasis() const;
+	void updateHomogeneousNet() const;
+	vrm::MeshData windowMesh(const SampleWindow& window) const;
+	void evaluateRows(const SampleWindow& window, vrm::Vertex* vertices, uint32_t rowBegin, uint32_t rowEnd) const;
+
+	static void CheckKnots(const std::vector<float>& knots, uint32_t degree, uint32_t controlPointCount);
+
+private:
+	uint32_t m_DegreeU, m_DegreeV;
+	uint32_t m_ControlPointCountU, m_ControlPointCountV;
+	uint32_t m_ResolutionU, m_ResolutionV;
+	std::vector<glm::vec3> m_ControlPoints;
+	std::vector<float> m_Weights;
+	std::vector<float> m_KnotsU, m_KnotsV;
+	uint32_t m_ThreadCount = 0;
+
+	mutable NurbsBasis m_BasisU, m_BasisV;
+	// (w x, w y, w z, w) of every control point
+	mutable std::vector<glm::vec4> m_HomogeneousNet;
+	mutable bool m_HomogeneousNetUpToDate = false;
+	mutable vrm::MeshData m_PolygonizedCache;
+	mutable bool m_NeedsCompute = true;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Binomial coefficients C(n, k) for n up to MaxDegree, generated at compile time.
+ * The table is immutable, so lookups are a single array index and safe from any thread.
+ */
+class PascalTriangle
+{
+public:
+	// Every coefficient up to row 67 fits in 64 bits
+	static constexpr uint32_t MaxDegree = 64;
+
+	static constexpr uint64_t Binomial(uint32_t n, uint32_t k) { return s_Table[RowOffset(n) + k]; }
+
+private:
+	static constexpr size_t RowOffset(uint32_t n) { return static_cast<size_t>(n) * (n + 1) / 2; }
+
+	static constexpr size_t TableSize = static_cast<size_t>(MaxDegree + 1) * (MaxDegree + 2) / 2;
+
+	// Row n starts at n * (n + 1) / 2
+	static constexpr std::array<uint64_t, TableSize> s_Table = []()
+	{
+		std::array<uint64_t, TableSize> table{};
+		size_t row = 0, previousRow = 0;
+
+		for (uint32_t n = 0; n <= MaxDegree; n++)
+		{
+			table[row] = 1;
+			table[row + n] = 1;
+
+			for (uint32_t k = 1; k < n; k++)
+				table[row + k] = table[previousRow + k - 1] + table[previousRow + k];
+
+			previousRow = row;
+			row += n + 1;
+		}
+
+		return table;
+	}();
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Vroom/Asset/AssetData/MeshData.h>
+
+#include <glm/glm.hpp>
+
+#include "SimdDeCasteljau.h"
+
+/**
+ * @brief A patchCountU x patchCountV grid of Bezier patches of the same degrees, sharing their boundary control points.
+ * The control net is global: (patchCountU * degreeU + 1) x (patchCountV * degreeV + 1) points, patch (pu, pv) using the
+ * points [pu * degreeU, (pu + 1) * degreeU] x [pv * degreeV, (pv + 1) * degreeV]. Shared boundaries make the surface C0.
+ * C1 continuity also keeps every boundary point halfway between its two neighbours across the boundary, in directions of degree 2 or more.
+ *
+ * Patches are tessellated in parallel, segments x segments quads each, into one indexed mesh where neighbouring patches share their seam vertices.
+ * Every patch owns its samples but the last row and column, which belong to the next patch, so that no vertex is written twice.
+ * Moving a control point only marks the patches it changed, the next polygonize tessellates them again in place.
+ */
+class PatchSurface
+{
+public:
+	enum class Continuity
+	{
+		// Shared boundary control points only
+		C0 = 0,
+		// Also matching first derivatives across boundaries
+		C1
+	};
+
+	// Vertices of the cached mesh changed since the last clearDirtyVertexRange
+	struct VertexRange
+	{
+		size_t first = 0;
+		size_t count = 0;
+	};
+
+public:
+	PatchSurface(uint32_t patchCountU, uint32_t patchCountV, uint32_t degreeU, uint32_t degreeV, uint32_t segmentsU, uint32_t segmentsV);
+
+	/**
+	 * @brief Moves a point of the global net. With C1 continuity, the points tied to it across boundaries are moved as well.
+	 * Only the patches using a moved point are tessellated again.
+	 */
+	void setControlPoint(uint32_t u, uint32_t v, const glm::vec3& p);
+	// Enforcing C1 moves the points next to every boundary, from the first patch onwards
+	void setContinuity(Continuity continuity);
+	// Quads per patch side
+	void setSegments(uint32_t segmentsU, uint32_t segmentsV);
+	void setSimdLevel(SimdLevel level);
+	// 0 uses every hardware thread
+	void setThreadCount(uint32_t threadCount);
+
+	const glm::vec3& getControlPoint(uint32_t u, uint32_t v) const;
+	uint32_t getControlPointCountU() const { return m_PatchCountU * m_DegreeU + 1; }
+	uint32_t getControlPointCountV() const { return m_PatchCountV * m_DegreeV + 1; }
+	uint32_t getPatchCountU() const { return m_PatchCountU; }
+	uint32_t getPatchCountV() const { return m_PatchCountV; }
+	uint32_t getDegreeU() const { return m_DegreeU; }
+	uint32_t getDegreeV() const { return m_DegreeV; }
+	Continuity getContinuity() const { return m_Continuity; }
+	SimdLevel getSimdLevel() const { return m_SimdLevel; }
+	uint32_t getThreadCount() const;
+
+	// Tessellates the dirty patches, if any, and returns the whole mesh
+	const vrm::MeshData& polygonize();
+
+	bool isPatchDirty(uint32_t patchU, uint32_t patchV) const { return m_DirtyPatches[patchIndex(patchU, patchV)]; }
+	// True when polygonize will return the cached mesh without tessellating anything
+	bool isMeshUpToDate() const;
+	// Patches tessellated by the last polygonize that had any
+	uint32_t getLastTessellatedPatchCount() const { return m_LastTessellatedPatchCount; }
+	const VertexRange& getDirtyVertexRange() const { return m_DirtyVertexRange; }
+	void clearDirtyVertexRange() { m_DirtyVertexRange = {}; }
+
+private:
+	// Samples of the whole surface, shared seams counted once
+	uint32_t sampleCountU() const { return m_PatchCountU * m_SegmentsU + 1; }
+	uint32_t sampleCountV() const { return m_PatchCountV * m_SegmentsV + 1; }
+	size_t patchIndex(uint32_t patchU, uint32_t patchV) const { return static_cast<size_t>(patchU) * m_PatchCountV + patchV; }
+	glm::vec3& at(uint32_t u, uint32_t v) { return m_ControlPoints[static_cast<size_t>(u) * getControlPointCountV() + v]; }
+
+	void markAllDirty();
+	void enforceContinuity();
+	void buildTopology();
+	void tessellatePatch(uint32_t patchU, uint32_t patchV);
+
+	/**
+	 * @brief Share of a move of point index carried by every point of a line of pointCount points, in patches of the given degree.
+	 * The unit share of index is propagated across boundaries so that the C1 relations, being linear, still hold after the move.
+	 */
+	static std::vector<float> MoveWeights(uint32_t index, uint32_t pointCount, uint32_t degree, bool c1);
+
+private:
+	uint32_t m_PatchCountU, m_PatchCountV;
+	uint32_t m_DegreeU, m_DegreeV;
+	uint32_t m_SegmentsU, m_SegmentsV;
+	std::vector<glm::vec3> m_ControlPoints;
+	Continuity m_Continuity = Continuity::C0;
+	SimdLevel m_SimdLevel = SimdDeCasteljau::BestLevel();
+	uint32_t m_ThreadCount = 0;
+
+	vrm::MeshData m_Mesh;
+	// Vertices and indices are sized for the current patch counts and segments
+	bool m_TopologyUpToDate = false;
+	std::vector<bool> m_DirtyPatches;
+	uint32_t m_LastTessellatedPatchCount = 0;
+	VertexRange m_DirtyVertexRange;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "PascalTriangle.h"
+
+enum class SimdLevel
+{
+	// One parameter at a time, on every CPU
+	Scalar = 0,
+	// 8 parameters per instruction
+	AVX2,
+	// 16 parameters per instruction
+	AVX512
+};
+
+/**
+ * @brief Control points as separate x, y and z arrays.
+ */
+struct SoaPoints
+{
+	std::vector<float> x, y, z;
+
+	SoaPoints() = default;
+	SoaPoints(const glm::vec3* points, size_t count) { assign(points, count); }
+
+	void assign(const glm::vec3* points, size_t count);
+	size_t size() const { return x.size(); }
+};
+
+struct DeCasteljauKernel;
+
+/**
+ * @brief Batched de Casteljau evaluation of a Bezier surface: every SIMD lane runs the recurrence on the same control net, at its own parameters.
+ * Meant for samples evaluated from scratch (direct evaluation, adaptive tessellation vertices), where no basis table can be shared.
+ * Each instruction set has its own translation unit, built for it only, and is only called when the CPU supports it.
+ * The scalar level runs the same algorithm one sample at a time.
+ */
+class SimdDeCasteljau
+{
+public:
+	static constexpr uint32_t MaxDegree = PascalTriangle::MaxDegree;
+
+	// Highest level supported by both the build and the CPU, detected once
+	static SimdLevel BestLevel();
+	static bool IsSupported(SimdLevel level);
+	static uint32_t LaneCount(SimdLevel level);
+	static const char* LevelName(SimdLevel level);
+
+	/**
+	 * @brief Evaluates a (degreeU + 1) x (degreeV + 1) net, row major, at (u[s], v[s]) for s in [0, count). Positions are written every positionStride bytes.
+	 * dS/du and dS/dv are written as well, every tangentStride bytes, when tangentsU and tangentsV are not null.
+	 * Unsupported levels fall back to the best supported one.
+	 */
+	static void EvaluateSurface(SimdLevel level, uint32_t degreeU, uint32_t degreeV, const SoaPoints& net, const float* u, const float* v, uint32_t count,
+		glm::vec3* positions, size_t positionStride, glm::vec3* tangentsU, glm::vec3* tangentsV, size_t tangentStride);
+
+private:
+	static const DeCasteljauKernel& Kernel(SimdLevel level);
+
+	// Null when the build has no kernel for the instruction set
+	static const DeCasteljauKernel* Avx2Kernel();
+	static const DeCasteljauKernel* Avx512Kernel();
+};
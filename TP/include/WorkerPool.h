@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads running data parallel loops.
+ * Only one loop runs at a time: concurrent callers of parallelFor are serialized.
+ */
+class WorkerPool
+{
+public:
+	explicit WorkerPool(uint32_t workerCount);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/**
+	 * @brief Gets the process-wide pool, with one worker per hardware thread besides the caller's.
+	 */
+	static WorkerPool& Get();
+
+	/**
+	 * @brief Gets the number of hardware threads, at least 1.
+	 */
+	static uint32_t HardwareThreadCount();
+
+	uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+	/**
+	 * @brief Runs task(0) .. task(taskCount - 1) on up to threadCount threads, the calling thread included, and waits for all of them.
+	 * Called from inside a task, the loop runs inline on the calling thread.
+	 */
+	void parallelFor(uint32_t taskCount, uint32_t threadCount, const std::function<void(uint32_t)>& task);
+
+private:
+	void workerLoop(std::stop_token stopToken);
+	void runTasks();
+
+private:
+	std::mutex m_SubmitMutex;
+
+	std::mutex m_Mutex;
+	std::condition_variable_any m_WakeUp;
+	std::condition_variable m_Done;
+
+	const std::function<void(uint32_t)>* m_Task = nullptr;
+	uint32_t m_TaskCount = 0;
+	std::atomic<uint32_t> m_NextTask = 0;
+	uint64_t m_Generation = 0;
+	uint32_t m_FreeSlots = 0;
+	uint32_t m_RunningWorkers = 0;
+
+	std::vector<std::jthread> m_Workers;
+};
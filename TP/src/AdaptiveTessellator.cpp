@@ -0,0 +1,325 @@
+#include "AdaptiveTessellator.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "BernsteinBasis.h"
+
+AdaptiveTessellator::AdaptiveTessellator(const std::vector<glm::vec3>& controlPoints, uint32_t degreeU, uint32_t degreeV, SimdLevel simdLevel)
+	: m_ControlPoints(controlPoints), m_DegreeU(degreeU), m_DegreeV(degreeV), m_SimdLevel(simdLevel)
+{
+}
+
+vrm::MeshData AdaptiveTessellator::tessellate(float flatnessTolerance, uint32_t maxDepth, Stats& stats) const
+{
+	maxDepth = std::min(maxDepth, MaxDepth);
+
+	std::vector<Patch> leaves;
+	uint32_t deepest = 0;
+	subdivide(m_ControlPoints, { 0, 0, 1u << MaxDepth }, 0, flatnessTolerance, maxDepth, leaves, deepest);
+
+	// Every leaf corner, by line, so that each leaf edge can find the corners of its finer neighbours
+	std::unordered_map<uint32_t, std::vector<uint32_t>> cornersOnRow, cornersOnColumn;
+
+	for (const Patch& leaf : leaves)
+	{
+		for (uint32_t y : { leaf.y, leaf.y + leaf.size })
+		{
+			cornersOnRow[y].push_back(leaf.x);
+			cornersOnRow[y].push_back(leaf.x + leaf.size);
+		}
+
+		for (uint32_t x : { leaf.x, leaf.x + leaf.size })
+		{
+			cornersOnColumn[x].push_back(leaf.y);
+			cornersOnColumn[x].push_back(leaf.y + leaf.size);
+		}
+	}
+
+	for (auto* lines : { &cornersOnRow, &cornersOnColumn })
+	{
+		for (auto& [line, corners] : *lines)
+		{
+			std::sort(corners.begin(), corners.end());
+			corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+		}
+	}
+
+	// Vertices are only numbered here, and evaluated together once every leaf is triangulated
+	std::vector<uint64_t> lattice;
+	std::vector<uint32_t> indices;
+	std::unordered_map<uint64_t, uint32_t> vertexIndices;
+
+	auto vertexAt = [&](uint32_t x, uint32_t y)
+	{
+		const uint64_t key = (static_cast<uint64_t>(x) << 32) | y;
+		auto [it, inserted] = vertexIndices.try_emplace(key, static_cast<uint32_t>(lattice.size()));
+
+		if (inserted)
+			lattice.push_back(key);
+
+		return it->second;
+	};
+
+	// Corners strictly inside ]from, to[ on a line, in walking order
+	auto cornersBetween = [](const std::vector<uint32_t>& corners, uint32_t from, uint32_t to, std::vector<uint32_t>& out)
+	{
+		const uint32_t low = std::min(from, to), high = std::max(from, to);
+		auto first = std::upper_bound(corners.begin(), corners.end(), low);
+		auto last = std::lower_bound(corners.begin(), corners.end(), high);
+
+		if (from < to)
+			out.insert(out.end(), first, last);
+		else
+			out.insert(out.end(), std::make_reverse_iterator(last), std::make_reverse_iterator(first));
+	};
+
+	std::vector<uint32_t> boundary, onEdge;
+
+	for (const Patch& leaf : leaves)
+	{
+		const uint32_t x0 = leaf.x, x1 = leaf.x + leaf.size;
+		const uint32_t y0 = leaf.y, y1 = leaf.y + leaf.size;
+
+		// Counter-clockwise in (u, v), like the uniform grid quads
+		boundary.clear();
+
+		boundary.push_back(vertexAt(x0, y0));
+		onEdge.clear();
+		cornersBetween(cornersOnRow[y0], x0, x1, onEdge);
+		for (uint32_t x : onEdge)
+			boundary.push_back(vertexAt(x, y0));
+
+		boundary.push_back(vertexAt(x1, y0));
+		onEdge.clear();
+		cornersBetween(cornersOnColumn[x1], y0, y1, onEdge);
+		for (uint32_t y : onEdge)
+			boundary.push_back(vertexAt(x1, y));
+
+		boundary.push_back(vertexAt(x1, y1));
+		onEdge.clear();
+		cornersBetween(cornersOnRow[y1], x1, x0, onEdge);
+		for (uint32_t x : onEdge)
+			boundary.push_back(vertexAt(x, y1));
+
+		boundary.push_back(vertexAt(x0, y1));
+		onEdge.clear();
+		cornersBetween(cornersOnColumn[x0], y1, y0, onEdge);
+		for (uint32_t y : onEdge)
+			boundary.push_back(vertexAt(x0, y));
+
+		if (boundary.size() == 4)
+		{
+			indices.insert(indices.end(), { boundary[0], boundary[1], boundary[2] });
+			indices.insert(indices.end(), { boundary[0], boundary[2], boundary[3] });
+			continue;
+		}
+
+		// T-junctions only appear next to finer leaves, so this leaf is at least 2 units wide and its centre is on the lattice
+		const uint32_t centre = vertexAt(x0 + leaf.size / 2, y0 + leaf.size / 2);
+
+		for (size_t i = 0; i < boundary.size(); i++)
+			indices.insert(indices.end(), { centre, boundary[i], boundary[(i + 1) % boundary.size()] });
+	}
+
+	std::vector<vrm::Vertex> vertices;
+	evaluateVertices(lattice, vertices);
+
+	stats.patchCount = leaves.size();
+	stats.depth = deepest;
+	stats.triangleCount = indices.size() / 3;
+	stats.uniformTriangleCount = static_cast<size_t>(2) << (2 * deepest);
+
+	return vrm::MeshData(std::move(vertices), std::move(indices));
+}
+
+void AdaptiveTessellator::subdivide(const std::vector<glm::vec3>& net, const Patch& patch, uint32_t depth, float tolerance, uint32_t maxDepth, std::vector<Patch>& leaves, uint32_t& deepest) const
+{
+	if (depth >= maxDepth || flatness(net) <= tolerance)
+	{
+		leaves.push_back(patch);
+		deepest = std::max(deepest, depth);
+		return;
+	}
+
+	const uint32_t half = patch.size / 2;
+
+	std::vector<glm::vec3> lowU, highU, lowV, highV;
+	splitU(net, lowU, highU);
+
+	splitV(lowU, lowV, highV);
+	subdivide(lowV, { patch.x, patch.y, half }, depth + 1, tolerance, maxDepth, leaves, deepest);
+	subdivide(highV, { patch.x, patch.y + half, half }, depth + 1, tolerance, maxDepth, leaves, deepest);
+
+	splitV(highU, lowV, highV);
+	subdivide(lowV, { patch.x + half, patch.y, half }, depth + 1, tolerance, maxDepth, leaves, deepest);
+	subdivide(highV, { patch.x + half, patch.y + half, half }, depth + 1, tolerance, maxDepth, leaves, deepest);
+}
+
+float AdaptiveTessellator::flatness(const std::vector<glm::vec3>& net) const
+{
+	// Distance of every control point to the bilinear patch of the four corners
+	const glm::vec3& p00 = at(net, 0, 0);
+	const glm::vec3& p10 = at(net, m_DegreeU, 0);
+	const glm::vec3& p01 = at(net, 0, m_DegreeV);
+	const glm::vec3& p11 = at(net, m_DegreeU, m_DegreeV);
+
+	float distance = 0.f;
+
+	for (uint32_t i = 0; i <= m_DegreeU; i++)
+	{
+		const float s = m_DegreeU > 0 ? static_cast<float>(i) / static_cast<float>(m_DegreeU) : 0.f;
+
+		for (uint32_t j = 0; j <= m_DegreeV; j++)
+		{
+			const float t = m_DegreeV > 0 ? static_cast<float>(j) / static_cast<float>(m_DegreeV) : 0.f;
+			const glm::vec3 bilinear = (1.f - s) * ((1.f - t) * p00 + t * p01) + s * ((1.f - t) * p10 + t * p11);
+
+			distance = std::max(distance, glm::length(at(net, i, j) - bilinear));
+		}
+	}
+
+	return distance;
+}
+
+void AdaptiveTessellator::splitU(const std::vector<glm::vec3>& net, std::vector<glm::vec3>& low, std::vector<glm::vec3>& high) const
+{
+	const size_t rowSize = static_cast<size_t>(m_DegreeV) + 1;
+
+	low.resize(net.size());
+	high.resize(net.size());
+
+	std::vector<glm::vec3> column(m_DegreeU + 1);
+
+	for (uint32_t j = 0; j <= m_DegreeV; j++)
+	{
+		for (uint32_t i = 0; i <= m_DegreeU; i++)
+			column[i] = at(net, i, j);
+
+		low[j] = column[0];
+		high[m_DegreeU * rowSize + j] = column[m_DegreeU];
+
+		for (uint32_t r = 1; r <= m_DegreeU; r++)
+		{
+			for (uint32_t i = 0; i + r <= m_DegreeU; i++)
+				column[i] = 0.5f * (column[i] + column[i + 1]);
+
+			low[r * rowSize + j] = column[0];
+			high[(m_DegreeU - r) * rowSize + j] = column[m_DegreeU - r];
+		}
+	}
+}
+
+void AdaptiveTessellator::splitV(const std::vector<glm::vec3>& net, std::vector<glm::vec3>& low, std::vector<glm::vec3>& high) const
+{
+	const size_t rowSize = static_cast<size_t>(m_DegreeV) + 1;
+
+	low.resize(net.size());
+	high.resize(net.size());
+
+	std::vector<glm::vec3> row(m_DegreeV + 1);
+
+	for (uint32_t i = 0; i <= m_DegreeU; i++)
+	{
+		for (uint32_t j = 0; j <= m_DegreeV; j++)
+			row[j] = at(net, i, j);
+
+		low[i * rowSize] = row[0];
+		high[i * rowSize + m_DegreeV] = row[m_DegreeV];
+
+		for (uint32_t r = 1; r <= m_DegreeV; r++)
+		{
+			for (uint32_t j = 0; j + r <= m_DegreeV; j++)
+				row[j] = 0.5f * (row[j] + row[j + 1]);
+
+			low[i * rowSize + r] = row[0];
+			high[i * rowSize + m_DegreeV - r] = row[m_DegreeV - r];
+		}
+	}
+}
+
+void AdaptiveTessellator::evaluateVertices(const std::vector<uint64_t>& lattice, std::vector<vrm::Vertex>& vertices) const
+{
+	vertices.resize(lattice.size());
+
+	if (m_SimdLevel == SimdLevel::Scalar || std::max(m_DegreeU, m_DegreeV) > SimdDeCasteljau::MaxDegree)
+	{
+		std::vector<float> basis(basisSize());
+
+		for (size_t i = 0; i < lattice.size(); i++)
+			vertices[i] = evaluate(static_cast<uint32_t>(lattice[i] >> 32), static_cast<uint32_t>(lattice[i]), basis);
+
+		return;
+	}
+
+	const float scale = 1.f / static_cast<float>(1u << MaxDepth);
+	std::vector<float> u(lattice.size()), v(lattice.size());
+
+	for (size_t i = 0; i < lattice.size(); i++)
+	{
+		u[i] = static_cast<float>(static_cast<uint32_t>(lattice[i] >> 32)) * scale;
+		v[i] = static_cast<float>(static_cast<uint32_t>(lattice[i])) * scale;
+	}
+
+	std::vector<glm::vec3> tangentsU(lattice.size()), tangentsV(lattice.size());
+	const SoaPoints net(m_ControlPoints.data(), m_ControlPoints.size());
+
+	SimdDeCasteljau::EvaluateSurface(m_SimdLevel, m_DegreeU, m_DegreeV, net, u.data(), v.data(), static_cast<uint32_t>(lattice.size()),
+		&vertices.data()->position, sizeof(vrm::Vertex), tangentsU.data(), tangentsV.data(), sizeof(glm::vec3));
+
+	for (size_t i = 0; i < lattice.size(); i++)
+	{
+		const glm::vec3 normal = glm::cross(tangentsU[i], tangentsV[i]);
+		const float length = glm::length(normal);
+
+		vertices[i].normal = length > 0.f ? normal / length : glm::vec3{ 0.f, 1.f, 0.f };
+		vertices[i].texCoords = { u[i], v[i] };
+	}
+}
+
+vrm::Vertex AdaptiveTessellator::evaluate(uint32_t x, uint32_t y, std::vector<float>& basis) const
+{
+	const float u = static_cast<float>(x) / static_cast<float>(1u << MaxDepth);
+	const float v = static_cast<float>(y) / static_cast<float>(1u << MaxDepth);
+
+	float* basisU = basis.data();
+	float* basisV = basisU + m_DegreeU + 1;
+	float* reducedU = basisV + m_DegreeV + 1;
+	float* reducedV = reducedU + std::max(m_DegreeU, 1u);
+
+	BernsteinBasis::Evaluate(m_DegreeU, u, basisU);
+	BernsteinBasis::Evaluate(m_DegreeV, v, basisV);
+
+	if (m_DegreeU > 0)
+		BernsteinBasis::Evaluate(m_DegreeU - 1, u, reducedU);
+	if (m_DegreeV > 0)
+		BernsteinBasis::Evaluate(m_DegreeV - 1, v, reducedV);
+
+	glm::vec3 position = glm::vec3{ 0.f, 0.f, 0.f };
+	glm::vec3 tangentU = glm::vec3{ 0.f, 0.f, 0.f };
+	glm::vec3 tangentV = glm::vec3{ 0.f, 0.f, 0.f };
+
+	for (uint32_t i = 0; i <= m_DegreeU; i++)
+	{
+		for (uint32_t j = 0; j <= m_DegreeV; j++)
+		{
+			const glm::vec3& p = at(m_ControlPoints, i, j);
+			position += basisU[i] * basisV[j] * p;
+
+			if (i < m_DegreeU)
+				tangentU += reducedU[i] * basisV[j] * (at(m_ControlPoints, i + 1, j) - p);
+			if (j < m_DegreeV)
+				tangentV += basisU[i] * reducedV[j] * (at(m_ControlPoints, i, j + 1) - p);
+		}
+	}
+
+	const glm::vec3 normal = glm::cross(static_cast<float>(m_DegreeU) * tangentU, static_cast<float>(m_DegreeV) * tangentV);
+	const float length = glm::length(normal);
+
+	vrm::Vertex vertex;
+	vertex.position = position;
+	vertex.normal = length > 0.f ? normal / length : glm::vec3{ 0.f, 1.f, 0.f };
+	vertex.texCoords = { u, v };
+
+	return vertex;
+}
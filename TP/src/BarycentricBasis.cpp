@@ -0,0 +1,33 @@
+#include "BarycentricBasis.h"
+
+BarycentricBasis::BarycentricBasis(uint32_t degree, uint32_t level)
+	: m_Degree(degree), m_Level(level)
+{
+	m_Powers.resize(static_cast<size_t>(level + 1) * (degree + 1));
+
+	for (uint32_t s = 0; s <= level; s++)
+	{
+		const float t = level > 0 ? static_cast<float>(s) / static_cast<float>(level) : 0.f;
+		float* powers = m_Powers.data() + static_cast<size_t>(s) * (degree + 1);
+
+		powers[0] = 1.f;
+
+		for (uint32_t e = 1; e <= degree; e++)
+			powers[e] = powers[e - 1] * t;
+	}
+}
+
+float BarycentricBasis::Multinomial(uint32_t degree, uint32_t i, uint32_t j)
+{
+	auto binomial = [](uint32_t n, uint32_t k)
+	{
+		double value = 1.0;
+
+		for (uint32_t r = 1; r <= k; r++)
+			value = value * (n - k + r) / r;
+
+		return value;
+	};
+
+	return static_cast<float>(binomial(degree, i) * binomial(degree - i, j));
+}
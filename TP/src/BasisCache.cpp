@@ -0,0 +1,99 @@
+#include "BasisCache.h"
+
+BasisCache::BasisCache(size_t byteBudget)
+	: m_ByteBudget(byteBudget)
+{
+}
+
+BasisCache& BasisCache::Get()
+{
+	static BasisCache cache;
+	return cache;
+}
+
+std::shared_ptr<const BernsteinBasis> BasisCache::acquire(uint32_t degree, uint32_t resolution)
+{
+	const Key key = MakeKey(degree, resolution);
+
+	{
+		std::lock_guard lock(m_Mutex);
+
+		if (auto it = m_Index.find(key); it != m_Index.end())
+		{
+			m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+			m_Hits++;
+			return it->second->basis;
+		}
+
+		m_Misses++;
+	}
+
+	// Tabulated outside the lock, so that other keys are served meanwhile
+	auto basis = std::make_shared<const BernsteinBasis>(degree, resolution);
+
+	std::lock_guard lock(m_Mutex);
+
+	if (auto it = m_Index.find(key); it != m_Index.end())
+		return it->second->basis;
+
+	if (basis->getByteSize() > m_ByteBudget)
+		return basis;
+
+	m_Entries.push_front({ key, basis });
+	m_Index.emplace(key, m_Entries.begin());
+	m_ByteSize += basis->getByteSize();
+	evict();
+
+	return basis;
+}
+
+void BasisCache::setByteBudget(size_t byteBudget)
+{
+	std::lock_guard lock(m_Mutex);
+
+	m_ByteBudget = byteBudget;
+	evict();
+}
+
+size_t BasisCache::getByteBudget() const
+{
+	std::lock_guard lock(m_Mutex);
+	return m_ByteBudget;
+}
+
+BasisCache::Stats BasisCache::getStats() const
+{
+	std::lock_guard lock(m_Mutex);
+	return { m_Hits, m_Misses, m_Evictions, m_Entries.size(), m_ByteSize };
+}
+
+void BasisCache::resetCounters()
+{
+	std::lock_guard lock(m_Mutex);
+
+	m_Hits = 0;
+	m_Misses = 0;
+	m_Evictions = 0;
+}
+
+void BasisCache::clear()
+{
+	std::lock_guard lock(m_Mutex);
+
+	m_Entries.clear();
+	m_Index.clear();
+	m_ByteSize = 0;
+}
+
+void BasisCache::evict()
+{
+	while (m_ByteSize > m_ByteBudget && !m_Entries.empty())
+	{
+		const Entry& entry = m_Entries.back();
+
+		m_ByteSize -= entry.basis->getByteSize();
+		m_Index.erase(entry.key);
+		m_Entries.pop_back();
+		m_Evictions++;
+	}
+}
@@ -0,0 +1,40 @@
+#include "BernsteinBasis.h"
+
+BernsteinBasis::BernsteinBasis(uint32_t degree, uint32_t resolution)
+	: m_Degree(degree), m_Resolution(resolution)
+{
+	m_Values.resize(static_cast<size_t>(resolution) * (degree + 1));
+	m_ReducedValues.resize(static_cast<size_t>(resolution) * degree);
+
+	for (uint32_t sample = 0; sample < resolution; sample++)
+	{
+		const float t = SampleParameter(sample, resolution);
+
+		Evaluate(degree, t, m_Values.data() + static_cast<size_t>(sample) * (degree + 1));
+
+		if (degree > 0)
+			Evaluate(degree - 1, t, m_ReducedValues.data() + static_cast<size_t>(sample) * degree);
+	}
+}
+
+float BernsteinBasis::SampleParameter(uint32_t sample, uint32_t resolution)
+{
+	return static_cast<float>(sample) / static_cast<float>(resolution);
+}
+
+void BernsteinBasis::Evaluate(uint32_t degree, float t, float* out)
+{
+	const float s = 1.f - t;
+
+	out[0] = 1.f;
+
+	for (uint32_t r = 1; r <= degree; r++)
+	{
+		out[r] = t * out[r - 1];
+
+		for (uint32_t k = r - 1; k > 0; k--)
+			out[k] = t * out[k - 1] + s * out[k];
+
+		out[0] *= s;
+	}
+}
@@ -1,9 +1,17 @@
 #include "Bezier.h"
 
+#include <Vroom/Core/Assert.h>
 #include <Vroom/Core/Log.h>
 
-std::unordered_map<std::pair<uint32_t, uint32_t>, uint32_t> Bezier::s_Binomials;
-std::vector<uint32_t> Bezier::s_Factorials = { 1, 1 };
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+#include "BasisCache.h"
+#include "DegreeKernels.h"
+#include "PascalTriangle.h"
+#include "WorkerPool.h"
 
 Bezier::Bezier(uint32_t degreeU, uint32_t degreeV, uint32_t resolutionU, uint32_t resolutionV)
 	: m_DegreeU(degreeU), m_DegreeV(degreeV), m_ResolutionU(resolutionU), m_ResolutionV(resolutionV)
@@ -13,8 +21,12 @@ Bezier::Bezier(uint32_t degreeU, uint32_t degreeV, uint32_t resolutionU, uint32_
 
 void Bezier::setControlPoint(uint32_t u, uint32_t v, const glm::vec3& p)
 {
-	m_ControlPoints.at(static_cast<size_t>(u * (m_DegreeV + 1) + v)) = p;
-	m_NeedsCompute = true;
+	glm::vec3& controlPoint = m_ControlPoints.at(static_cast<size_t>(u * (m_DegreeV + 1) + v));
+	const glm::vec3 delta = p - controlPoint;
+	controlPoint = p;
+
+	if (!m_NeedsCompute && !(m_IncrementalUpdates && patchMesh(u, v, delta)))
+		m_NeedsCompute = true;
 }
 
 void Bezier::setDegrees(uint32_t degreeU, uint32_t degreeV)
@@ -33,6 +45,108 @@ void Bezier::setResolution(uint32_t resolutionU, uint32_t resolutionV)
 	m_NeedsCompute = true;
 }
 
+void Bezier::setEvaluationMode(EvaluationMode mode)
+{
+	m_EvaluationMode = mode;
+
+	m_NeedsCompute = true;
+}
+
+void Bezier::setAnchorInterval(uint32_t interval)
+{
+	m_AnchorInterval = std::max(interval, 1u);
+
+	if (m_EvaluationMode == EvaluationMode::ForwardDifference)
+		m_NeedsCompute = true;
+}
+
+void Bezier::setMeshLayout(MeshLayout layout)
+{
+	m_MeshLayout = layout;
+
+	m_NeedsCompute = true;
+}
+
+void Bezier::setNormalMode(NormalMode mode)
+{
+	m_NormalMode = mode;
+
+	m_NeedsCompute = true;
+}
+
+void Bezier::setTessellationMode(TessellationMode mode)
+{
+	m_TessellationMode = mode;
+
+	m_NeedsCompute = true;
+}
+
+void Bezier::setFlatnessTolerance(float tolerance)
+{
+	m_FlatnessTolerance = tolerance;
+
+	if (m_TessellationMode == TessellationMode::Adaptive)
+		m_NeedsCompute = true;
+}
+
+void Bezier::setMaxSubdivisionDepth(uint32_t depth)
+{
+	m_MaxSubdivisionDepth = depth;
+
+	if (m_TessellationMode == TessellationMode::Adaptive)
+		m_NeedsCompute = true;
+}
+
+void Bezier::setSpecializedKernels(bool enabled)
+{
+	m_SpecializedKernels = enabled;
+
+	m_NeedsCompute = true;
+}
+
+void Bezier::setSimdLevel(SimdLevel level)
+{
+	m_SimdLevel = level;
+
+	if (m_EvaluationMode == EvaluationMode::Direct || m_TessellationMode == TessellationMode::Adaptive)
+		m_NeedsCompute = true;
+}
+
+void Bezier::setThreadCount(uint32_t threadCount)
+{
+	m_ThreadCount = threadCount;
+}
+
+void Bezier::setIncrementalUpdates(bool enabled)
+{
+	m_IncrementalUpdates = enabled;
+
+	// The tangent cache is only filled by a full computation
+	if (enabled && m_NormalMode == NormalMode::Analytic)
+		m_NeedsCompute = true;
+}
+
+void Bezier::setLodLevelCount(uint32_t count)
+{
+	m_LodLevelCount = count;
+
+	if (m_MeshLayout == MeshLayout::IndexedGrid && m_TessellationMode == TessellationMode::Uniform)
+		m_NeedsCompute = true;
+}
+
+void Bezier::setPrimitiveType(vrm::MeshData::PrimitiveType primitiveType)
+{
+	m_PrimitiveType = primitiveType;
+
+	if (m_MeshLayout == MeshLayout::IndexedGrid && m_TessellationMode == TessellationMode::Uniform)
+		m_NeedsCompute = true;
+}
+
+uint32_t Bezier::getThreadCount() const
+{
+	return m_ThreadCount == 0 ? WorkerPool::HardwareThreadCount() : m_ThreadCount;
+}
+
 const glm::vec3& Bezier::getControlPoint(uint32_t u, uint32_t v) const
 {
 	return m_ControlPoints.at(static_cast<size_t>(u * (m_DegreeV + 1) + v));
@@ -46,102 +160,938 @@ const vrm::MeshData& Bezier::polygonize() const
 	return m_PolygonizedCache;
 }
 
+const vrm::MeshData& Bezier::polygonize(std::stop_token stopToken) const
+{
+	m_StopToken = std::move(stopToken);
+	polygonize();
+	m_StopToken = {};
+
+	return m_PolygonizedCache;
+}
+
+vrm::MeshData Bezier::releaseMesh()
+{
+	polygonize();
+
+	m_NeedsCompute = true;
+	m_TangentCache = {};
+	m_DirtyVertexRange = {};
+
+	return std::move(m_PolygonizedCache);
+}
+
+void Bezier::discardMesh()
+{
+	m_NeedsCompute = true;
+	m_PolygonizedCache = {};
+	m_TangentCache = {};
+	m_DirtyVertexRange = {};
+}
+
+void Bezier::polygonizeTiles(TileSink& sink, uint32_t tileSize) const
+{
+	if (m_TessellationMode == TessellationMode::Adaptive)
+	{
+		AdaptiveTessellator::Stats stats;
+		vrm::MeshData mesh = AdaptiveTessellator(m_ControlPoints, m_DegreeU, m_DegreeV, m_SimdLevel).tessellate(m_FlatnessTolerance, m_MaxSubdivisionDepth, stats);
+		sink.onTile({ 0, 0, m_ResolutionU, 0, m_ResolutionV }, std::move(mesh));
+		return;
+	}
+
+	if (m_ResolutionU < 2 || m_ResolutionV < 2)
+		return;
+
+	VRM_ASSERT_MSG(tileSize >= 2, "A tile needs at least 2 x 2 samples to hold a quad.");
+
+	// Tiles overlap by one sample so that their quads cover the whole grid
+	const uint32_t quadsPerTile = tileSize - 1;
+	const uint32_t tilesU = (m_ResolutionU - 2) / quadsPerTile + 1;
+	const uint32_t tilesV = (m_ResolutionV - 2) / quadsPerTile + 1;
+
+	for (uint32_t tileU = 0; tileU < tilesU; tileU++)
+	{
+		for (uint32_t tileV = 0; tileV < tilesV; tileV++)
+		{
+			const uint32_t firstSampleU = tileU * quadsPerTile;
+			const uint32_t firstSampleV = tileV * quadsPerTile;
+			const SampleWindow window = { firstSampleU, std::min(tileSize, m_ResolutionU - firstSampleU), firstSampleV, std::min(tileSize, m_ResolutionV - firstSampleV) };
+
+			vrm::MeshData mesh = m_MeshLayout == MeshLayout::FlatShaded ? flatShadedMesh(window, nullptr) : indexedGridMesh(window, nullptr);
+			sink.onTile({ tileU * tilesV + tileV, window.firstSampleU, window.sampleCountU, window.firstSampleV, window.sampleCountV }, std::move(mesh));
+		}
+	}
+}
+
+Bezier::EvaluationError Bezier::measureEvaluationError() const
+{
+	EvaluationError error;
+
+	if (m_TessellationMode == TessellationMode::Adaptive || std::max(m_DegreeU, m_DegreeV) > PascalTriangle::MaxDegree || m_ResolutionU == 0 || m_ResolutionV == 0)
+		return error;
+
+	double squaredErrorSum = 0.0;
+	float minNormalCosine = 1.f;
+
+	for (uint32_t firstSampleU = 0; firstSampleU < m_ResolutionU; firstSampleU += DefaultTileSize)
+	{
+		const SampleWindow window = { firstSampleU, std::min(DefaultTileSize, m_ResolutionU - firstSampleU), 0, m_ResolutionV };
+		std::vector<vrm::Vertex> evaluated(window.size()), exact(window.size());
+
+		evaluateGrid({ &evaluated.data()->position, &evaluated.data()->normal, sizeof(vrm::Vertex), window }, m_EvaluationMode, m_SimdLevel);
+		evaluateGrid({ &exact.data()->position, &exact.data()->normal, sizeof(vrm::Vertex), window }, EvaluationMode::Direct, SimdLevel::Scalar);
+
+		for (size_t i = 0; i < window.size(); i++)
+		{
+			const float positionError = glm::length(evaluated[i].position - exact[i].position);
+			error.maxPositionError = std::max(error.maxPositionError, positionError);
+			squaredErrorSum += static_cast<double>(positionError) * positionError;
+			minNormalCosine = std::min(minNormalCosine, glm::dot(evaluated[i].normal, exact[i].normal));
+		}
+	}
+
+	error.rmsPositionError = static_cast<float>(std::sqrt(squaredErrorSum / (static_cast<double>(m_ResolutionU) * m_ResolutionV)));
+	error.maxNormalAngle = glm::degrees(std::acos(std::clamp(minNormalCosine, -1.f, 1.f)));
+
+	return error;
+}
+
 void Bezier::computeMesh() const
 {
-	std::vector<vrm::Vertex> vertices;
-	std::vector<uint32_t> indices;
+	if (m_TessellationMode == TessellationMode::Adaptive)
+	{
+		m_TangentCache = {};
+		m_PolygonizedCache = AdaptiveTessellator(m_ControlPoints, m_DegreeU, m_DegreeV, m_SimdLevel).tessellate(m_FlatnessTolerance, m_MaxSubdivisionDepth, m_AdaptiveStats);
+		m_DirtyVertexRange = {};
+		m_NeedsCompute = false;
+		return;
+	}
+
+	if (m_IncrementalUpdates && m_NormalMode == NormalMode::Analytic)
+		m_TangentCache.resize(static_cast<size_t>(m_ResolutionU) * m_ResolutionV);
+	else
+		m_TangentCache = {};
+
+	switch (m_MeshLayout)
+	{
+	case MeshLayout::FlatShaded:
+		computeFlatShadedMesh();
+		break;
+	case MeshLayout::IndexedGrid:
+		computeIndexedGridMesh();
+		break;
+	}
+
+	m_DirtyVertexRange = {};
+	// A cancelled computation leaves an incomplete mesh behind
+	m_NeedsCompute = m_StopToken.stop_requested();
+}
+
+void Bezier::computeFlatShadedMesh() const
+{
+	m_PolygonizedCache = flatShadedMesh(fullWindow(), m_TangentCache.empty() ? nullptr : m_TangentCache.data());
+}
+
+void Bezier::computeIndexedGridMesh() const
+{
+	m_PolygonizedCache = indexedGridMesh(fullWindow(), m_TangentCache.empty() ? nullptr : m_TangentCache.data());
+
+	if (!m_StopToken.stop_requested())
+		addLodLevels(m_PolygonizedCache);
+}
+
+void Bezier::addLodLevels(vrm::MeshData& mesh) const
+{
+	// Samples kept along a direction: every stride-th one, and the last one
+	auto stridedSamples = [](uint32_t resolution, uint32_t stride)
+	{
+		std::vector<uint32_t> samples;
+
+		for (uint32_t sample = 0; sample + 1 < resolution; sample += stride)
+			samples.push_back(sample);
+
+		if (resolution > 0)
+			samples.push_back(resolution - 1);
+
+		return samples;
+	};
+
+	const uint32_t rowSize = m_ResolutionV;
+	uint32_t finerQuadCount = std::max(m_ResolutionU, m_ResolutionV) - 1;
+
+	for (uint32_t level = 1; level <= m_LodLevelCount && level < 32; level++)
+	{
+		const std::vector<uint32_t> samplesU = stridedSamples(m_ResolutionU, 1u << level);
+		const std::vector<uint32_t> samplesV = stridedSamples(m_ResolutionV, 1u << level);
+		const uint32_t quadCount = static_cast<uint32_t>(std::max(samplesU.size(), samplesV.size())) - 1;
+
+		// Nothing left to drop
+		if (samplesU.size() < 2 || samplesV.size() < 2 || quadCount >= finerQuadCount)
+			break;
+
+		// Same quads as the full grid, spanning several samples
+		const size_t quadRows = samplesU.size() - 1;
+		std::vector<uint32_t> indices(quadRows * QuadRowIndexCount(samplesV.size(), m_PrimitiveType));
+		uint32_t* out = indices.data();
+
+		for (size_t row = 0; row < quadRows; row++)
+			out = WriteQuadRow(samplesU[row] * rowSize, samplesU[row + 1] * rowSize, samplesV, m_PrimitiveType, row + 1 == quadRows, out);
+
+		indices.resize(static_cast<size_t>(out - indices.data()));
+		mesh.addLodLevel(std::move(indices), static_cast<float>(finerQuadCount) / LodQuadsPerViewport);
+		finerQuadCount = quadCount;
+	}
+}
+
+vrm::MeshData Bezier::flatShadedMesh(const SampleWindow& window, TangentFrame* tangents) const
+{
+	const bool analyticNormals = m_NormalMode == NormalMode::Analytic;
 
-	size_t triangleCount = static_cast<size_t>(m_ResolutionU) * static_cast<size_t>(m_ResolutionV) * 2;
-	indices.reserve(triangleCount * 3);
-	vertices.reserve(triangleCount * 3);
+	std::vector<vrm::Vertex> grid(window.size());
+	evaluateGrid({ &grid.data()->position, analyticNormals ? &grid.data()->normal : nullptr, sizeof(vrm::Vertex), window, tangents }, m_EvaluationMode, m_SimdLevel);
 
-	for (uint32_t sampleU = 0; sampleU < m_ResolutionU - 1; sampleU++)
+	if (m_StopToken.stop_requested())
+		return {};
+
+	const size_t rowSize = static_cast<size_t>(window.sampleCountV);
+	const uint32_t quadRows = window.sampleCountU > 1 ? window.sampleCountU - 1 : 0;
+	const size_t quadsPerRow = window.sampleCountV > 1 ? rowSize - 1 : 0;
+
+	// Every quad row owns a fixed slice of 6 vertices per quad, indices are the identity
+	std::vector<vrm::Vertex> vertices(quadRows * quadsPerRow * 6);
+	std::vector<uint32_t> indices(vertices.size());
+
+	forEachRowBlock(quadRows, [&](uint32_t rowBegin, uint32_t rowEnd)
 	{
-		for (uint32_t sampleV = 0; sampleV < m_ResolutionV - 1; sampleV++)
+		for (uint32_t sampleU = rowBegin; sampleU < rowEnd; sampleU++)
 		{
-			const float u0 = static_cast<float>(sampleU) / static_cast<float>(m_ResolutionU);
-			const float u1 = static_cast<float>(sampleU + 1) / static_cast<float>(m_ResolutionU);
-			const float v0 = static_cast<float>(sampleV) / static_cast<float>(m_ResolutionV);
-			const float v1 = static_cast<float>(sampleV + 1) / static_cast<float>(m_ResolutionV);
+			size_t offset = sampleU * quadsPerRow * 6;
+
+			for (uint32_t sampleV = 0; sampleV < quadsPerRow; sampleV++)
+			{
+				const size_t a = static_cast<size_t>(sampleU) * rowSize + sampleV;
+
+				vrm::Vertex A = grid[a];
+				vrm::Vertex B = grid[a + rowSize];
+				vrm::Vertex C = grid[a + rowSize + 1];
+				vrm::Vertex D = grid[a + 1];
+
+				glm::vec3 normal0, normal1;
 
-			vrm::Vertex A;
-				A.position = computeBezier(u0, v0);
-			vrm::Vertex B;
-				B.position = computeBezier(u1, v0);
-			vrm::Vertex C;
-				C.position = computeBezier(u1, v1);
-			vrm::Vertex D;
-				D.position = computeBezier(u0, v1);
+				if (!analyticNormals)
+				{
+					const glm::vec3 AC = C.position - A.position;
+					const glm::vec3 AD = D.position - A.position;
+					const glm::vec3 AB = B.position - A.position;
 
-			const glm::vec3 AC = C.position - A.position;
-			const glm::vec3 AD = D.position - A.position;
-			const glm::vec3 AB = B.position - A.position;
-			
-			const glm::vec3 normal0 = glm::normalize(glm::cross(AB, AC));
-			const glm::vec3 normal1 = glm::normalize(glm::cross(AC, AD));
+					normal0 = glm::normalize(glm::cross(AB, AC));
+					normal1 = glm::normalize(glm::cross(AC, AD));
 
-			A.normal = normal0;
-			B.normal = normal0;
-			C.normal = normal0;
+					A.normal = normal0;
+					B.normal = normal0;
+					C.normal = normal0;
+				}
 
-			uint32_t offset = static_cast<uint32_t>(vertices.size());
-			indices.push_back(offset + 0);
-			indices.push_back(offset + 1);
-			indices.push_back(offset + 2);
-			vertices.push_back(A);
-			vertices.push_back(B);
-			vertices.push_back(C);
+				vertices[offset + 0] = A;
+				vertices[offset + 1] = B;
+				vertices[offset + 2] = C;
 
-			A.normal = normal1;
-			C.normal = normal1;
-			D.normal = normal1;
+				if (!analyticNormals)
+				{
+					A.normal = normal1;
+					C.normal = normal1;
+					D.normal = normal1;
+				}
 
-			offset += 3;
-			indices.push_back(offset + 0);
-			indices.push_back(offset + 1);
-			indices.push_back(offset + 2);
-			vertices.push_back(A);
-			vertices.push_back(C);
-			vertices.push_back(D);
+				vertices[offset + 3] = A;
+				vertices[offset + 4] = C;
+				vertices[offset + 5] = D;
+
+				for (size_t i = offset; i < offset + 6; i++)
+					indices[i] = static_cast<uint32_t>(i);
+
+				offset += 6;
+			}
+		}
+	});
+
+	return vrm::MeshData(std::move(vertices), std::move(indices));
+}
+
+vrm::MeshData Bezier::indexedGridMesh(const SampleWindow& window, TangentFrame* tangents) const
+{
+	const bool analyticNormals = m_NormalMode == NormalMode::Analytic;
+	const size_t rowSize = static_cast<size_t>(window.sampleCountV);
+	const uint32_t quadRows = window.sampleCountU > 1 ? window.sampleCountU - 1 : 0;
+	const size_t quadsPerRow = window.sampleCountV > 1 ? rowSize - 1 : 0;
+
+	std::vector<vrm::Vertex> vertices(window.size());
+	// Every quad row owns a fixed slice of the indices, the last strip has no restart
+	const size_t rowIndexCount = QuadRowIndexCount(rowSize, m_PrimitiveType);
+	std::vector<uint32_t> indices(quadRows * rowIndexCount);
+	std::vector<uint32_t> columns(quadsPerRow > 0 ? rowSize : 0);
+	std::iota(columns.begin(), columns.end(), 0u);
+
+	// Finite differences need the samples around the window. The full grid has none, and is evaluated in place.
+	const SampleWindow evaluated = analyticNormals ? window : window.grown(m_ResolutionU, m_ResolutionV);
+	std::vector<vrm::Vertex> apronGrid(evaluated == window ? 0 : evaluated.size());
+	vrm::Vertex* grid = apronGrid.empty() ? vertices.data() : apronGrid.data();
+
+	evaluateGrid({ &grid->position, analyticNormals ? &grid->normal : nullptr, sizeof(vrm::Vertex), evaluated, tangents }, m_EvaluationMode, m_SimdLevel);
+
+	if (m_StopToken.stop_requested())
+		return {};
+
+	// Finite differences read the neighbouring rows, so they wait for the whole grid to be evaluated
+	forEachRowBlock(window.sampleCountU, [&](uint32_t rowBegin, uint32_t rowEnd)
+	{
+		for (uint32_t row = rowBegin; row < rowEnd; row++)
+		{
+			const uint32_t sampleU = window.firstSampleU + row;
+
+			for (uint32_t column = 0; column < window.sampleCountV; column++)
+			{
+				const uint32_t sampleV = window.firstSampleV + column;
+				vrm::Vertex& vertex = vertices[static_cast<size_t>(row) * rowSize + column];
+
+				if (!apronGrid.empty())
+					vertex = grid[evaluated.index(sampleU, sampleV)];
+
+				if (!analyticNormals)
+					vertex.normal = gridNormal(grid, evaluated, sampleU, sampleV);
+
+				vertex.texCoords = { BernsteinBasis::SampleParameter(sampleU, m_ResolutionU), BernsteinBasis::SampleParameter(sampleV, m_ResolutionV) };
+			}
+
+			if (row >= quadRows)
+				continue;
+
+			const uint32_t rowA = static_cast<uint32_t>(static_cast<size_t>(row) * rowSize);
+			WriteQuadRow(rowA, rowA + static_cast<uint32_t>(rowSize), columns, m_PrimitiveType, row + 1 == quadRows, indices.data() + row * rowIndexCount);
 		}
+	});
+
+	if (m_PrimitiveType == vrm::MeshData::PrimitiveType::TriangleStrip && !indices.empty())
+		indices.pop_back();
+
+	return vrm::MeshData(std::move(vertices), std::move(indices), m_PrimitiveType);
+}
+
+size_t Bezier::QuadRowIndexCount(size_t columnCount, vrm::MeshData::PrimitiveType primitiveType)
+{
+	if (columnCount < 2)
+		return 0;
+
+	return primitiveType == vrm::MeshData::PrimitiveType::TriangleStrip ? 2 * columnCount + 1 : (columnCount - 1) * 6;
+}
+
+uint32_t* Bezier::WriteQuadRow(uint32_t rowA, uint32_t rowB, const std::vector<uint32_t>& columns, vrm::MeshData::PrimitiveType primitiveType, bool lastRow, uint32_t* out)
+{
+	if (columns.size() < 2)
+		return out;
+
+	if (primitiveType == vrm::MeshData::PrimitiveType::TriangleStrip)
+	{
+		// a0 b0 a1 b1 ...: counter-clockwise like the triangles, across the other diagonal of the quads
+		for (uint32_t column : columns)
+		{
+			*out++ = rowA + column;
+			*out++ = rowB + column;
+		}
+
+		if (!lastRow)
+			*out++ = vrm::MeshData::RestartIndex;
+
+		return out;
 	}
 
-	m_PolygonizedCache = vrm::MeshData(std::move(vertices), std::move(indices));
+	for (size_t i = 0; i + 1 < columns.size(); i++)
+	{
+		const uint32_t a = rowA + columns[i];
+		const uint32_t b = rowB + columns[i];
+		const uint32_t c = rowB + columns[i + 1];
+		const uint32_t d = rowA + columns[i + 1];
 
-	m_NeedsCompute = false;
+		*out++ = a;
+		*out++ = b;
+		*out++ = c;
+
+		*out++ = a;
+		*out++ = c;
+		*out++ = d;
+	}
+
+	return out;
+}
+
+Bezier::SampleWindow Bezier::SampleWindow::grown(uint32_t resolutionU, uint32_t resolutionV) const
+{
+	const uint32_t firstU = firstSampleU > 0 ? firstSampleU - 1 : 0;
+	const uint32_t firstV = firstSampleV > 0 ? firstSampleV - 1 : 0;
+	const uint32_t endU = std::min(endSampleU() + 1, resolutionU);
+	const uint32_t endV = std::min(endSampleV() + 1, resolutionV);
+
+	return { firstU, endU - firstU, firstV, endV - firstV };
+}
+
+glm::vec3 Bezier::gridNormal(const vrm::Vertex* vertices, const SampleWindow& window, uint32_t sampleU, uint32_t sampleV) const
+{
+	// Central differences on the grid, one-sided on the borders of the surface. The window holds the neighbours.
+	const uint32_t prevU = sampleU > 0 ? sampleU - 1 : sampleU;
+	const uint32_t nextU = sampleU + 1 < m_ResolutionU ? sampleU + 1 : sampleU;
+	const uint32_t prevV = sampleV > 0 ? sampleV - 1 : sampleV;
+	const uint32_t nextV = sampleV + 1 < m_ResolutionV ? sampleV + 1 : sampleV;
+
+	const glm::vec3 tangentU = vertices[window.index(nextU, sampleV)].position - vertices[window.index(prevU, sampleV)].position;
+	const glm::vec3 tangentV = vertices[window.index(sampleU, nextV)].position - vertices[window.index(sampleU, prevV)].position;
+
+	return glm::normalize(glm::cross(tangentU, tangentV));
+}
+
+bool Bezier::patchMesh(uint32_t u, uint32_t v, const glm::vec3& delta)
+{
+	const bool analyticNormals = m_NormalMode == NormalMode::Analytic;
+	const size_t rowSize = static_cast<size_t>(m_ResolutionV);
+
+	// Subdivision depends on the control net, the adaptive mesh is always rebuilt
+	if (m_TessellationMode == TessellationMode::Adaptive)
+		return false;
+
+	if (analyticNormals && m_TangentCache.size() != static_cast<size_t>(m_ResolutionU) * rowSize)
+		return false;
+
+	updateBasis();
+
+	// The surface is linear in its control points: every sample moves by weightU * weightV * delta,
+	// and its partial derivatives by the same product with one weight replaced by its derivative.
+	std::vector<float> weightU(m_ResolutionU), derivativeWeightU(m_ResolutionU);
+	std::vector<float> weightV(m_ResolutionV), derivativeWeightV(m_ResolutionV);
+
+	auto derivativeWeight = [](const BernsteinBasis& basis, uint32_t sample, uint32_t k)
+	{
+		const float* reduced = basis.getReducedValues(sample);
+		const float lower = k > 0 ? reduced[k - 1] : 0.f;
+		const float upper = k < basis.getDegree() ? reduced[k] : 0.f;
+
+		return static_cast<float>(basis.getDegree()) * (lower - upper);
+	};
+
+	uint32_t firstRow = m_ResolutionU, lastRow = 0;
+
+	for (uint32_t sampleU = 0; sampleU < m_ResolutionU; sampleU++)
+	{
+		weightU[sampleU] = m_BasisU->getValues(sampleU)[u];
+		derivativeWeightU[sampleU] = derivativeWeight(*m_BasisU, sampleU, u);
+
+		if (weightU[sampleU] != 0.f || derivativeWeightU[sampleU] != 0.f)
+		{
+			firstRow = std::min(firstRow, sampleU);
+			lastRow = sampleU;
+		}
+	}
+
+	for (uint32_t sampleV = 0; sampleV < m_ResolutionV; sampleV++)
+	{
+		weightV[sampleV] = m_BasisV->getValues(sampleV)[v];
+		derivativeWeightV[sampleV] = derivativeWeight(*m_BasisV, sampleV, v);
+	}
+
+	if (firstRow > lastRow)
+		return true;
+
+	vrm::Vertex* vertices = m_PolygonizedCache.getRawVericesData();
+
+	// Rows of samples moved by the control point
+	auto forEachMovedRow = [&](const std::function<void(uint32_t)>& task)
+	{
+		forEachRowBlock(lastRow - firstRow + 1, [&](uint32_t rowBegin, uint32_t rowEnd)
+		{
+			for (uint32_t sampleU = firstRow + rowBegin; sampleU < firstRow + rowEnd; sampleU++)
+				task(sampleU);
+		});
+	};
+
+	auto patchTangents = [&](uint32_t sampleU, uint32_t sampleV) -> const TangentFrame&
+	{
+		TangentFrame& tangents = m_TangentCache[static_cast<size_t>(sampleU) * rowSize + sampleV];
+		tangents.u += derivativeWeightU[sampleU] * weightV[sampleV] * delta;
+		tangents.v += weightU[sampleU] * derivativeWeightV[sampleV] * delta;
+
+		return tangents;
+	};
+
+	switch (m_MeshLayout)
+	{
+	case MeshLayout::IndexedGrid:
+	{
+		forEachMovedRow([&](uint32_t sampleU)
+		{
+			for (uint32_t sampleV = 0; sampleV < m_ResolutionV; sampleV++)
+			{
+				vrm::Vertex& vertex = vertices[static_cast<size_t>(sampleU) * rowSize + sampleV];
+				vertex.position += weightU[sampleU] * weightV[sampleV] * delta;
+
+				if (analyticNormals)
+				{
+					const TangentFrame& tangents = patchTangents(sampleU, sampleV);
+					vertex.normal = SurfaceNormal(tangents.u, tangents.v);
+				}
+			}
+		});
+
+		uint32_t firstDirtyRow = firstRow, lastDirtyRow = lastRow;
+
+		// Finite difference normals also change one row around the moved samples
+		if (!analyticNormals)
+		{
+			firstDirtyRow = firstRow > 0 ? firstRow - 1 : 0;
+			lastDirtyRow = std::min(lastRow + 1, m_ResolutionU - 1);
+
+			forEachRowBlock(lastDirtyRow - firstDirtyRow + 1, [&](uint32_t rowBegin, uint32_t rowEnd)
+			{
+				for (uint32_t sampleU = firstDirtyRow + rowBegin; sampleU < firstDirtyRow + rowEnd; sampleU++)
+					for (uint32_t sampleV = 0; sampleV < m_ResolutionV; sampleV++)
+						vertices[static_cast<size_t>(sampleU) * rowSize + sampleV].normal = gridNormal(vertices, fullWindow(), sampleU, sampleV);
+			});
+		}
+
+		addDirtyVertices(firstDirtyRow * rowSize, (lastDirtyRow - firstDirtyRow + 1) * rowSize);
+		break;
+	}
+	case MeshLayout::FlatShaded:
+	{
+		const uint32_t quadRows = m_ResolutionU > 1 ? m_ResolutionU - 1 : 0;
+		const size_t quadsPerRow = m_ResolutionV > 1 ? rowSize - 1 : 0;
+
+		if (quadRows == 0 || quadsPerRow == 0)
+			break;
+
+		if (analyticNormals)
+		{
+			forEachMovedRow([&](uint32_t sampleU)
+			{
+				for (uint32_t sampleV = 0; sampleV < m_ResolutionV; sampleV++)
+					patchTangents(sampleU, sampleV);
+			});
+		}
+
+		// Quad rows touching the moved sample rows
+		const uint32_t firstQuadRow = firstRow > 0 ? firstRow - 1 : 0;
+		const uint32_t lastQuadRow = std::min(lastRow, quadRows - 1);
+
+		// Sample offsets of the 6 vertices of a quad: A, B, C, A, C, D
+		const size_t corners[6] = { 0, rowSize, rowSize + 1, 0, rowSize + 1, 1 };
+
+		forEachRowBlock(lastQuadRow - firstQuadRow + 1, [&](uint32_t rowBegin, uint32_t rowEnd)
+		{
+			for (uint32_t quadU = firstQuadRow + rowBegin; quadU < firstQuadRow + rowEnd; quadU++)
+			{
+				for (uint32_t quadV = 0; quadV < quadsPerRow; quadV++)
+				{
+					vrm::Vertex* quad = vertices + (quadU * quadsPerRow + quadV) * 6;
+					const size_t a = static_cast<size_t>(quadU) * rowSize + quadV;
+
+					for (uint32_t i = 0; i < 6; i++)
+					{
+						const size_t sample = a + corners[i];
+						const uint32_t sampleU = static_cast<uint32_t>(sample / rowSize);
+						const uint32_t sampleV = static_cast<uint32_t>(sample % rowSize);
+
+						quad[i].position += weightU[sampleU] * weightV[sampleV] * delta;
+
+						if (analyticNormals)
+							quad[i].normal = SurfaceNormal(m_TangentCache[sample].u, m_TangentCache[sample].v);
+					}
+
+					if (!analyticNormals)
+					{
+						const glm::vec3 normal0 = glm::normalize(glm::cross(quad[1].position - quad[0].position, quad[2].position - quad[0].position));
+						const glm::vec3 normal1 = glm::normalize(glm::cross(quad[4].position - quad[3].position, quad[5].position - quad[3].position));
+
+						quad[0].normal = quad[1].normal = quad[2].normal = normal0;
+						quad[3].normal = quad[4].normal = quad[5].normal = normal1;
+					}
+				}
+			}
+		});
+
+		addDirtyVertices(firstQuadRow * quadsPerRow * 6, (lastQuadRow - firstQuadRow + 1) * quadsPerRow * 6);
+		break;
+	}
+	}
+
+	return true;
+}
+
+void Bezier::addDirtyVertices(size_t first, size_t count)
+{
+	if (m_DirtyVertexRange.count == 0)
+	{
+		m_DirtyVertexRange = { first, count };
+		return;
+	}
+
+	const size_t end = std::max(m_DirtyVertexRange.first + m_DirtyVertexRange.count, first + count);
+	m_DirtyVertexRange.first = std::min(m_DirtyVertexRange.first, first);
+	m_DirtyVertexRange.count = end - m_DirtyVertexRange.first;
+}
+
+void Bezier::forEachRowBlock(uint32_t rowCount, const std::function<void(uint32_t, uint32_t)>& task) const
+{
+	const uint32_t threadCount = getThreadCount();
+
+	// A few blocks per thread so that uneven blocks still balance
+	const uint32_t blockCount = std::max(std::min(rowCount, threadCount * 4), 1u);
+	const uint32_t blockSize = (rowCount + blockCount - 1) / blockCount;
+
+	WorkerPool::Get().parallelFor(blockCount, threadCount, [&](uint32_t block)
+	{
+		const uint32_t rowBegin = block * blockSize;
+		const uint32_t rowEnd = std::min(rowBegin + blockSize, rowCount);
+
+		// Blocks are run in slices so that a cancelled computation stops soon
+		for (uint32_t sliceBegin = rowBegin; sliceBegin < rowEnd && !m_StopToken.stop_requested(); sliceBegin += CancellationRowCount)
+			task(sliceBegin, std::min(sliceBegin + CancellationRowCount, rowEnd));
+	});
+}
+
+void Bezier::updateBasis() const
+{
+	updateBasisU();
+
+	if (!m_BasisV || !m_BasisV->matches(m_DegreeV, m_ResolutionV))
+		m_BasisV = BasisCache::Get().acquire(m_DegreeV, m_ResolutionV);
+}
+
+void Bezier::updateBasisU() const
+{
+	if (!m_BasisU || !m_BasisU->matches(m_DegreeU, m_ResolutionU))
+		m_BasisU = BasisCache::Get().acquire(m_DegreeU, m_ResolutionU);
+}
+
+void Bezier::updateDerivativeNets() const
+{
+	const size_t rowSize = static_cast<size_t>(m_DegreeV) + 1;
+
+	m_DerivativeNetU.resize(static_cast<size_t>(m_DegreeU) * rowSize);
+	m_DerivativeNetV.resize((static_cast<size_t>(m_DegreeU) + 1) * m_DegreeV);
+
+	for (uint32_t i = 0; i < m_DegreeU; i++)
+		for (uint32_t j = 0; j < m_DegreeV + 1; j++)
+			m_DerivativeNetU[i * rowSize + j] = static_cast<float>(m_DegreeU) * (getControlPoint(i + 1, j) - getControlPoint(i, j));
+
+	for (uint32_t i = 0; i < m_DegreeU + 1; i++)
+		for (uint32_t j = 0; j < m_DegreeV; j++)
+			m_DerivativeNetV[static_cast<size_t>(i) * m_DegreeV + j] = static_cast<float>(m_DegreeV) * (getControlPoint(i, j + 1) - getControlPoint(i, j));
+}
+
+void Bezier::evaluateGrid(const SampleTarget& target, EvaluationMode mode, SimdLevel simdLevel) const
+{
+	// Shared state is prepared here, the row blocks then only read it
+	if (target.normals)
+		updateDerivativeNets();
+
+	switch (mode)
+	{
+	case EvaluationMode::Direct:
+		VRM_ASSERT_MSG(std::max(m_DegreeU, m_DegreeV) <= PascalTriangle::MaxDegree, "Direct evaluation supports degrees up to {}, use separable evaluation beyond.", PascalTriangle::MaxDegree);
+		if (simdLevel != SimdLevel::Scalar)
+			m_SoaControlPoints.assign(m_ControlPoints.data(), m_ControlPoints.size());
+		break;
+	case EvaluationMode::Separable:
+		updateBasis();
+		break;
+	case EvaluationMode::ForwardDifference:
+		VRM_ASSERT_MSG(m_DegreeV <= PascalTriangle::MaxDegree, "Forward difference evaluation supports V degrees up to {}, use separable evaluation beyond.", PascalTriangle::MaxDegree);
+		// Rows are stepped, only the U basis is tabulated
+		updateBasisU();
+		break;
+	}
+
+	const uint32_t firstRow = target.window.firstSampleU;
+
+	forEachRowBlock(target.window.sampleCountU, [&](uint32_t rowBegin, uint32_t rowEnd)
+	{
+		switch (mode)
+		{
+		case EvaluationMode::Direct:
+			if (simdLevel != SimdLevel::Scalar)
+				evaluateRowsBatched(target, simdLevel, firstRow + rowBegin, firstRow + rowEnd);
+			else
+				evaluateRowsDirect(target, firstRow + rowBegin, firstRow + rowEnd);
+			break;
+		case EvaluationMode::Separable:
+		case EvaluationMode::ForwardDifference:
+			evaluateRowsSeparable(target, mode, firstRow + rowBegin, firstRow + rowEnd);
+			break;
+		}
+	});
+}
+
+void Bezier::evaluateRowsDirect(const SampleTarget& target, uint32_t rowBegin, uint32_t rowEnd) const
+{
+	// The kernels of the derivative nets are the degree - 1 ones, always specialized when the degree is
+	const bool specialized = m_SpecializedKernels && DegreeKernels::IsSpecialized(std::max(m_DegreeU, m_DegreeV));
+
+	const DegreeKernel& kernelU = DegreeKernels::Get(m_DegreeU, specialized);
+	const DegreeKernel& kernelV = DegreeKernels::Get(m_DegreeV, specialized);
+	const DegreeKernel& reducedKernelU = DegreeKernels::Get(m_DegreeU > 0 ? m_DegreeU - 1 : 0, specialized);
+	const DegreeKernel& reducedKernelV = DegreeKernels::Get(m_DegreeV > 0 ? m_DegreeV - 1 : 0, specialized);
+
+	std::vector<float> basisU(m_DegreeU + 1), reducedBasisU(m_DegreeU);
+	std::vector<float> basisV(m_DegreeV + 1), reducedBasisV(m_DegreeV);
+
+	for (uint32_t sampleU = rowBegin; sampleU < rowEnd; sampleU++)
+	{
+		const float u = BernsteinBasis::SampleParameter(sampleU, m_ResolutionU);
+
+		kernelU.basis(m_DegreeU, u, basisU.data());
+
+		if (target.normals && m_DegreeU > 0)
+			reducedKernelU.basis(m_DegreeU - 1, u, reducedBasisU.data());
+
+		for (uint32_t sampleV = target.window.firstSampleV; sampleV < target.window.endSampleV(); sampleV++)
+		{
+			const float v = BernsteinBasis::SampleParameter(sampleV, m_ResolutionV);
+			const size_t index = target.window.index(sampleU, sampleV);
+
+			kernelV.basis(m_DegreeV, v, basisV.data());
+			target.position(index) = ContractNet(m_ControlPoints.data(), m_DegreeU, m_DegreeV, basisU.data(), basisV.data(), specialized);
+
+			if (target.normals)
+			{
+				if (m_DegreeV > 0)
+					reducedKernelV.basis(m_DegreeV - 1, v, reducedBasisV.data());
+
+				const TangentFrame tangents = {
+					m_DegreeU > 0 ? ContractNet(m_DerivativeNetU.data(), m_DegreeU - 1, m_DegreeV, reducedBasisU.data(), basisV.data(), specialized) : glm::vec3{ 0.f, 0.f, 0.f },
+					m_DegreeV > 0 ? ContractNet(m_DerivativeNetV.data(), m_DegreeU, m_DegreeV - 1, basisU.data(), reducedBasisV.data(), specialized) : glm::vec3{ 0.f, 0.f, 0.f }
+				};
+				target.normal(index) = SurfaceNormal(tangents.u, tangents.v);
+
+				if (target.tangents)
+					target.tangents[index] = tangents;
+			}
+		}
+	}
+}
+
+void Bezier::evaluateRowsBatched(const SampleTarget& target, SimdLevel simdLevel, uint32_t rowBegin, uint32_t rowEnd) const
+{
+	const uint32_t firstSampleV = target.window.firstSampleV;
+	const uint32_t sampleCountV = target.window.sampleCountV;
+
+	std::vector<float> u(sampleCountV), v(sampleCountV);
+	std::vector<glm::vec3> tangentsU(target.normals ? sampleCountV : 0), tangentsV(target.normals ? sampleCountV : 0);
+
+	for (uint32_t column = 0; column < sampleCountV; column++)
+		v[column] = BernsteinBasis::SampleParameter(firstSampleV + column, m_ResolutionV);
+
+	for (uint32_t sampleU = rowBegin; sampleU < rowEnd; sampleU++)
+	{
+		std::fill(u.begin(), u.end(), BernsteinBasis::SampleParameter(sampleU, m_ResolutionU));
+
+		const size_t rowOffset = target.window.index(sampleU, firstSampleV);
+
+		SimdDeCasteljau::EvaluateSurface(simdLevel, m_DegreeU, m_DegreeV, m_SoaControlPoints, u.data(), v.data(), sampleCountV,
+			&target.position(rowOffset), target.stride, target.normals ? tangentsU.data() : nullptr, target.normals ? tangentsV.data() : nullptr, sizeof(glm::vec3));
+
+		if (!target.normals)
+			continue;
+
+		for (uint32_t column = 0; column < sampleCountV; column++)
+		{
+			target.normal(rowOffset + column) = SurfaceNormal(tangentsU[column], tangentsV[column]);
+
+			if (target.tangents)
+				target.tangents[rowOffset + column] = { tangentsU[column], tangentsV[column] };
+		}
+	}
+}
+
+void Bezier::evaluateRowsSeparable(const SampleTarget& target, EvaluationMode mode, uint32_t rowBegin, uint32_t rowEnd) const
+{
+	const uint32_t rowSize = m_DegreeV + 1;
+
+	const DegreeKernel& kernelU = DegreeKernels::Get(m_DegreeU, m_SpecializedKernels);
+	const DegreeKernel& kernelV = DegreeKernels::Get(m_DegreeV, m_SpecializedKernels);
+	const DegreeKernel& reducedKernelU = DegreeKernels::Get(m_DegreeU > 0 ? m_DegreeU - 1 : 0, m_SpecializedKernels);
+	const DegreeKernel& reducedKernelV = DegreeKernels::Get(m_DegreeV > 0 ? m_DegreeV - 1 : 0, m_SpecializedKernels);
+
+	// Control net contracted along U for the current row: a degree V curve
+	std::vector<glm::vec3> rowCurve(rowSize);
+	// Same for the dS/du net. dS/dv is the derivative of the row curve itself.
+	std::vector<glm::vec3> rowTangentU(target.normals ? rowSize : 0);
+	std::vector<glm::vec3> rowTangentV(target.normals ? m_DegreeV : 0);
+	// Partial derivatives of every sample of the current row
+	const uint32_t firstSampleV = target.window.firstSampleV;
+	const uint32_t sampleCountV = target.window.sampleCountV;
+	std::vector<glm::vec3> sampleTangentsU(target.normals ? sampleCountV : 0, glm::vec3{ 0.f, 0.f, 0.f });
+	std::vector<glm::vec3> sampleTangentsV(target.normals ? sampleCountV : 0, glm::vec3{ 0.f, 0.f, 0.f });
+
+	// Samples a row curve over the window, from the V basis table or with forward differences
+	auto sampleRow = [&](const DegreeKernel& kernel, uint32_t degree, bool reduced, const glm::vec3* curve, glm::vec3* out, size_t outStride)
+	{
+		if (mode == EvaluationMode::ForwardDifference)
+			ForwardDifferenceSamples(kernel, degree, curve, firstSampleV, sampleCountV, m_ResolutionV, m_AnchorInterval, out, outStride);
+		else
+			kernel.contractSamples(degree, reduced ? m_BasisV->getReducedValues(firstSampleV) : m_BasisV->getValues(firstSampleV), curve, sampleCountV, out, outStride);
+	};
+
+	for (uint32_t sampleU = rowBegin; sampleU < rowEnd; sampleU++)
+	{
+		const float* basisU = m_BasisU->getValues(sampleU);
+
+		for (uint32_t j = 0; j < rowSize; j++)
+			rowCurve[j] = kernelU.contract(m_DegreeU, basisU, m_ControlPoints.data() + j, rowSize);
+
+		const size_t rowOffset = target.window.index(sampleU, firstSampleV);
+
+		sampleRow(kernelV, m_DegreeV, false, rowCurve.data(), &target.position(rowOffset), target.stride);
+
+		if (!target.normals)
+			continue;
+
+		if (m_DegreeU > 0)
+		{
+			const float* reducedBasisU = m_BasisU->getReducedValues(sampleU);
+
+			for (uint32_t j = 0; j < rowSize; j++)
+				rowTangentU[j] = reducedKernelU.contract(m_DegreeU - 1, reducedBasisU, m_DerivativeNetU.data() + j, rowSize);
+
+			sampleRow(kernelV, m_DegreeV, false, rowTangentU.data(), sampleTangentsU.data(), sizeof(glm::vec3));
+		}
+
+		if (m_DegreeV > 0)
+		{
+			for (uint32_t j = 0; j < m_DegreeV; j++)
+				rowTangentV[j] = static_cast<float>(m_DegreeV) * (rowCurve[j + 1] - rowCurve[j]);
+
+			sampleRow(reducedKernelV, m_DegreeV - 1, true, rowTangentV.data(), sampleTangentsV.data(), sizeof(glm::vec3));
+		}
+
+		for (uint32_t column = 0; column < sampleCountV; column++)
+		{
+			target.normal(rowOffset + column) = SurfaceNormal(sampleTangentsU[column], sampleTangentsV[column]);
+
+			if (target.tangents)
+				target.tangents[rowOffset + column] = { sampleTangentsU[column], sampleTangentsV[column] };
+		}
+	}
+}
+
+void Bezier::ForwardDifferenceSamples(const DegreeKernel& kernel, uint32_t degree, const glm::vec3* points, uint32_t firstSample, uint32_t sampleCount, uint32_t resolution, uint32_t anchorInterval, glm::vec3* out, size_t outStride)
+{
+	// k! * S(j, k) with S the Stirling numbers of the second kind: the k-th forward difference of x^j at 0 with a unit step
+	static constexpr std::array<double, (PascalTriangle::MaxDegree + 1) * (PascalTriangle::MaxDegree + 1)> s_Surjections = []()
+	{
+		constexpr size_t size = PascalTriangle::MaxDegree + 1;
+		std::array<double, size * size> surjections{};
+		surjections[0] = 1.0;
+
+		for (size_t j = 1; j < size; j++)
+			for (size_t k = 1; k <= j; k++)
+				surjections[j * size + k] = static_cast<double>(k) * (surjections[(j - 1) * size + k] + surjections[(j - 1) * size + k - 1]);
+
+		return surjections;
+	}();
+
+	// Power basis coefficients, lowest power first. The conversion alternates signs and cancels a lot, hence doubles.
+	std::array<glm::dvec3, PascalTriangle::MaxDegree + 1> coefficients, local;
+	// x, y, z of the difference of order k at 3 * k
+	std::array<double, 3 * (PascalTriangle::MaxDegree + 1)> differences;
+
+	for (uint32_t j = 0; j <= degree; j++)
+	{
+		glm::dvec3 sum{ 0.0, 0.0, 0.0 };
+
+		for (uint32_t i = 0; i <= j; i++)
+		{
+			const double binomial = static_cast<double>(PascalTriangle::Binomial(j, i));
+			sum += ((j - i) % 2 == 0 ? binomial : -binomial) * glm::dvec3(points[i]);
+		}
+
+		coefficients[j] = static_cast<double>(PascalTriangle::Binomial(degree, j)) * sum;
+	}
+
+	const double step = 1.0 / static_cast<double>(resolution);
+
+	for (uint32_t anchor = 0; anchor < sampleCount; anchor += anchorInterval)
+	{
+		// Taylor shift to the anchor, scaled to one sample per unit: local[j] is the x^j coefficient of x -> curve(t0 + x * step).
+		// Differences taken from these coefficients stay accurate, unlike differences of sample values.
+		const double t0 = static_cast<double>(firstSample + anchor) * step;
+		std::copy(coefficients.begin(), coefficients.begin() + degree + 1, local.begin());
+
+		for (uint32_t i = 0; i < degree; i++)
+			for (uint32_t j = degree; j-- > i;)
+				local[j] += t0 * local[j + 1];
+
+		double scale = 1.0;
+		for (uint32_t j = 0; j <= degree; j++, scale *= step)
+			local[j] *= scale;
+
+		for (uint32_t k = 0; k <= degree; k++)
+		{
+			glm::dvec3 difference{ 0.0, 0.0, 0.0 };
+
+			for (uint32_t j = k; j <= degree; j++)
+				difference += s_Surjections[j * (PascalTriangle::MaxDegree + 1) + k] * local[j];
+
+			differences[3 * k + 0] = difference.x;
+			differences[3 * k + 1] = difference.y;
+			differences[3 * k + 2] = difference.z;
+		}
+
+		const uint32_t stepCount = std::min(anchorInterval, sampleCount - anchor);
+
+		kernel.stepDifferences(degree, differences.data(), stepCount, out, outStride);
+		out = reinterpret_cast<glm::vec3*>(reinterpret_cast<std::byte*>(out) + stepCount * outStride);
+	}
 }
 
 glm::vec3 Bezier::computeBezier(float u, float v) const
+{
+	return EvaluateNet(m_ControlPoints, m_DegreeU, m_DegreeV, u, v);
+}
+
+glm::vec3 Bezier::EvaluateNet(const std::vector<glm::vec3>& net, uint32_t degreeU, uint32_t degreeV, float u, float v)
 {
 	glm::vec3 out = glm::vec3{ 0.0, 0.0, 0.0 };
 
-	for (uint32_t i = 0; i < (m_DegreeU + 1); i++)
+	for (uint32_t i = 0; i < (degreeU + 1); i++)
 	{
-		for (uint32_t j = 0; j < (m_DegreeV + 1); j++)
+		for (uint32_t j = 0; j < (degreeV + 1); j++)
 		{
-			out += Bernstein(m_DegreeU, i, u) * Bernstein(m_DegreeV, j, v) * getControlPoint(i, j);
+			out += Bernstein(degreeU, i, u) * Bernstein(degreeV, j, v) * net[static_cast<size_t>(i) * (degreeV + 1) + j];
 		}
 	}
 
 	return out;
 }
 
-uint32_t Bezier::Binomial(uint32_t n, uint32_t k)
+glm::vec3 Bezier::ContractNet(const glm::vec3* net, uint32_t degreeU, uint32_t degreeV, const float* basisU, const float* basisV, bool specialized)
 {
-	if (!s_Binomials.contains({ n, k }))
-		s_Binomials[{n, k}] = (Factorial(n) / Factorial(k) / Factorial(n - k));
+	std::array<glm::vec3, PascalTriangle::MaxDegree + 1> column;
+
+	const DegreeKernel& kernelV = DegreeKernels::Get(degreeV, specialized);
+	for (uint32_t i = 0; i < (degreeU + 1); i++)
+		column[i] = kernelV.contract(degreeV, basisV, net + static_cast<size_t>(i) * (degreeV + 1), 1);
 
-	return s_Binomials.at({ n, k });
+	return DegreeKernels::Get(degreeU, specialized).contract(degreeU, basisU, column.data(), 1);
 }
 
-uint32_t Bezier::Factorial(uint32_t n)
+glm::vec3 Bezier::SurfaceNormal(const glm::vec3& tangentU, const glm::vec3& tangentV)
 {
-	s_Factorials.reserve(static_cast<size_t>(n) + 1);
+	const glm::vec3 normal = glm::cross(tangentU, tangentV);
+	const float length = glm::length(normal);
 
-	for (; !(s_Factorials.size() > n);)
-		s_Factorials.push_back(s_Factorials.back() * static_cast<uint32_t>(s_Factorials.size()));
+	// Degenerate at collapsed control net corners, where a partial derivative vanishes
+	return length > 0.f ? normal / length : glm::vec3{ 0.f, 1.f, 0.f };
+}
 
-	return s_Factorials.at(n);
+uint64_t Bezier::Binomial(uint32_t n, uint32_t k)
+{
+	return PascalTriangle::Binomial(n, k);
 }
 
 float Bezier::Bernstein(uint32_t n, uint32_t k, float t)
@@ -0,0 +1,109 @@
+#include "BezierJobQueue.h"
+
+#include <algorithm>
+
+BezierJobQueue::BezierJobQueue()
+	: m_Worker([this](std::stop_token stopToken) { workerLoop(stopToken); })
+{
+}
+
+BezierJobQueue::~BezierJobQueue()
+{
+	// Makes a running job return early, m_Worker then stops and joins the worker
+	cancel();
+}
+
+uint64_t BezierJobQueue::submit(Bezier bezier, uint32_t refinementSteps)
+{
+	std::lock_guard lock(m_Mutex);
+
+	m_JobStopSource.request_stop();
+	m_JobStopSource = {};
+
+	m_PendingJob = Job{ std::move(bezier), ++m_LastJobId, std::chrono::steady_clock::now(), refinementSteps };
+	m_JobAvailable.notify_one();
+
+	return m_LastJobId;
+}
+
+void BezierJobQueue::cancel()
+{
+	std::lock_guard lock(m_Mutex);
+
+	m_JobStopSource.request_stop();
+	m_PendingJob.reset();
+	m_Result.reset();
+}
+
+std::optional<BezierJobQueue::Result> BezierJobQueue::takeResult()
+{
+	std::lock_guard lock(m_Mutex);
+
+	std::optional<Result> result = std::move(m_Result);
+	m_Result.reset();
+
+	return result;
+}
+
+uint64_t BezierJobQueue::getLastJobId() const
+{
+	std::lock_guard lock(m_Mutex);
+	return m_LastJobId;
+}
+
+uint32_t BezierJobQueue::RefinedResolution(uint32_t resolution, uint32_t refinementStepsLeft)
+{
+	if (refinementStepsLeft >= 32)
+		return std::min(resolution, 2u);
+
+	return std::max(resolution >> refinementStepsLeft, std::min(resolution, 2u));
+}
+
+void BezierJobQueue::workerLoop(std::stop_token stopToken)
+{
+	while (true)
+	{
+		std::optional<Job> job;
+		std::stop_token jobStopToken;
+
+		{
+			std::unique_lock lock(m_Mutex);
+
+			if (!m_JobAvailable.wait(lock, stopToken, [this]() { return m_PendingJob.has_value(); }))
+				return;
+
+			job = std::move(m_PendingJob);
+			m_PendingJob.reset();
+			jobStopToken = m_JobStopSource.get_token();
+		}
+
+		// Coarsest level first, the full resolution being the job's surface itself
+		for (uint32_t stepsLeft = job->refinementSteps; !jobStopToken.stop_requested(); stepsLeft--)
+		{
+			Bezier level = stepsLeft > 0 ? job->bezier : std::move(job->bezier);
+			if (stepsLeft > 0)
+				level.setResolution(RefinedResolution(job->bezier.getResolutionU(), stepsLeft), RefinedResolution(job->bezier.getResolutionV(), stepsLeft));
+
+			std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+			level.polygonize(jobStopToken);
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+			std::lock_guard lock(m_Mutex);
+
+			// Stops are requested under the lock, so a result kept here was not superseded
+			if (jobStopToken.stop_requested())
+				break;
+
+			m_Result = Result{
+				std::move(level),
+				job->id,
+				job->submitTime,
+				std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f,
+				stepsLeft
+			};
+
+			if (stepsLeft == 0)
+				break;
+		}
+	}
+}
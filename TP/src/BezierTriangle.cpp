@@ -0,0 +1,267 @@
+#include "BezierTriangle.h"
+
+#include <Vroom/Core/Assert.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "WorkerPool.h"
+
+BezierTriangle::BezierTriangle(uint32_t degree, uint32_t level)
+	: m_Degree(degree), m_Level(level)
+{
+	VRM_ASSERT_MSG(degree >= 1, "Triangular patches need a degree of at least 1.");
+
+	m_ControlPoints.assign(BarycentricBasis::PointCount(degree), glm::vec3());
+}
+
+void BezierTriangle::setControlPoint(uint32_t i, uint32_t j, const glm::vec3& p)
+{
+	VRM_ASSERT_MSG(i + j <= m_Degree, "Point ({}, {}) is outside of a degree {} net.", i, j, m_Degree);
+
+	m_ControlPoints[BarycentricBasis::Index(m_Degree, i, j)] = p;
+
+	m_NetsUpToDate = false;
+	m_NeedsCompute = true;
+}
+
+void BezierTriangle::setLevel(uint32_t level)
+{
+	m_Level = level;
+
+	m_NeedsCompute = true;
+}
+
+void BezierTriangle::setThreadCount(uint32_t threadCount)
+{
+	m_ThreadCount = threadCount;
+}
+
+const glm::vec3& BezierTriangle::getControlPoint(uint32_t i, uint32_t j) const
+{
+	VRM_ASSERT_MSG(i + j <= m_Degree, "Point ({}, {}) is outside of a degree {} net.", i, j, m_Degree);
+
+	return m_ControlPoints[BarycentricBasis::Index(m_Degree, i, j)];
+}
+
+uint32_t BezierTriangle::getThreadCount() const
+{
+	return m_ThreadCount == 0 ? WorkerPool::HardwareThreadCount() : m_ThreadCount;
+}
+
+glm::vec3 BezierTriangle::evaluate(float u, float v) const
+{
+	glm::vec3 last[3];
+	deCasteljau(u, v, last);
+
+	return u * last[0] + v * last[1] + (1.f - u - v) * last[2];
+}
+
+const vrm::MeshData& BezierTriangle::polygonize() const
+{
+	if (!m_NeedsCompute)
+		return m_PolygonizedCache;
+
+	// Shared state is prepared here, the rows then only read it
+	updateBasis();
+	updateNets();
+
+	std::vector<vrm::Vertex> vertices(getSampleCount());
+
+	// Rows shrink along u: blocks take every blockCount-th row so that they get the same share of samples
+	const uint32_t rowCount = m_Level > 0 ? m_Level + 1 : 0;
+	const uint32_t threadCount = getThreadCount();
+	const uint32_t blockCount = std::min(rowCount, threadCount * 4);
+
+	WorkerPool::Get().parallelFor(blockCount, threadCount, [&](uint32_t block)
+	{
+		for (uint32_t row = block; row < rowCount; row += blockCount)
+			evaluateRow(vertices.data(), row);
+	});
+
+	// Between rows a and a + 1: a triangle on every edge of row a, and one between every two of them, counter-clockwise in (u, v) like Bezier
+	std::vector<uint32_t> indices(static_cast<size_t>(m_Level) * m_Level * 3);
+	size_t offset = 0;
+
+	for (uint32_t row = 0; row < m_Level; row++)
+	{
+		const uint32_t rowA = static_cast<uint32_t>(BarycentricBasis::Index(m_Level, row, 0));
+		const uint32_t rowB = static_cast<uint32_t>(BarycentricBasis::Index(m_Level, row + 1, 0));
+		const uint32_t columnCount = m_Level - row;
+
+		for (uint32_t column = 0; column < columnCount; column++)
+		{
+			indices[offset++] = rowA + column;
+			indices[offset++] = rowB + column;
+			indices[offset++] = rowA + column + 1;
+
+			if (column + 1 < columnCount)
+			{
+				indices[offset++] = rowA + column + 1;
+				indices[offset++] = rowB + column;
+				indices[offset++] = rowB + column + 1;
+			}
+		}
+	}
+
+	m_PolygonizedCache = vrm::MeshData(std::move(vertices), std::move(indices));
+	m_NeedsCompute = false;
+
+	return m_PolygonizedCache;
+}
+
+Bezier::EvaluationError BezierTriangle::measureEvaluationError() const
+{
+	Bezier::EvaluationError error;
+
+	if (m_Level == 0)
+		return error;
+
+	const vrm::MeshData& mesh = polygonize();
+	double squaredErrorSum = 0.0;
+	float minNormalCosine = 1.f;
+
+	for (uint32_t row = 0; row <= m_Level; row++)
+	{
+		for (uint32_t column = 0; row + column <= m_Level; column++)
+		{
+			const vrm::Vertex& vertex = mesh.getVertices()[BarycentricBasis::Index(m_Level, row, column)];
+			const float u = vertex.texCoords.x, v = vertex.texCoords.y;
+
+			glm::vec3 last[3];
+			deCasteljau(u, v, last);
+
+			const float positionError = glm::length(vertex.position - (u * last[0] + v * last[1] + (1.f - u - v) * last[2]));
+			error.maxPositionError = std::max(error.maxPositionError, positionError);
+			squaredErrorSum += static_cast<double>(positionError) * positionError;
+
+			const glm::vec3 normal = glm::cross(last[0] - last[2], last[1] - last[2]);
+			if (glm::length(normal) > 0.f)
+				minNormalCosine = std::min(minNormalCosine, glm::dot(vertex.normal, glm::normalize(normal)));
+		}
+	}
+
+	error.rmsPositionError = static_cast<float>(std::sqrt(squaredErrorSum / static_cast<double>(getSampleCount())));
+	error.maxNormalAngle = glm::degrees(std::acos(std::clamp(minNormalCosine, -1.f, 1.f)));
+
+	return error;
+}
+
+void BezierTriangle::updateBasis() const
+{
+	if (!m_Basis.matches(m_Degree, m_Level))
+		m_Basis = BarycentricBasis(m_Degree, m_Level);
+}
+
+void BezierTriangle::updateNets() const
+{
+	if (m_NetsUpToDate)
+		return;
+
+	m_PositionNet.resize(m_ControlPoints.size());
+
+	for (uint32_t i = 0; i <= m_Degree; i++)
+		for (uint32_t j = 0; i + j <= m_Degree; j++)
+			m_PositionNet[BarycentricBasis::Index(m_Degree, i, j)] = BarycentricBasis::Multinomial(m_Degree, i, j) * m_ControlPoints[BarycentricBasis::Index(m_Degree, i, j)];
+
+	// dS/du = n sum B(n - 1, i, j, k) (P(i + 1, j, k) - P(i, j, k + 1)), and the same along v, w = 1 - u - v taking up the other side
+	const uint32_t reduced = m_Degree - 1;
+	m_TangentNetU.resize(BarycentricBasis::PointCount(reduced));
+	m_TangentNetV.resize(BarycentricBasis::PointCount(reduced));
+
+	for (uint32_t i = 0; i <= reduced; i++)
+	{
+		for (uint32_t j = 0; i + j <= reduced; j++)
+		{
+			const float weight = static_cast<float>(m_Degree) * BarycentricBasis::Multinomial(reduced, i, j);
+			const glm::vec3& p = m_ControlPoints[BarycentricBasis::Index(m_Degree, i, j)];
+
+			m_TangentNetU[BarycentricBasis::Index(reduced, i, j)] = weight * (m_ControlPoints[BarycentricBasis::Index(m_Degree, i + 1, j)] - p);
+			m_TangentNetV[BarycentricBasis::Index(reduced, i, j)] = weight * (m_ControlPoints[BarycentricBasis::Index(m_Degree, i, j + 1)] - p);
+		}
+	}
+
+	m_NetsUpToDate = true;
+}
+
+void BezierTriangle::evaluateRow(vrm::Vertex* vertices, uint32_t row) const
+{
+	const uint32_t n = m_Degree;
+	const float* powersU = m_Basis.getPowers(row);
+
+	// The nets weighted by u^i, which stays the same along the row
+	std::vector<glm::vec3> positionRow(m_PositionNet.size()), tangentRowU(m_TangentNetU.size()), tangentRowV(m_TangentNetV.size());
+
+	for (uint32_t i = 0; i <= n; i++)
+	{
+		for (uint32_t j = 0; i + j <= n; j++)
+		{
+			const size_t index = BarycentricBasis::Index(n, i, j);
+			positionRow[index] = powersU[i] * m_PositionNet[index];
+		}
+	}
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		for (uint32_t j = 0; i + j < n; j++)
+		{
+			const size_t index = BarycentricBasis::Index(n - 1, i, j);
+			tangentRowU[index] = powersU[i] * m_TangentNetU[index];
+			tangentRowV[index] = powersU[i] * m_TangentNetV[index];
+		}
+	}
+
+	vrm::Vertex* rowVertices = vertices + BarycentricBasis::Index(m_Level, row, 0);
+
+	for (uint32_t column = 0; row + column <= m_Level; column++)
+	{
+		const float* powersV = m_Basis.getPowers(column);
+		const float* powersW = m_Basis.getPowers(m_Level - row - column);
+
+		glm::vec3 position(0.f), tangentU(0.f), tangentV(0.f);
+
+		for (uint32_t i = 0; i <= n; i++)
+		{
+			const glm::vec3* points = positionRow.data() + BarycentricBasis::Index(n, i, 0);
+
+			for (uint32_t j = 0; i + j <= n; j++)
+				position += (powersV[j] * powersW[n - i - j]) * points[j];
+		}
+
+		for (uint32_t i = 0; i < n; i++)
+		{
+			const size_t first = BarycentricBasis::Index(n - 1, i, 0);
+
+			for (uint32_t j = 0; i + j < n; j++)
+			{
+				const float weight = powersV[j] * powersW[n - 1 - i - j];
+				tangentU += weight * tangentRowU[first + j];
+				tangentV += weight * tangentRowV[first + j];
+			}
+		}
+
+		const glm::vec3 normal = glm::cross(tangentU, tangentV);
+		const float length = glm::length(normal);
+
+		vrm::Vertex& vertex = rowVertices[column];
+		vertex.position = position;
+		vertex.normal = length > 0.f ? normal / length : glm::vec3{ 0.f, 1.f, 0.f };
+		vertex.texCoords = { static_cast<float>(row) / static_cast<float>(m_Level), static_cast<float>(column) / static_cast<float>(m_Level) };
+	}
+}
+
+void BezierTriangle::deCasteljau(float u, float v, glm::vec3 out[3]) const
+{
+	const float w = 1.f - u - v;
+	std::vector<glm::vec3> points = m_ControlPoints;
+
+	// Degree r - 1 from degree r, in place: targets go upwards and only read higher indices
+	for (uint32_t r = m_Degree; r > 1; r--)
+		for (uint32_t i = 0; i < r; i++)
+			for (uint32_t j = 0; i + j < r; j++)
+				points[BarycentricBasis::Index(r - 1, i, j)] = u * points[BarycentricBasis::Index(r, i + 1, j)] + v * points[BarycentricBasis::Index(r, i, j + 1)] + w * points[BarycentricBasis::Index(r, i, j)];
+
+	out[0] = points[BarycentricBasis::Index(1, 1, 0)];
+	out[1] = points[BarycentricBasis::Index(1, 0, 1)];
+	out[2] = points[BarycentricBasis::Index(1, 0, 0)];
+}
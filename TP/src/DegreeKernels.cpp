@@ -0,0 +1,65 @@
+#include "DegreeKernels.h"
+
+#include "BernsteinBasis.h"
+
+template <size_t... Degrees>
+static constexpr std::array<DegreeKernel, sizeof...(Degrees)> MakeKernelTable(std::index_sequence<Degrees...>)
+{
+	return { DegreeKernel{
+		&SpecializedKernel<Degrees>::Basis,
+		&SpecializedKernel<Degrees>::Contract,
+		&SpecializedKernel<Degrees>::ContractSamples,
+		&SpecializedKernel<Degrees>::StepDifferences,
+		true
+	}... };
+}
+
+static constexpr auto s_SpecializedKernels = MakeKernelTable(std::make_index_sequence<DegreeKernels::MaxSpecializedDegree + 1>{});
+
+const DegreeKernel& DegreeKernels::Get(uint32_t degree, bool allowSpecialized)
+{
+	static constexpr DegreeKernel genericKernel = { &GenericBasis, &GenericContract, &GenericContractSamples, &GenericStepDifferences, false };
+
+	if (allowSpecialized && IsSpecialized(degree))
+		return s_SpecializedKernels[degree];
+
+	return genericKernel;
+}
+
+void DegreeKernels::GenericBasis(uint32_t degree, float t, float* out)
+{
+	BernsteinBasis::Evaluate(degree, t, out);
+}
+
+glm::vec3 DegreeKernels::GenericContract(uint32_t degree, const float* weights, const glm::vec3* points, size_t stride)
+{
+	glm::vec3 out = glm::vec3{ 0.f, 0.f, 0.f };
+
+	for (uint32_t k = 0; k < (degree + 1); k++)
+		out += weights[k] * points[k * stride];
+
+	return out;
+}
+
+void DegreeKernels::GenericContractSamples(uint32_t degree, const float* weights, const glm::vec3* points, uint32_t sampleCount, glm::vec3* out, size_t outStride)
+{
+	for (uint32_t sample = 0; sample < sampleCount; sample++)
+	{
+		*out = GenericContract(degree, weights + static_cast<size_t>(sample) * (degree + 1), points, 1);
+		out = reinterpret_cast<glm::vec3*>(reinterpret_cast<std::byte*>(out) + outStride);
+	}
+}
+
+void DegreeKernels::GenericStepDifferences(uint32_t degree, double* differences, uint32_t sampleCount, glm::vec3* out, size_t outStride)
+{
+	const uint32_t steppedCount = 3 * degree;
+
+	for (uint32_t sample = 0; sample < sampleCount; sample++)
+	{
+		*out = glm::vec3{ static_cast<float>(differences[0]), static_cast<float>(differences[1]), static_cast<float>(differences[2]) };
+		out = reinterpret_cast<glm::vec3*>(reinterpret_cast<std::byte*>(out) + outStride);
+
+		for (uint32_t i = 0; i < steppedCount; i++)
+			differences[i] += differences[i + 3];
+	}
+}
@@ -13,6 +13,27 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include "imgui.h"
+#include "BasisCache.h"
+#include "DegreeKernels.h"
+#include "WorkerPool.h"
+
+// Uploads every streamed tile to its own submesh
+class SubmeshTileSink : public Bezier::TileSink
+{
+public:
+    explicit SubmeshTileSink(vrm::MeshAsset& meshAsset)
+        : m_MeshAsset(meshAsset)
+    {
+    }
+
+    void onTile(const Bezier::Tile&, vrm::MeshData&& mesh) override
+    {
+        m_MeshAsset.addSubmesh(std::move(mesh));
+    }
+
+private:
+    vrm::MeshAsset& m_MeshAsset;
+};
 
 MyScene::MyScene()
     : vrm::Scene(), m_Camera(0.1f, 100.f, glm::radians(90.f), 600.f / 400.f, { 0.5f, 10.f, 20.f }, { glm::radians(45.f), 0.f, 0.f }),
@@ -65,7 +86,15 @@ void MyScene::onInit()
 
     /* Visualization */
 
-    computeBezier();
+    // Surfaces keep their own mesh when they patch it, the GPU copy is all the assets need
+    m_MeshAsset.setKeepMeshData(false);
+    m_PatchMeshAsset.setKeepMeshData(false);
+
+    // Imported meshes never change, so they are optimized once and cached that way
+    vrm::MeshAsset::SetOptimizeMeshesByDefault(true);
+
+    // The mesh asset needs a submesh before its first instance is created
+    showBezier(makeBezier());
 
     auto meshEntity = createEntity("Mesh");
     meshEntity.addComponent<vrm::MeshComponent>(m_MeshAsset.createInstance());
@@ -84,6 +113,9 @@ void MyScene::onEnd()
 
 void MyScene::onUpdate(float dt)
 {
+    /* Surface */
+    showFinishedJob();
+
     /* Camera */
     if (m_ControlsEnabled && m_MouseLock)
     {
@@ -124,6 +156,21 @@ void MyScene::onImGui()
 
     ImGui::Begin("Tweaks");
         ImGui::Checkbox("Real-time computing", &m_RealTimeComputing);
+        ImGui::Checkbox("Asynchronous computing", &m_AsyncComputing);
+        ImGui::Checkbox("Progressive refinement", &m_ProgressiveRefinement);
+        if (m_ProgressiveRefinement)
+        {
+            ImGui::TextWrapped("Preview budget (ms)");
+            ImGui::SliderFloat("##Preview budget", &m_FrameBudgetMs, 1.f, 100.f, "%.1f", ImGuiSliderFlags_Logarithmic);
+        }
+        if (ImGui::Checkbox("Stream tiles", &m_StreamTiles) && m_RealTimeComputing)
+            computeBezier();
+        if (m_StreamTiles)
+        {
+            ImGui::TextWrapped("Tile size (samples)");
+            if (ImGui::SliderInt("##Tile size", &m_TileSize, 2, 1024, "%d", ImGuiSliderFlags_Logarithmic) && m_RealTimeComputing)
+                computeBezier();
+        }
         if (ImGui::Checkbox("Show control points", &m_ShowControlPoints))
             updateControlPoints();
         ImGui::TextWrapped("Degrees");
@@ -135,25 +182,188 @@ void MyScene::onImGui()
         ImGui::TextWrapped("Patch sizes");
         if (ImGui::SliderFloat3("##Patch sizes", m_BezierParams.patchSizes, 1.f, 1000.f, "%.1f", ImGuiSliderFlags_Logarithmic) && m_RealTimeComputing)
             computeBezier();
+        ImGui::TextWrapped("Evaluation");
+        if (ImGui::Combo("##Evaluation", &m_BezierParams.evaluationMode, "Direct\0Separable\0Forward difference\0") && m_RealTimeComputing)
+            computeBezier();
+        if (m_BezierParams.evaluationMode == static_cast<int>(Bezier::EvaluationMode::ForwardDifference))
+        {
+            ImGui::TextWrapped("Anchor interval (samples)");
+            if (ImGui::SliderInt("##Anchor interval", &m_BezierParams.anchorInterval, 1, 10000, "%d", ImGuiSliderFlags_Logarithmic) && m_RealTimeComputing)
+                computeBezier();
+        }
+        if (m_BezierParams.evaluationMode == static_cast<int>(Bezier::EvaluationMode::Direct) || m_BezierParams.tessellationMode == static_cast<int>(Bezier::TessellationMode::Adaptive))
+        {
+            ImGui::TextWrapped("SIMD (best: %s)", SimdDeCasteljau::LevelName(SimdDeCasteljau::BestLevel()));
+            if (ImGui::Combo("##SIMD", &m_BezierParams.simdLevel, "Scalar\0AVX2\0AVX-512\0"))
+            {
+                m_BezierParams.simdLevel = std::min(m_BezierParams.simdLevel, static_cast<int>(SimdDeCasteljau::BestLevel()));
+                if (m_RealTimeComputing)
+                    computeBezier();
+            }
+        }
+        ImGui::TextWrapped("Mesh layout");
+        if (ImGui::Combo("##Mesh layout", &m_BezierParams.meshLayout, "Flat shaded\0Indexed grid\0") && m_RealTimeComputing)
+            computeBezier();
+        if (m_BezierParams.meshLayout == static_cast<int>(Bezier::MeshLayout::IndexedGrid))
+        {
+            // Coarser levels share the vertices of the grid, the renderer picks one from the size on screen
+            ImGui::TextWrapped("LOD levels");
+            if (ImGui::SliderInt("##LOD levels", &m_BezierParams.lodLevelCount, 0, 8) && m_RealTimeComputing)
+                computeBezier();
+            ImGui::TextWrapped("Primitives");
+            if (ImGui::Combo("##Primitives", &m_BezierParams.primitiveType, "Triangles\0Triangle strips\0") && m_RealTimeComputing)
+                computeBezier();
+        }
+        ImGui::TextWrapped("Normals");
+        if (ImGui::Combo("##Normals", &m_BezierParams.normalMode, "Finite difference\0Analytic\0") && m_RealTimeComputing)
+            computeBezier();
+        ImGui::TextWrapped("Threads (0 for all)");
+        if (ImGui::SliderInt("##Threads", &m_BezierParams.threadCount, 0, static_cast<int>(WorkerPool::HardwareThreadCount())) && m_RealTimeComputing)
+            computeBezier();
+        ImGui::TextWrapped("Tessellation");
+        if (ImGui::Combo("##Tessellation", &m_BezierParams.tessellationMode, "Uniform\0Adaptive\0") && m_RealTimeComputing)
+            computeBezier();
+        if (m_BezierParams.tessellationMode == static_cast<int>(Bezier::TessellationMode::Adaptive))
+        {
+            ImGui::TextWrapped("Flatness tolerance");
+            if (ImGui::SliderFloat("##Flatness tolerance", &m_BezierParams.flatnessTolerance, 0.0001f, 1.f, "%.4f", ImGuiSliderFlags_Logarithmic) && m_RealTimeComputing)
+                computeBezier();
+            ImGui::TextWrapped("Max subdivision depth");
+            if (ImGui::SliderInt("##Max subdivision depth", &m_BezierParams.maxSubdivisionDepth, 0, static_cast<int>(AdaptiveTessellator::MaxDepth)) && m_RealTimeComputing)
+                computeBezier();
+        }
         if (ImGui::Button("Compute Bezier"))
             computeBezier();
-        if (ImGui::Button("Begin profiling session"))
-            profile();
+        if (ImGui::Checkbox("Incremental control point updates", &m_IncrementalUpdates))
+        {
+            m_Bezier.setIncrementalUpdates(m_IncrementalUpdates);
+
+            // Patched ranges need the vertex order of the surface, which the optimizer only keeps for them
+            if (m_OptimizeMeshes)
+                computeBezier();
+        }
+        if (ImGui::Checkbox("Optimize meshes", &m_OptimizeMeshes))
+        {
+            computeBezier();
+            if (m_ShowPatchSurface)
+                computePatchSurface();
+        }
+        ImGui::TextWrapped("Edited control point");
+        if (ImGui::SliderInt2("##Edited control point", m_EditedControlPoint, 0, 20, "%d"))
+        {
+            m_EditedControlPoint[0] = std::min(m_EditedControlPoint[0], static_cast<int>(m_Bezier.getDegreeU()));
+            m_EditedControlPoint[1] = std::min(m_EditedControlPoint[1], static_cast<int>(m_Bezier.getDegreeV()));
+        }
+        {
+            const uint32_t u = static_cast<uint32_t>(m_EditedControlPoint[0]);
+            const uint32_t v = static_cast<uint32_t>(m_EditedControlPoint[1]);
+            glm::vec3 p = m_Bezier.getControlPoint(u, v);
+            if (ImGui::DragFloat3("##Control point position", &p.x, 0.01f))
+                moveControlPoint(u, v, p);
+        }
+        if (ImGui::Button("Benchmark degree kernels"))
+            benchmarkKernels();
+        if (ImGui::Button("Measure evaluation error"))
+            measureEvaluationError();
     ImGui::End();
 
+    onPatchSurfaceImGui();
+
     ImGui::Begin("Stats");
         ImGui::TextWrapped("FPS: %.2f", ImGui::GetIO().Framerate);
-        ImGui::TextWrapped("Vertices: %lu", m_MeshAsset.getSubMeshes().back().meshData.getVertexCount());
-        ImGui::TextWrapped("Triangles: %lu", m_MeshAsset.getSubMeshes().back().meshData.getTriangleCount());
+        {
+            size_t vertexCount = 0, triangleCount = 0, indexBytes = 0;
+            for (const auto& submesh : m_MeshAsset.getSubMeshes())
+            {
+                vertexCount += submesh.meshData.getVertexCount();
+                triangleCount += submesh.meshData.getTriangleCount();
+                indexBytes += submesh.meshData.getIndexCount() * (submesh.meshData.getIndexFormat() == vrm::MeshData::IndexFormat::UInt16 ? 2 : 4);
+            }
+            ImGui::TextWrapped("Vertices: %lu", vertexCount);
+            ImGui::TextWrapped("Triangles: %lu", triangleCount);
+            ImGui::TextWrapped("Indices: %.2f MiB", indexBytes / (1024.f * 1024.f));
+            ImGui::TextWrapped("Submeshes: %lu, in %lu buffer pairs", m_MeshAsset.getSubMeshes().size(), m_MeshAsset.getRenderMeshCount());
+            if (!m_MeshAsset.getSubMeshes().empty())
+                ImGui::TextWrapped("LOD levels: %lu", m_MeshAsset.getSubMeshes().front().meshData.getLodCount());
+            if (m_OptimizeMeshes)
+            {
+                // Post-transform cache of 16 vertices, strips are left as they are
+                const vrm::MeshOptimizer::Report& report = m_MeshAsset.getOptimizationReport();
+                ImGui::TextWrapped("ACMR: %.3f -> %.3f", report.before.getAcmr(), report.after.getAcmr());
+                ImGui::TextWrapped("ATVR: %.3f -> %.3f", report.before.getAtvr(), report.after.getAtvr());
+            }
+        }
         ImGui::TextWrapped("Last compute time: %.3f s", m_LastComputeTimeSeconds);
+        ImGui::TextWrapped("Last job latency: %.3f s", m_LastJobLatencySeconds);
+        ImGui::TextWrapped("Evaluation error: max %.2e, rms %.2e, normals %.3f deg", m_LastEvaluationError.maxPositionError, m_LastEvaluationError.rmsPositionError, m_LastEvaluationError.maxNormalAngle);
+        if (m_RefinementStepsLeft > 0)
+            ImGui::TextWrapped("Surface: refining, %u doublings left", m_RefinementStepsLeft);
+        else
+            ImGui::TextWrapped(m_DisplayedJobId == m_BezierJobs.getLastJobId() ? "Surface: up to date" : "Surface: stale, computing");
+        if (m_Bezier.getTessellationMode() == Bezier::TessellationMode::Adaptive)
+        {
+            const AdaptiveTessellator::Stats& stats = m_Bezier.getAdaptiveStats();
+            ImGui::TextWrapped("Adaptive patches: %lu, depth %u", stats.patchCount, stats.depth);
+            ImGui::TextWrapped("Uniform grid at that depth: %lu triangles", stats.uniformTriangleCount);
+            ImGui::TextWrapped("Triangles saved: %.1f%%", stats.uniformTriangleCount > 0 ? 100.f * (1.f - static_cast<float>(stats.triangleCount) / static_cast<float>(stats.uniformTriangleCount)) : 0.f);
+        }
+        {
+            // Every compute builds a new surface, the basis tables come from the cache
+            const BasisCache::Stats stats = BasisCache::Get().getStats();
+            ImGui::TextWrapped("Basis cache: %lu hits, %lu misses, %lu evictions", stats.hits, stats.misses, stats.evictions);
+            ImGui::TextWrapped("Basis cache size: %lu tables, %.2f MiB", stats.entryCount, stats.byteSize / (1024.f * 1024.f));
+        }
     ImGui::End();
 }
 
 void MyScene::computeBezier()
 {
+    // Adaptive tessellation does not depend on the resolution, there is nothing to refine
+    if (m_ProgressiveRefinement && !m_StreamTiles && m_BezierParams.tessellationMode == static_cast<int>(Bezier::TessellationMode::Uniform))
+    {
+        computeBezierProgressively(makeBezier());
+        return;
+    }
+
+    // Tiles are uploaded as they come, so streaming stays on this thread
+    if (m_AsyncComputing && !m_StreamTiles)
+    {
+        m_BezierJobs.submit(makeBezier());
+        return;
+    }
+
+    // A late asynchronous result would replace this one
+    m_BezierJobs.cancel();
+
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
-    m_Bezier = Bezier(m_BezierParams.degreeU, m_BezierParams.degreeV, m_BezierParams.resolutionU, m_BezierParams.resolutionV);
+    showBezier(makeBezier());
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    m_LastComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f;
+    m_DisplayedJobId = m_BezierJobs.getLastJobId();
+    m_LastJobLatencySeconds = 0.f;
+    m_RefinementStepsLeft = 0;
+    recordThroughput(m_Bezier, m_LastComputeTimeSeconds);
+
+    VRM_LOG_TRACE("Degrees : ({}, {}), Resolutions: ({}, {}) -> {}s", m_BezierParams.degreeU, m_BezierParams.degreeV, m_BezierParams.resolutionU, m_BezierParams.resolutionV, m_LastComputeTimeSeconds);
+}
+
+Bezier MyScene::makeBezier() const
+{
+    Bezier bezier(m_BezierParams.degreeU, m_BezierParams.degreeV, m_BezierParams.resolutionU, m_BezierParams.resolutionV);
+    bezier.setEvaluationMode(static_cast<Bezier::EvaluationMode>(m_BezierParams.evaluationMode));
+    bezier.setAnchorInterval(static_cast<uint32_t>(m_BezierParams.anchorInterval));
+    bezier.setSimdLevel(static_cast<SimdLevel>(m_BezierParams.simdLevel));
+    bezier.setMeshLayout(static_cast<Bezier::MeshLayout>(m_BezierParams.meshLayout));
+    bezier.setNormalMode(static_cast<Bezier::NormalMode>(m_BezierParams.normalMode));
+    bezier.setThreadCount(static_cast<uint32_t>(m_BezierParams.threadCount));
+    bezier.setTessellationMode(static_cast<Bezier::TessellationMode>(m_BezierParams.tessellationMode));
+    bezier.setFlatnessTolerance(m_BezierParams.flatnessTolerance);
+    bezier.setMaxSubdivisionDepth(static_cast<uint32_t>(m_BezierParams.maxSubdivisionDepth));
+    bezier.setIncrementalUpdates(m_IncrementalUpdates);
+    bezier.setLodLevelCount(static_cast<uint32_t>(m_BezierParams.lodLevelCount));
+    bezier.setPrimitiveType(static_cast<vrm::MeshData::PrimitiveType>(m_BezierParams.primitiveType));
     
     for (uint32_t u = 0; u < static_cast<uint32_t>(m_BezierParams.degreeU + 1); u++)
     {
@@ -170,21 +380,181 @@ void MyScene::computeBezier()
 
             //VRM_LOG_INFO("Control point ({}, {}) = ({}, {}, {})", u, v, p.x, p.y, p.z);
 
-            m_Bezier.setControlPoint(u, v, p);
+            bezier.setControlPoint(u, v, p);
         }
     }
 
-    m_MeshAsset.clear();
-    m_MeshAsset.addSubmesh(m_Bezier.polygonize());
+    return bezier;
+}
+
+void MyScene::computeBezierProgressively(Bezier bezier)
+{
+    const uint32_t steps = previewRefinementSteps(bezier);
+
+    Bezier preview = bezier;
+    preview.setResolution(BezierJobQueue::RefinedResolution(bezier.getResolutionU(), steps), BezierJobQueue::RefinedResolution(bezier.getResolutionV(), steps));
+
+    // The previous job would hold the worker pool while the preview is computed
+    m_BezierJobs.cancel();
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    showBezier(std::move(preview));
 
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     m_LastComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f;
+    m_LastJobLatencySeconds = 0.f;
+    recordThroughput(m_Bezier, m_LastComputeTimeSeconds);
 
-    VRM_LOG_TRACE("Degrees : ({}, {}), Resolutions: ({}, {}) -> {}s", m_BezierParams.degreeU, m_BezierParams.degreeV, m_BezierParams.resolutionU, m_BezierParams.resolutionV, m_LastComputeTimeSeconds);
+    m_RefinementStepsLeft = steps;
+    m_RefinementTarget[0] = bezier.getResolutionU();
+    m_RefinementTarget[1] = bezier.getResolutionV();
+
+    // The preview is the coarsest step of the job, the next one starts at twice its resolution
+    if (steps > 0)
+        m_BezierJobs.submit(std::move(bezier), steps - 1);
+    m_DisplayedJobId = m_BezierJobs.getLastJobId();
+}
+
+uint32_t MyScene::previewRefinementSteps(const Bezier& bezier) const
+{
+    const double budgetSamples = static_cast<double>(m_SamplesPerSecond) * m_FrameBudgetMs / 1000.0;
+
+    for (uint32_t steps = 0; steps < 32; steps++)
+    {
+        const uint32_t resolutionU = BezierJobQueue::RefinedResolution(bezier.getResolutionU(), steps);
+        const uint32_t resolutionV = BezierJobQueue::RefinedResolution(bezier.getResolutionV(), steps);
+
+        if (static_cast<double>(resolutionU) * resolutionV <= budgetSamples || (resolutionU <= 2 && resolutionV <= 2))
+            return steps;
+    }
+
+    return 32;
+}
+
+void MyScene::recordThroughput(const Bezier& bezier, float seconds)
+{
+    // Tiny meshes are dominated by fixed costs and would underestimate it
+    const float samples = static_cast<float>(bezier.getResolutionU()) * static_cast<float>(bezier.getResolutionV());
+    if (seconds > 0.f && samples >= 1024.f)
+        m_SamplesPerSecond = samples / seconds;
+}
+
+void MyScene::showBezier(Bezier bezier)
+{
+    m_Bezier = std::move(bezier);
+
+    uploadMesh();
+
+    m_EditedControlPoint[0] = std::min(m_EditedControlPoint[0], static_cast<int>(m_Bezier.getDegreeU()));
+    m_EditedControlPoint[1] = std::min(m_EditedControlPoint[1], static_cast<int>(m_Bezier.getDegreeV()));
 
     updateControlPoints();
 }
 
+void MyScene::uploadMesh()
+{
+    // Incremental updates overwrite vertex ranges of the surface, so its vertices keep their numbers then
+    vrm::MeshOptimizer::Settings optimizerSettings;
+    optimizerSettings.reorderVertexFetch = m_StreamTiles || !m_IncrementalUpdates;
+    m_MeshAsset.setOptimizeMeshes(m_OptimizeMeshes, optimizerSettings);
+
+    m_MeshAsset.clear();
+
+    if (m_StreamTiles)
+    {
+        SubmeshTileSink sink(m_MeshAsset);
+        m_Bezier.polygonizeTiles(sink, static_cast<uint32_t>(m_TileSize));
+    }
+    else if (m_IncrementalUpdates)
+    {
+        // Incremental updates patch the cache of the surface and upload from it, so it stays
+        m_MeshAsset.addSubmesh(m_Bezier.polygonize());
+    }
+    else
+    {
+        m_MeshAsset.addSubmesh(m_Bezier.releaseMesh());
+    }
+}
+
+void MyScene::showFinishedJob()
+{
+    std::optional<BezierJobQueue::Result> result = m_BezierJobs.takeResult();
+    if (!result)
+        return;
+
+    showBezier(std::move(result->bezier));
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    m_LastComputeTimeSeconds = result->computeTimeSeconds;
+    m_LastJobLatencySeconds = std::chrono::duration_cast<std::chrono::microseconds>(now - result->submitTime).count() / 1'000'000.f;
+    m_DisplayedJobId = result->jobId;
+    m_RefinementStepsLeft = result->refinementStepsLeft;
+    recordThroughput(m_Bezier, m_LastComputeTimeSeconds);
+
+    VRM_LOG_TRACE("Job {}: computed in {}s, shown {}s after submission", result->jobId, m_LastComputeTimeSeconds, m_LastJobLatencySeconds);
+}
+
+void MyScene::moveControlPoint(uint32_t u, uint32_t v, const glm::vec3& p)
+{
+    // The shown surface is only a step of the refinement: the edit starts it again from the full surface
+    if (m_RefinementStepsLeft > 0)
+    {
+        // The preview is replaced right after: its control points and settings are taken, its mesh and tangents dropped rather than copied
+        Bezier bezier = std::move(m_Bezier);
+        bezier.discardMesh();
+        bezier.setResolution(m_RefinementTarget[0], m_RefinementTarget[1]);
+        bezier.setControlPoint(u, v, p);
+        computeBezierProgressively(std::move(bezier));
+    }
+    else
+    {
+        updateBezierControlPoint(u, v, p);
+    }
+
+    const size_t index = static_cast<size_t>(u) * (m_Bezier.getDegreeV() + 1) + v;
+    if (index < m_ControlPoints.size())
+        m_ControlPoints[index].getComponent<vrm::TransformComponent>().setPosition(p);
+}
+
+void MyScene::updateBezierControlPoint(uint32_t u, uint32_t v, const glm::vec3& p)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    // The edit is made on the shown surface, a pending job would replace it with its own control points once done
+    if (m_DisplayedJobId != m_BezierJobs.getLastJobId())
+    {
+        m_BezierJobs.cancel();
+        m_DisplayedJobId = m_BezierJobs.getLastJobId();
+    }
+
+    m_Bezier.setControlPoint(u, v, p);
+
+    // Patched in place: only the vertices it touched are uploaded again
+    if (m_StreamTiles)
+    {
+        uploadMesh();
+    }
+    else if (m_Bezier.isMeshUpToDate())
+    {
+        const Bezier::VertexRange& range = m_Bezier.getDirtyVertexRange();
+        if (range.count > 0)
+            m_MeshAsset.updateSubmeshVertices(0, range.first, m_Bezier.polygonize().getRawVericesData() + range.first, range.count);
+        m_Bezier.clearDirtyVertexRange();
+    }
+    else if (m_AsyncComputing)
+    {
+        m_BezierJobs.submit(m_Bezier);
+    }
+    else
+    {
+        uploadMesh();
+    }
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    m_LastComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f;
+}
+
 void MyScene::updateControlPoints()
 {
     for (const auto& e : m_ControlPoints)
@@ -197,9 +567,9 @@ void MyScene::updateControlPoints()
     if (!m_ShowControlPoints)
         return;
 
-    for (uint32_t u = 0; u < static_cast<uint32_t>(m_BezierParams.degreeU + 1); u++)
+    for (uint32_t u = 0; u < m_Bezier.getDegreeU() + 1; u++)
     {
-        for (uint32_t v = 0; v < static_cast<uint32_t>(m_BezierParams.degreeV + 1); v++)
+        for (uint32_t v = 0; v < m_Bezier.getDegreeV() + 1; v++)
         {
             auto e = createEntity(std::string("ControlPoint_") + std::to_string(u) + "_" + std::to_string(v));
             e.getComponent<vrm::TransformComponent>().setPosition(m_Bezier.getControlPoint(u, v));
@@ -210,44 +580,160 @@ void MyScene::updateControlPoints()
     }
 }
 
-void MyScene::profile()
+void MyScene::onPatchSurfaceImGui()
 {
-    VRM_LOG_INFO("Beginning profiling session");
+    ImGui::Begin("Patch surface");
+        if (ImGui::Checkbox("Show patch surface", &m_ShowPatchSurface))
+        {
+            if (m_ShowPatchSurface)
+            {
+                computePatchSurface();
+                m_PatchEntity = createEntity("Patch surface");
+                m_PatchEntity.addComponent<vrm::MeshComponent>(m_PatchMeshAsset.createInstance());
+            }
+            else
+            {
+                destroyEntity(m_PatchEntity);
+            }
+        }
+
+        if (!m_ShowPatchSurface)
+        {
+            ImGui::End();
+            return;
+        }
+
+        bool changed = false;
+        ImGui::TextWrapped("Patches");
+        changed |= ImGui::SliderInt2("##Patches", m_PatchParams.patchCounts, 1, 32, "%d");
+        ImGui::TextWrapped("Patch degrees");
+        changed |= ImGui::SliderInt2("##Patch degrees", m_PatchParams.degrees, 1, 10, "%d");
+        ImGui::TextWrapped("Segments per patch");
+        changed |= ImGui::SliderInt2("##Segments per patch", m_PatchParams.segments, 1, 256, "%d", ImGuiSliderFlags_Logarithmic);
+        ImGui::TextWrapped("Continuity");
+        changed |= ImGui::Combo("##Continuity", &m_PatchParams.continuity, "C0\0C1\0");
+        if (changed || ImGui::Button("Compute patch surface"))
+            computePatchSurface();
+
+        ImGui::TextWrapped("Edited control point");
+        const int maxU = static_cast<int>(m_PatchSurface->getControlPointCountU()) - 1;
+        const int maxV = static_cast<int>(m_PatchSurface->getControlPointCountV()) - 1;
+        if (ImGui::SliderInt2("##Edited patch control point", m_EditedPatchControlPoint, 0, std::max(maxU, maxV), "%d"))
+        {
+            m_EditedPatchControlPoint[0] = std::min(m_EditedPatchControlPoint[0], maxU);
+            m_EditedPatchControlPoint[1] = std::min(m_EditedPatchControlPoint[1], maxV);
+        }
+        {
+            const uint32_t u = static_cast<uint32_t>(m_EditedPatchControlPoint[0]);
+            const uint32_t v = static_cast<uint32_t>(m_EditedPatchControlPoint[1]);
+            glm::vec3 p = m_PatchSurface->getControlPoint(u, v);
+            if (ImGui::DragFloat3("##Patch control point position", &p.x, 0.01f))
+                movePatchControlPoint(u, v, p);
+        }
+
+        ImGui::TextWrapped("Vertices: %lu", m_PatchSurface->polygonize().getVertexCount());
+        ImGui::TextWrapped("Patches tessellated last: %u of %u", m_PatchSurface->getLastTessellatedPatchCount(), m_PatchSurface->getPatchCountU() * m_PatchSurface->getPatchCountV());
+        ImGui::TextWrapped("Last compute time: %.4f s", m_LastPatchComputeTimeSeconds);
+    ImGui::End();
+}
 
+void MyScene::computePatchSurface()
+{
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
-    const std::vector<uint32_t> degrees = {
-        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12
-    };
+    const uint32_t patchesU = static_cast<uint32_t>(m_PatchParams.patchCounts[0]), patchesV = static_cast<uint32_t>(m_PatchParams.patchCounts[1]);
+    m_PatchSurface = std::make_unique<PatchSurface>(patchesU, patchesV, m_PatchParams.degrees[0], m_PatchParams.degrees[1], m_PatchParams.segments[0], m_PatchParams.segments[1]);
+    m_PatchSurface->setSimdLevel(static_cast<SimdLevel>(m_BezierParams.simdLevel));
+    m_PatchSurface->setThreadCount(static_cast<uint32_t>(m_BezierParams.threadCount));
 
-    const std::vector<uint32_t> resolutions = {
-        1, 10, 100, 1000
-    };
+    // Laid out beside the single patch, with random heights
+    const float step = m_PatchParams.patchSize / static_cast<float>(std::max(m_PatchParams.degrees[0], m_PatchParams.degrees[1]));
+    const float offsetX = -m_PatchParams.patchSize * static_cast<float>(patchesU) - 2.f;
 
-    for (auto degree : degrees)
-    {
+    for (uint32_t u = 0; u < m_PatchSurface->getControlPointCountU(); u++)
+        for (uint32_t v = 0; v < m_PatchSurface->getControlPointCountV(); v++)
+            m_PatchSurface->setControlPoint(u, v, { offsetX + static_cast<float>(u) * step, static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX) * m_PatchParams.verticalSpread, static_cast<float>(v) * step });
+
+    m_PatchSurface->setContinuity(static_cast<PatchSurface::Continuity>(m_PatchParams.continuity));
+
+    // Control point edits overwrite vertex ranges, so vertices keep their numbers
+    vrm::MeshOptimizer::Settings optimizerSettings;
+    optimizerSettings.reorderVertexFetch = false;
+    m_PatchMeshAsset.setOptimizeMeshes(m_OptimizeMeshes, optimizerSettings);
+
+    m_PatchMeshAsset.clear();
+    m_PatchMeshAsset.addSubmesh(m_PatchSurface->polygonize());
+    m_PatchSurface->clearDirtyVertexRange();
 
-        // First caching Bezier computations
-        VRM_LOG_TRACE("Caching Bezier computations");
-        m_BezierParams.degreeU = degree;
-        m_BezierParams.degreeV = degree;
-        m_BezierParams.resolutionU = 1;
-        m_BezierParams.resolutionV = 1;
-        computeBezier();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    m_LastPatchComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f;
+}
+
+void MyScene::movePatchControlPoint(uint32_t u, uint32_t v, const glm::vec3& p)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    // Only the patches around the point are tessellated again, and only their vertices uploaded
+    m_PatchSurface->setControlPoint(u, v, p);
+    const vrm::MeshData& mesh = m_PatchSurface->polygonize();
+
+    const PatchSurface::VertexRange& range = m_PatchSurface->getDirtyVertexRange();
+    if (range.count > 0)
+        m_PatchMeshAsset.updateSubmeshVertices(0, range.first, mesh.getRawVericesData() + range.first, range.count);
+    m_PatchSurface->clearDirtyVertexRange();
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    m_LastPatchComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f;
+}
+
+void MyScene::benchmarkKernels()
+{
+    VRM_LOG_INFO("Benchmarking degree specialized kernels against the generic ones, resolution ({}, {})", m_BezierParams.resolutionU, m_BezierParams.resolutionV);
 
-        for (auto res : resolutions)
+    for (uint32_t degree = 1; degree <= DegreeKernels::MaxSpecializedDegree; degree++)
+    {
+        Bezier bezier(degree, degree, m_BezierParams.resolutionU, m_BezierParams.resolutionV);
+        bezier.setMeshLayout(static_cast<Bezier::MeshLayout>(m_BezierParams.meshLayout));
+        bezier.setNormalMode(static_cast<Bezier::NormalMode>(m_BezierParams.normalMode));
+        bezier.setThreadCount(static_cast<uint32_t>(m_BezierParams.threadCount));
+        // The kernels compared are the scalar ones: SIMD direct evaluation has no specialized variant
+        bezier.setSimdLevel(SimdLevel::Scalar);
+
+        for (uint32_t u = 0; u <= degree; u++)
+            for (uint32_t v = 0; v <= degree; v++)
+                bezier.setControlPoint(u, v, { static_cast<float>(u), static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX), static_cast<float>(v) });
+
+        for (auto mode : { Bezier::EvaluationMode::Direct, Bezier::EvaluationMode::Separable })
         {
-            m_BezierParams.degreeU = degree;
-            m_BezierParams.degreeV = degree;
-            m_BezierParams.resolutionU = res;
-            m_BezierParams.resolutionV = res;
+            float seconds[2] = {};
 
-            computeBezier();
+            // Untimed, so that the basis and the mesh are allocated before the first timed run
+            bezier.setEvaluationMode(mode);
+            bezier.polygonize();
+
+            for (bool specialized : { false, true })
+            {
+                bezier.setEvaluationMode(mode);
+                bezier.setSpecializedKernels(specialized);
+
+                std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+                bezier.polygonize();
+                std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+                seconds[specialized] = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f;
+            }
+
+            VRM_LOG_INFO("Degree {} {}: generic {}s, specialized {}s ({:.2f}x)", degree, mode == Bezier::EvaluationMode::Direct ? "direct" : "separable", seconds[0], seconds[1], seconds[0] / std::max(seconds[1], 1e-6f));
         }
     }
+}
 
+void MyScene::measureEvaluationError()
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    m_LastEvaluationError = m_Bezier.measureEvaluationError();
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
-    float durationSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f;
 
-    VRM_LOG_INFO("Profiling session ended in {}s", durationSeconds);
-}
\ No newline at end of file
+    VRM_LOG_INFO("Evaluation error against direct evaluation: max {}, rms {}, normals up to {} degrees ({}s)", m_LastEvaluationError.maxPositionError, m_LastEvaluationError.rmsPositionError,
+        m_LastEvaluationError.maxNormalAngle, std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / 1'000'000.f);
+}
@@ -0,0 +1,78 @@
+#include "NurbsBasis.h"
+
+#include <Vroom/Core/Assert.h>
+
+NurbsBasis::NurbsBasis(uint32_t degree, const std::vector<float>& knots, uint32_t resolution)
+	: m_Degree(degree), m_Resolution(resolution), m_Knots(knots)
+{
+	VRM_ASSERT_MSG(degree >= 1 && degree <= MaxDegree, "NURBS degrees must be between 1 and {}.", MaxDegree);
+	VRM_ASSERT_MSG(knots.size() >= 2 * static_cast<size_t>(degree) + 2, "A degree {} knot vector needs at least {} knots.", degree, 2 * degree + 2);
+
+	const uint32_t controlPointCount = static_cast<uint32_t>(knots.size()) - degree - 1;
+	const float first = knots[degree];
+	const float last = knots[controlPointCount];
+
+	m_Spans.resize(resolution);
+	m_Values.resize(static_cast<size_t>(resolution) * (degree + 1));
+	m_Derivatives.resize(static_cast<size_t>(resolution) * (degree + 1));
+
+	uint32_t span = degree;
+
+	for (uint32_t sample = 0; sample < resolution; sample++)
+	{
+		const float t = first + (static_cast<float>(sample) / static_cast<float>(resolution)) * (last - first);
+
+		// Parameters only grow, so the span only moves forward
+		while (span + 1 < controlPointCount && t >= knots[span + 1])
+			span++;
+
+		m_Spans[sample] = span;
+		Evaluate(degree, knots.data(), span, t, m_Values.data() + static_cast<size_t>(sample) * (degree + 1), m_Derivatives.data() + static_cast<size_t>(sample) * (degree + 1));
+	}
+}
+
+void NurbsBasis::Evaluate(uint32_t degree, const float* knots, uint32_t span, float t, float* values, float* derivatives)
+{
+	float left[MaxDegree + 1], right[MaxDegree + 1];
+	// Degree - 1 functions N(span - degree + 1 .. span), for the derivatives
+	float reduced[MaxDegree + 1];
+
+	values[0] = 1.f;
+
+	// Each pass raises the degree by one, the triangle of non-zero functions growing by one at its end
+	for (uint32_t j = 1; j <= degree; j++)
+	{
+		if (j == degree)
+			for (uint32_t r = 0; r < degree; r++)
+				reduced[r] = values[r];
+
+		left[j] = t - knots[span + 1 - j];
+		right[j] = knots[span + j] - t;
+
+		float saved = 0.f;
+
+		for (uint32_t r = 0; r < j; r++)
+		{
+			const float temp = values[r] / (right[r + 1] + left[j - r]);
+			values[r] = saved + right[r + 1] * temp;
+			saved = left[j - r] * temp;
+		}
+
+		values[j] = saved;
+	}
+
+	// N'(i, p) = p N(i, p - 1) / (u(i + p) - u(i)) - p N(i + 1, p - 1) / (u(i + p + 1) - u(i + 1)), every denominator spanning the non-empty span
+	const float p = static_cast<float>(degree);
+
+	for (uint32_t r = 0; r <= degree; r++)
+	{
+		float derivative = 0.f;
+
+		if (r > 0)
+			derivative += reduced[r - 1] / (knots[span + r] - knots[span + r - degree]);
+		if (r < degree)
+			derivative -= reduced[r] / (knots[span + r + 1] - knots[span + r + 1 - degree]);
+
+		derivatives[r] = p * derivative;
+	}
+}
@@ -0,0 +1,272 @@
+#include "NurbsSurface.h"
+
+#include <Vroom/Core/Assert.h>
+
+#include <algorithm>
+
+#include "WorkerPool.h"
+
+NurbsSurface::NurbsSurface(uint32_t degreeU, uint32_t degreeV, uint32_t controlPointCountU, uint32_t controlPointCountV, uint32_t resolutionU, uint32_t resolutionV)
+	: m_DegreeU(degreeU), m_DegreeV(degreeV), m_ControlPointCountU(controlPointCountU), m_ControlPointCountV(controlPointCountV), m_ResolutionU(resolutionU), m_ResolutionV(resolutionV)
+{
+	VRM_ASSERT_MSG(degreeU >= 1 && degreeV >= 1 && std::max(degreeU, degreeV) <= NurbsBasis::MaxDegree, "NURBS degrees must be between 1 and {}.", NurbsBasis::MaxDegree);
+	VRM_ASSERT_MSG(controlPointCountU > degreeU && controlPointCountV > degreeV, "A degree n direction needs at least n + 1 control points.");
+
+	m_ControlPoints.assign(static_cast<size_t>(controlPointCountU) * controlPointCountV, glm::vec3());
+	m_Weights.assign(m_ControlPoints.size(), 1.f);
+	m_KnotsU = ClampedUniformKnots(degreeU, controlPointCountU);
+	m_KnotsV = ClampedUniformKnots(degreeV, controlPointCountV);
+}
+
+void NurbsSurface::setControlPoint(uint32_t u, uint32_t v, const glm::vec3& p)
+{
+	m_ControlPoints.at(static_cast<size_t>(u) * m_ControlPointCountV + v) = p;
+
+	m_HomogeneousNetUpToDate = false;
+	m_NeedsCompute = true;
+}
+
+void NurbsSurface::setWeight(uint32_t u, uint32_t v, float weight)
+{
+	VRM_ASSERT_MSG(weight > 0.f, "NURBS weights must be positive, got {}.", weight);
+
+	m_Weights.at(static_cast<size_t>(u) * m_ControlPointCountV + v) = weight;
+
+	m_HomogeneousNetUpToDate = false;
+	m_NeedsCompute = true;
+}
+
+void NurbsSurface::setKnotsU(const std::vector<float>& knots)
+{
+	CheckKnots(knots, m_DegreeU, m_ControlPointCountU);
+	m_KnotsU = knots;
+
+	m_NeedsCompute = true;
+}
+
+void NurbsSurface::setKnotsV(const std::vector<float>& knots)
+{
+	CheckKnots(knots, m_DegreeV, m_ControlPointCountV);
+	m_KnotsV = knots;
+
+	m_NeedsCompute = true;
+}
+
+void NurbsSurface::setResolution(uint32_t resolutionU, uint32_t resolutionV)
+{
+	m_ResolutionU = resolutionU;
+	m_ResolutionV = resolutionV;
+
+	m_NeedsCompute = true;
+}
+
+void NurbsSurface::setThreadCount(uint32_t threadCount)
+{
+	m_ThreadCount = threadCount;
+}
+
+const glm::vec3& NurbsSurface::getControlPoint(uint32_t u, uint32_t v) const
+{
+	return m_ControlPoints.at(static_cast<size_t>(u) * m_ControlPointCountV + v);
+}
+
+float NurbsSurface::getWeight(uint32_t u, uint32_t v) const
+{
+	return m_Weights.at(static_cast<size_t>(u) * m_ControlPointCountV + v);
+}
+
+uint32_t NurbsSurface::getThreadCount() const
+{
+	return m_ThreadCount == 0 ? WorkerPool::HardwareThreadCount() : m_ThreadCount;
+}
+
+const vrm::MeshData& NurbsSurface::polygonize() const
+{
+	if (m_NeedsCompute)
+	{
+		m_PolygonizedCache = windowMesh({ 0, m_ResolutionU, 0, m_ResolutionV });
+		m_NeedsCompute = false;
+	}
+
+	return m_PolygonizedCache;
+}
+
+void NurbsSurface::polygonizeTiles(TileSink& sink, uint32_t tileSize) const
+{
+	if (m_ResolutionU < 2 || m_ResolutionV < 2)
+		return;
+
+	VRM_ASSERT_MSG(tileSize >= 2, "A tile needs at least 2 x 2 samples to hold a quad.");
+
+	// Tiles overlap by one sample so that their quads cover the whole grid
+	const uint32_t quadsPerTile = tileSize - 1;
+	const uint32_t tilesU = (m_ResolutionU - 2) / quadsPerTile + 1;
+	const uint32_t tilesV = (m_ResolutionV - 2) / quadsPerTile + 1;
+
+	for (uint32_t tileU = 0; tileU < tilesU; tileU++)
+	{
+		for (uint32_t tileV = 0; tileV < tilesV; tileV++)
+		{
+			const uint32_t firstSampleU = tileU * quadsPerTile;
+			const uint32_t firstSampleV = tileV * quadsPerTile;
+			const SampleWindow window = { firstSampleU, std::min(tileSize, m_ResolutionU - firstSampleU), firstSampleV, std::min(tileSize, m_ResolutionV - firstSampleV) };
+
+			sink.onTile({ tileU * tilesV + tileV, window.firstSampleU, window.sampleCountU, window.firstSampleV, window.sampleCountV }, windowMesh(window));
+		}
+	}
+}
+
+std::vector<float> NurbsSurface::ClampedUniformKnots(uint32_t degree, uint32_t controlPointCount)
+{
+	std::vector<float> knots(static_cast<size_t>(controlPointCount) + degree + 1);
+	const uint32_t spanCount = controlPointCount - degree;
+
+	for (size_t i = 0; i < knots.size(); i++)
+	{
+		const size_t interior = std::clamp(i, static_cast<size_t>(degree), static_cast<size_t>(controlPointCount)) - degree;
+		knots[i] = static_cast<float>(interior) / static_cast<float>(spanCount);
+	}
+
+	return knots;
+}
+
+void NurbsSurface::CheckKnots(const std::vector<float>& knots, uint32_t degree, uint32_t controlPointCount)
+{
+	VRM_ASSERT_MSG(knots.size() == static_cast<size_t>(controlPointCount) + degree + 1, "{} control points of degree {} need {} knots, got {}.", controlPointCount, degree, controlPointCount + degree + 1, knots.size());
+	VRM_ASSERT_MSG(std::is_sorted(knots.begin(), knots.end()), "Knots must be non-decreasing.");
+	VRM_ASSERT_MSG(knots[degree] < knots[controlPointCount], "The knot domain [{}, {}] is empty.", knots[degree], knots[controlPointCount]);
+}
+
+void NurbsSurface::updateBasis() const
+{
+	if (!m_BasisU.matches(m_DegreeU, m_KnotsU, m_ResolutionU))
+		m_BasisU = NurbsBasis(m_DegreeU, m_KnotsU, m_ResolutionU);
+
+	if (!m_BasisV.matches(m_DegreeV, m_KnotsV, m_ResolutionV))
+		m_BasisV = NurbsBasis(m_DegreeV, m_KnotsV, m_ResolutionV);
+}
+
+void NurbsSurface::updateHomogeneousNet() const
+{
+	if (m_HomogeneousNetUpToDate)
+		return;
+
+	m_HomogeneousNet.resize(m_ControlPoints.size());
+
+	for (size_t i = 0; i < m_ControlPoints.size(); i++)
+		m_HomogeneousNet[i] = glm::vec4(m_Weights[i] * m_ControlPoints[i], m_Weights[i]);
+
+	m_HomogeneousNetUpToDate = true;
+}
+
+vrm::MeshData NurbsSurface::windowMesh(const SampleWindow& window) const
+{
+	// Shared state is prepared here, the row blocks then only read it
+	updateBasis();
+	updateHomogeneousNet();
+
+	std::vector<vrm::Vertex> vertices(window.size());
+
+	const uint32_t threadCount = getThreadCount();
+	// A few blocks per thread so that uneven blocks still balance
+	const uint32_t blockCount = std::max(std::min(window.sampleCountU, threadCount * 4), 1u);
+	const uint32_t blockSize = (window.sampleCountU + blockCount - 1) / blockCount;
+
+	WorkerPool::Get().parallelFor(blockCount, threadCount, [&](uint32_t block)
+	{
+		const uint32_t rowBegin = block * blockSize;
+		evaluateRows(window, vertices.data(), rowBegin, std::min(rowBegin + blockSize, window.sampleCountU));
+	});
+
+	if (window.sampleCountU < 2 || window.sampleCountV < 2)
+		return vrm::MeshData(std::move(vertices), {});
+
+	// Same quads as the indexed grid of Bezier
+	const uint32_t rowSize = window.sampleCountV;
+	std::vector<uint32_t> indices(static_cast<size_t>(window.sampleCountU - 1) * (rowSize - 1) * 6);
+	size_t offset = 0;
+
+	for (uint32_t row = 0; row + 1 < window.sampleCountU; row++)
+	{
+		for (uint32_t column = 0; column + 1 < rowSize; column++)
+		{
+			const uint32_t a = row * rowSize + column;
+			const uint32_t b = a + rowSize;
+			const uint32_t c = b + 1;
+			const uint32_t d = a + 1;
+
+			indices[offset++] = a;
+			indices[offset++] = b;
+			indices[offset++] = c;
+
+			indices[offset++] = a;
+			indices[offset++] = c;
+			indices[offset++] = d;
+		}
+	}
+
+	return vrm::MeshData(std::move(vertices), std::move(indices));
+}
+
+void NurbsSurface::evaluateRows(const SampleWindow& window, vrm::Vertex* vertices, uint32_t rowBegin, uint32_t rowEnd) const
+{
+	if (window.sampleCountV == 0)
+		return;
+
+	// Only the columns weighted by the samples of the window are contracted along U
+	const uint32_t firstColumn = m_BasisV.getSpan(window.firstSampleV) - m_DegreeV;
+	const uint32_t endColumn = m_BasisV.getSpan(window.firstSampleV + window.sampleCountV - 1) + 1;
+
+	// Homogeneous net contracted along U for the current row, and its derivative in u
+	std::vector<glm::vec4> rowCurve(endColumn - firstColumn), rowDerivative(endColumn - firstColumn);
+
+	for (uint32_t row = rowBegin; row < rowEnd; row++)
+	{
+		const uint32_t sampleU = window.firstSampleU + row;
+		const uint32_t firstRow = m_BasisU.getSpan(sampleU) - m_DegreeU;
+		const float* basisU = m_BasisU.getValues(sampleU);
+		const float* derivativeU = m_BasisU.getDerivatives(sampleU);
+
+		for (uint32_t column = firstColumn; column < endColumn; column++)
+		{
+			glm::vec4 point = glm::vec4(0.f), derivative = glm::vec4(0.f);
+
+			for (uint32_t k = 0; k <= m_DegreeU; k++)
+			{
+				const glm::vec4& controlPoint = m_HomogeneousNet[static_cast<size_t>(firstRow + k) * m_ControlPointCountV + column];
+				point += basisU[k] * controlPoint;
+				derivative += derivativeU[k] * controlPoint;
+			}
+
+			rowCurve[column - firstColumn] = point;
+			rowDerivative[column - firstColumn] = derivative;
+		}
+
+		for (uint32_t sampleV = window.firstSampleV; sampleV < window.firstSampleV + window.sampleCountV; sampleV++)
+		{
+			const uint32_t first = m_BasisV.getSpan(sampleV) - m_DegreeV - firstColumn;
+			const float* basisV = m_BasisV.getValues(sampleV);
+			const float* derivativeV = m_BasisV.getDerivatives(sampleV);
+
+			glm::vec4 point = glm::vec4(0.f), tangentU = glm::vec4(0.f), tangentV = glm::vec4(0.f);
+
+			for (uint32_t l = 0; l <= m_DegreeV; l++)
+			{
+				point += basisV[l] * rowCurve[first + l];
+				tangentU += basisV[l] * rowDerivative[first + l];
+				tangentV += derivativeV[l] * rowCurve[first + l];
+			}
+
+			// Quotient rule: S = A / w, S' = (A' - w' S) / w
+			const glm::vec3 position = glm::vec3(point) / point.w;
+			const glm::vec3 normal = glm::cross(glm::vec3(tangentU) - tangentU.w * position, glm::vec3(tangentV) - tangentV.w * position);
+			const float length = glm::length(normal);
+
+			vrm::Vertex& vertex = vertices[static_cast<size_t>(row) * window.sampleCountV + (sampleV - window.firstSampleV)];
+			vertex.position = position;
+			// The 1 / w factors only scale the normal
+			vertex.normal = length > 0.f ? normal / length : glm::vec3{ 0.f, 1.f, 0.f };
+			vertex.texCoords = { BernsteinBasis::SampleParameter(sampleU, m_ResolutionU), BernsteinBasis::SampleParameter(sampleV, m_ResolutionV) };
+		}
+	}
+}
@@ -0,0 +1,269 @@
+#include "PatchSurface.h"
+
+#include <Vroom/Core/Assert.h>
+
+#include <algorithm>
+
+#include "WorkerPool.h"
+
+PatchSurface::PatchSurface(uint32_t patchCountU, uint32_t patchCountV, uint32_t degreeU, uint32_t degreeV, uint32_t segmentsU, uint32_t segmentsV)
+	: m_PatchCountU(patchCountU), m_PatchCountV(patchCountV), m_DegreeU(degreeU), m_DegreeV(degreeV), m_SegmentsU(segmentsU), m_SegmentsV(segmentsV)
+{
+	VRM_ASSERT_MSG(patchCountU > 0 && patchCountV > 0, "A patch surface needs at least one patch.");
+	VRM_ASSERT_MSG(degreeU > 0 && degreeV > 0 && std::max(degreeU, degreeV) <= SimdDeCasteljau::MaxDegree, "Patch degrees must be between 1 and {}.", SimdDeCasteljau::MaxDegree);
+	VRM_ASSERT_MSG(segmentsU > 0 && segmentsV > 0, "A patch needs at least one segment per side.");
+
+	m_ControlPoints.assign(static_cast<size_t>(getControlPointCountU()) * getControlPointCountV(), glm::vec3());
+	m_DirtyPatches.assign(static_cast<size_t>(patchCountU) * patchCountV, true);
+}
+
+void PatchSurface::setControlPoint(uint32_t u, uint32_t v, const glm::vec3& p)
+{
+	VRM_ASSERT_MSG(u < getControlPointCountU() && v < getControlPointCountV(), "Control point ({}, {}) is outside of the net.", u, v);
+
+	const bool c1 = m_Continuity == Continuity::C1;
+	const std::vector<float> weightsU = MoveWeights(u, getControlPointCountU(), m_DegreeU, c1);
+	const std::vector<float> weightsV = MoveWeights(v, getControlPointCountV(), m_DegreeV, c1);
+	const glm::vec3 delta = p - at(u, v);
+
+	for (uint32_t i = 0; i < getControlPointCountU(); i++)
+	{
+		if (weightsU[i] == 0.f)
+			continue;
+
+		for (uint32_t j = 0; j < getControlPointCountV(); j++)
+		{
+			if (weightsV[j] == 0.f)
+				continue;
+
+			at(i, j) += (weightsU[i] * weightsV[j]) * delta;
+
+			// Boundary points belong to the patches on both sides
+			const uint32_t lastPatchU = std::min(i / m_DegreeU, m_PatchCountU - 1);
+			const uint32_t firstPatchU = i % m_DegreeU == 0 && i > 0 ? i / m_DegreeU - 1 : lastPatchU;
+			const uint32_t lastPatchV = std::min(j / m_DegreeV, m_PatchCountV - 1);
+			const uint32_t firstPatchV = j % m_DegreeV == 0 && j > 0 ? j / m_DegreeV - 1 : lastPatchV;
+
+			for (uint32_t patchU = firstPatchU; patchU <= lastPatchU; patchU++)
+				for (uint32_t patchV = firstPatchV; patchV <= lastPatchV; patchV++)
+					m_DirtyPatches[patchIndex(patchU, patchV)] = true;
+		}
+	}
+
+	// Exactly where asked, whatever the rounding of the sums
+	at(u, v) = p;
+}
+
+void PatchSurface::setContinuity(Continuity continuity)
+{
+	m_Continuity = continuity;
+
+	if (continuity == Continuity::C1)
+	{
+		enforceContinuity();
+		markAllDirty();
+	}
+}
+
+void PatchSurface::setSegments(uint32_t segmentsU, uint32_t segmentsV)
+{
+	VRM_ASSERT_MSG(segmentsU > 0 && segmentsV > 0, "A patch needs at least one segment per side.");
+
+	m_SegmentsU = segmentsU;
+	m_SegmentsV = segmentsV;
+
+	m_TopologyUpToDate = false;
+	markAllDirty();
+}
+
+void PatchSurface::setSimdLevel(SimdLevel level)
+{
+	m_SimdLevel = level;
+
+	markAllDirty();
+}
+
+void PatchSurface::setThreadCount(uint32_t threadCount)
+{
+	m_ThreadCount = threadCount;
+}
+
+const glm::vec3& PatchSurface::getControlPoint(uint32_t u, uint32_t v) const
+{
+	return m_ControlPoints.at(static_cast<size_t>(u) * getControlPointCountV() + v);
+}
+
+uint32_t PatchSurface::getThreadCount() const
+{
+	return m_ThreadCount == 0 ? WorkerPool::HardwareThreadCount() : m_ThreadCount;
+}
+
+bool PatchSurface::isMeshUpToDate() const
+{
+	return m_TopologyUpToDate && std::find(m_DirtyPatches.begin(), m_DirtyPatches.end(), true) == m_DirtyPatches.end();
+}
+
+const vrm::MeshData& PatchSurface::polygonize()
+{
+	if (!m_TopologyUpToDate)
+		buildTopology();
+
+	std::vector<uint32_t> dirtyPatches;
+
+	for (uint32_t patchU = 0; patchU < m_PatchCountU; patchU++)
+		for (uint32_t patchV = 0; patchV < m_PatchCountV; patchV++)
+			if (m_DirtyPatches[patchIndex(patchU, patchV)])
+				dirtyPatches.push_back(static_cast<uint32_t>(patchIndex(patchU, patchV)));
+
+	if (dirtyPatches.empty())
+		return m_Mesh;
+
+	// Patches write disjoint vertices, so they need no synchronization
+	WorkerPool::Get().parallelFor(static_cast<uint32_t>(dirtyPatches.size()), getThreadCount(), [&](uint32_t task)
+	{
+		tessellatePatch(dirtyPatches[task] / m_PatchCountV, dirtyPatches[task] % m_PatchCountV);
+	});
+
+	for (uint32_t patch : dirtyPatches)
+	{
+		const uint32_t patchU = patch / m_PatchCountV, patchV = patch % m_PatchCountV;
+		const size_t first = static_cast<size_t>(patchU * m_SegmentsU) * sampleCountV() + patchV * m_SegmentsV;
+		const size_t end = static_cast<size_t>(std::min((patchU + 1) * m_SegmentsU + 1, sampleCountU()) - 1) * sampleCountV() + std::min((patchV + 1) * m_SegmentsV + 1, sampleCountV());
+
+		const size_t dirtyEnd = m_DirtyVertexRange.count > 0 ? std::max(m_DirtyVertexRange.first + m_DirtyVertexRange.count, end) : end;
+		m_DirtyVertexRange.first = m_DirtyVertexRange.count > 0 ? std::min(m_DirtyVertexRange.first, first) : first;
+		m_DirtyVertexRange.count = dirtyEnd - m_DirtyVertexRange.first;
+	}
+
+	std::fill(m_DirtyPatches.begin(), m_DirtyPatches.end(), false);
+	m_LastTessellatedPatchCount = static_cast<uint32_t>(dirtyPatches.size());
+
+	return m_Mesh;
+}
+
+void PatchSurface::markAllDirty()
+{
+	std::fill(m_DirtyPatches.begin(), m_DirtyPatches.end(), true);
+}
+
+void PatchSurface::enforceContinuity()
+{
+	// Every boundary point becomes the midpoint of its neighbours, the points after the boundary being moved.
+	// Rows first, then columns: a column step combines rows that are already C1, so they stay C1.
+	if (m_DegreeU >= 2)
+		for (uint32_t boundary = m_DegreeU; boundary + 1 < getControlPointCountU(); boundary += m_DegreeU)
+			for (uint32_t v = 0; v < getControlPointCountV(); v++)
+				at(boundary + 1, v) = 2.f * at(boundary, v) - at(boundary - 1, v);
+
+	if (m_DegreeV >= 2)
+		for (uint32_t boundary = m_DegreeV; boundary + 1 < getControlPointCountV(); boundary += m_DegreeV)
+			for (uint32_t u = 0; u < getControlPointCountU(); u++)
+				at(u, boundary + 1) = 2.f * at(u, boundary) - at(u, boundary - 1);
+}
+
+void PatchSurface::buildTopology()
+{
+	const uint32_t rowSize = sampleCountV();
+	const uint32_t quadRows = sampleCountU() - 1, quadsPerRow = rowSize - 1;
+
+	std::vector<vrm::Vertex> vertices(static_cast<size_t>(sampleCountU()) * rowSize);
+	std::vector<uint32_t> indices(static_cast<size_t>(quadRows) * quadsPerRow * 6);
+	size_t offset = 0;
+
+	// Same quads as the indexed grid of Bezier
+	for (uint32_t row = 0; row < quadRows; row++)
+	{
+		for (uint32_t column = 0; column < quadsPerRow; column++)
+		{
+			const uint32_t a = row * rowSize + column;
+			const uint32_t b = a + rowSize;
+			const uint32_t c = b + 1;
+			const uint32_t d = a + 1;
+
+			indices[offset++] = a;
+			indices[offset++] = b;
+			indices[offset++] = c;
+
+			indices[offset++] = a;
+			indices[offset++] = c;
+			indices[offset++] = d;
+		}
+	}
+
+	m_Mesh = vrm::MeshData(std::move(vertices), std::move(indices));
+	m_TopologyUpToDate = true;
+	m_DirtyVertexRange = {};
+	markAllDirty();
+}
+
+void PatchSurface::tessellatePatch(uint32_t patchU, uint32_t patchV)
+{
+	// Sub-net of the patch
+	std::vector<glm::vec3> net(static_cast<size_t>(m_DegreeU + 1) * (m_DegreeV + 1));
+
+	for (uint32_t i = 0; i <= m_DegreeU; i++)
+		for (uint32_t j = 0; j <= m_DegreeV; j++)
+			net[static_cast<size_t>(i) * (m_DegreeV + 1) + j] = getControlPoint(patchU * m_DegreeU + i, patchV * m_DegreeV + j);
+
+	const SoaPoints soaNet(net.data(), net.size());
+
+	// Owned samples: the seams after the patch belong to the next one, unless it is the last
+	const uint32_t firstSampleU = patchU * m_SegmentsU, firstSampleV = patchV * m_SegmentsV;
+	const uint32_t ownedU = patchU + 1 == m_PatchCountU ? m_SegmentsU + 1 : m_SegmentsU;
+	const uint32_t ownedV = patchV + 1 == m_PatchCountV ? m_SegmentsV + 1 : m_SegmentsV;
+
+	std::vector<float> u(ownedV), v(ownedV);
+	std::vector<glm::vec3> tangentsU(ownedV), tangentsV(ownedV);
+
+	for (uint32_t column = 0; column < ownedV; column++)
+		v[column] = static_cast<float>(column) / static_cast<float>(m_SegmentsV);
+
+	vrm::Vertex* vertices = m_Mesh.getRawVericesData();
+	const float texCoordScaleU = 1.f / static_cast<float>(sampleCountU() - 1);
+	const float texCoordScaleV = 1.f / static_cast<float>(sampleCountV() - 1);
+
+	for (uint32_t row = 0; row < ownedU; row++)
+	{
+		std::fill(u.begin(), u.end(), static_cast<float>(row) / static_cast<float>(m_SegmentsU));
+
+		vrm::Vertex* rowVertices = vertices + static_cast<size_t>(firstSampleU + row) * sampleCountV() + firstSampleV;
+
+		SimdDeCasteljau::EvaluateSurface(m_SimdLevel, m_DegreeU, m_DegreeV, soaNet, u.data(), v.data(), ownedV,
+			&rowVertices->position, sizeof(vrm::Vertex), tangentsU.data(), tangentsV.data(), sizeof(glm::vec3));
+
+		for (uint32_t column = 0; column < ownedV; column++)
+		{
+			const glm::vec3 normal = glm::cross(tangentsU[column], tangentsV[column]);
+			const float length = glm::length(normal);
+
+			rowVertices[column].normal = length > 0.f ? normal / length : glm::vec3{ 0.f, 1.f, 0.f };
+			rowVertices[column].texCoords = { static_cast<float>(firstSampleU + row) * texCoordScaleU, static_cast<float>(firstSampleV + column) * texCoordScaleV };
+		}
+	}
+}
+
+std::vector<float> PatchSurface::MoveWeights(uint32_t index, uint32_t pointCount, uint32_t degree, bool c1)
+{
+	std::vector<float> weights(pointCount, 0.f);
+	weights[index] = 1.f;
+
+	// Degree 1 patches have no inner point to tie across a boundary
+	if (!c1 || degree < 2)
+		return weights;
+
+	const bool onBoundary = index % degree == 0;
+
+	// A boundary point drags both of its neighbours, keeping the tangents across it
+	if (onBoundary && index > 0 && index + 1 < pointCount)
+		weights[index - 1] = weights[index + 1] = 1.f;
+
+	// Then every later boundary fixes the point after it, and every earlier one the point before it.
+	// Beyond degree 2 this stops at the first boundary on each side, degree 2 chains through every patch.
+	for (uint32_t boundary = (index / degree + 1) * degree; boundary + 1 < pointCount; boundary += degree)
+		weights[boundary + 1] = 2.f * weights[boundary] - weights[boundary - 1];
+
+	for (int64_t boundary = onBoundary ? static_cast<int64_t>(index) - degree : static_cast<int64_t>(index / degree) * degree; boundary > 0; boundary -= degree)
+		weights[boundary - 1] = 2.f * weights[boundary] - weights[boundary + 1];
+
+	return weights;
+}
@@ -0,0 +1,131 @@
+#include "SimdDeCasteljau.h"
+
+#include <Vroom/Core/Assert.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <immintrin.h>
+	#include <intrin.h>
+#endif
+
+#include "DeCasteljauLanes.h"
+
+struct ScalarLanes
+{
+	using Type = float;
+	static constexpr uint32_t Width = 1;
+
+	static Type Broadcast(float value) { return value; }
+	static Type Load(const float* values) { return *values; }
+	static void Store(float* values, Type lanes) { *values = lanes; }
+	static Type Sub(Type a, Type b) { return a - b; }
+	static Type Mul(Type a, Type b) { return a * b; }
+	static Type MulAdd(Type a, Type b, Type c) { return a * b + c; }
+};
+
+void SoaPoints::assign(const glm::vec3* points, size_t count)
+{
+	x.resize(count);
+	y.resize(count);
+	z.resize(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] = points[i].x;
+		y[i] = points[i].y;
+		z[i] = points[i].z;
+	}
+}
+
+SimdLevel SimdDeCasteljau::BestLevel()
+{
+	static const SimdLevel level = []()
+	{
+		bool avx2 = false, avx512 = false;
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		// Also checks that the OS saves the wide registers
+		__builtin_cpu_init();
+		avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		avx512 = __builtin_cpu_supports("avx512f");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		int info[4];
+		__cpuid(info, 1);
+		const bool fma = info[2] & (1 << 12);
+		const bool osxsave = info[2] & (1 << 27);
+
+		__cpuidex(info, 7, 0);
+		// XCR0: SSE and AVX state for AVX2, plus the opmask and upper ZMM states for AVX-512
+		const unsigned long long enabledStates = osxsave ? _xgetbv(0) : 0;
+		avx2 = fma && (info[1] & (1 << 5)) && (enabledStates & 0x6) == 0x6;
+		avx512 = (info[1] & (1 << 16)) && (enabledStates & 0xe6) == 0xe6;
+#endif
+
+		if (avx512 && avx2 && Avx512Kernel())
+			return SimdLevel::AVX512;
+		if (avx2 && Avx2Kernel())
+			return SimdLevel::AVX2;
+
+		return SimdLevel::Scalar;
+	}();
+
+	return level;
+}
+
+bool SimdDeCasteljau::IsSupported(SimdLevel level)
+{
+	return static_cast<int>(level) <= static_cast<int>(BestLevel());
+}
+
+uint32_t SimdDeCasteljau::LaneCount(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::AVX2:
+		return 8;
+	case SimdLevel::AVX512:
+		return 16;
+	default:
+		return 1;
+	}
+}
+
+const char* SimdDeCasteljau::LevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::AVX2:
+		return "avx2";
+	case SimdLevel::AVX512:
+		return "avx512";
+	default:
+		return "scalar";
+	}
+}
+
+void SimdDeCasteljau::EvaluateSurface(SimdLevel level, uint32_t degreeU, uint32_t degreeV, const SoaPoints& net, const float* u, const float* v, uint32_t count,
+	glm::vec3* positions, size_t positionStride, glm::vec3* tangentsU, glm::vec3* tangentsV, size_t tangentStride)
+{
+	VRM_ASSERT_MSG(degreeU <= MaxDegree && degreeV <= MaxDegree && net.size() >= static_cast<size_t>(degreeU + 1) * (degreeV + 1),
+		"Batched de Casteljau evaluation needs a complete net and degrees up to {}.", MaxDegree);
+
+	const float* components[3] = { net.x.data(), net.y.data(), net.z.data() };
+	Kernel(level).evaluateSurface(degreeU, degreeV, components, u, v, count, positions, positionStride, tangentsU, tangentsV, tangentStride);
+}
+
+const DeCasteljauKernel& SimdDeCasteljau::Kernel(SimdLevel level)
+{
+	static constexpr DeCasteljauKernel scalarKernel = { &DeCasteljauLanes<ScalarLanes>::EvaluateSurface };
+
+	if (!IsSupported(level))
+		level = BestLevel();
+
+	switch (level)
+	{
+	case SimdLevel::AVX512:
+		return *Avx512Kernel();
+	case SimdLevel::AVX2:
+		return *Avx2Kernel();
+	default:
+		return scalarKernel;
+	}
+}
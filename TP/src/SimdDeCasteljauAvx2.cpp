@@ -0,0 +1,34 @@
+#include "DeCasteljauLanes.h"
+
+// Built with AVX2 and FMA enabled, see TP/CMakeLists.txt. Only called after SimdDeCasteljau checked the CPU.
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+struct Avx2Lanes
+{
+	using Type = __m256;
+	static constexpr uint32_t Width = 8;
+
+	static Type Broadcast(float value) { return _mm256_set1_ps(value); }
+	static Type Load(const float* values) { return _mm256_load_ps(values); }
+	static void Store(float* values, Type lanes) { _mm256_store_ps(values, lanes); }
+	static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+	static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+	static Type MulAdd(Type a, Type b, Type c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+const DeCasteljauKernel* SimdDeCasteljau::Avx2Kernel()
+{
+	static constexpr DeCasteljauKernel kernel = { &DeCasteljauLanes<Avx2Lanes>::EvaluateSurface };
+	return &kernel;
+}
+
+#else
+
+const DeCasteljauKernel* SimdDeCasteljau::Avx2Kernel()
+{
+	return nullptr;
+}
+
+#endif
@@ -0,0 +1,34 @@
+#include "DeCasteljauLanes.h"
+
+// Built with AVX-512F enabled, see TP/CMakeLists.txt. Only called after SimdDeCasteljau checked the CPU.
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+struct Avx512Lanes
+{
+	using Type = __m512;
+	static constexpr uint32_t Width = 16;
+
+	static Type Broadcast(float value) { return _mm512_set1_ps(value); }
+	static Type Load(const float* values) { return _mm512_load_ps(values); }
+	static void Store(float* values, Type lanes) { _mm512_store_ps(values, lanes); }
+	static Type Sub(Type a, Type b) { return _mm512_sub_ps(a, b); }
+	static Type Mul(Type a, Type b) { return _mm512_mul_ps(a, b); }
+	static Type MulAdd(Type a, Type b, Type c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+const DeCasteljauKernel* SimdDeCasteljau::Avx512Kernel()
+{
+	static constexpr DeCasteljauKernel kernel = { &DeCasteljauLanes<Avx512Lanes>::EvaluateSurface };
+	return &kernel;
+}
+
+#else
+
+const DeCasteljauKernel* SimdDeCasteljau::Avx512Kernel()
+{
+	return nullptr;
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+static thread_local bool t_InsideTask = false;
+
+WorkerPool::WorkerPool(uint32_t workerCount)
+{
+	m_Workers.reserve(workerCount);
+
+	for (uint32_t i = 0; i < workerCount; i++)
+		m_Workers.emplace_back([this](std::stop_token stopToken) { workerLoop(stopToken); });
+}
+
+WorkerPool::~WorkerPool()
+{
+	for (auto& worker : m_Workers)
+		worker.request_stop();
+
+	m_WakeUp.notify_all();
+}
+
+WorkerPool& WorkerPool::Get()
+{
+	static WorkerPool pool(HardwareThreadCount() - 1);
+	return pool;
+}
+
+uint32_t WorkerPool::HardwareThreadCount()
+{
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void WorkerPool::parallelFor(uint32_t taskCount, uint32_t threadCount, const std::function<void(uint32_t)>& task)
+{
+	if (t_InsideTask || threadCount <= 1 || taskCount <= 1 || m_Workers.empty())
+	{
+		for (uint32_t i = 0; i < taskCount; i++)
+			task(i);
+
+		return;
+	}
+
+	std::lock_guard submitLock(m_SubmitMutex);
+
+	{
+		std::lock_guard lock(m_Mutex);
+		m_Task = &task;
+		m_TaskCount = taskCount;
+		m_NextTask = 0;
+		m_FreeSlots = std::min({ threadCount - 1, taskCount - 1, getWorkerCount() });
+		m_Generation++;
+	}
+
+	m_WakeUp.notify_all();
+
+	runTasks();
+
+	// No worker may join once the caller is done: the task only lives until we return
+	std::unique_lock lock(m_Mutex);
+	m_FreeSlots = 0;
+	m_Done.wait(lock, [this]() { return m_RunningWorkers == 0; });
+	m_Task = nullptr;
+}
+
+void WorkerPool::workerLoop(std::stop_token stopToken)
+{
+	uint64_t seenGeneration = 0;
+
+	std::unique_lock lock(m_Mutex);
+
+	while (m_WakeUp.wait(lock, stopToken, [&]() { return m_Generation != seenGeneration && m_FreeSlots > 0; }))
+	{
+		seenGeneration = m_Generation;
+		m_FreeSlots--;
+		m_RunningWorkers++;
+
+		lock.unlock();
+		runTasks();
+		lock.lock();
+
+		if (--m_RunningWorkers == 0)
+			m_Done.notify_all();
+	}
+}
+
+void WorkerPool::runTasks()
+{
+	t_InsideTask = true;
+
+	for (uint32_t i = m_NextTask++; i < m_TaskCount; i = m_NextTask++)
+		(*m_Task)(i);
+
+	t_InsideTask = false;
+}
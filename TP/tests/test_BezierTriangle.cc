@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include "BezierTriangle.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// Net over the triangle (0, 0), (10, 0), (0, 10) of the xz plane, heights in [0, 2]
+static BezierTriangle makePatch(uint32_t degree, uint32_t level, uint32_t seed)
+{
+	BezierTriangle patch(degree, level);
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> height(0.f, 2.f);
+
+	for (uint32_t i = 0; i <= degree; i++)
+		for (uint32_t j = 0; i + j <= degree; j++)
+			patch.setControlPoint(i, j, { 10.f * i / degree, height(random), 10.f * j / degree });
+
+	return patch;
+}
+
+// Sum of B(degree, i, j, k) P(i + shiftI, j + shiftJ) over i + j + k = degree, in double. Below the degree of the patch, the shifts
+// pick one of the points of the derivative differences, the third one being P(i, j) itself.
+static glm::dvec3 bernsteinSum(const BezierTriangle& patch, uint32_t degree, double u, double v, uint32_t shiftI, uint32_t shiftJ)
+{
+	const double w = 1.0 - u - v;
+	glm::dvec3 sum = glm::dvec3{ 0.0, 0.0, 0.0 };
+
+	for (uint32_t i = 0; i <= degree; i++)
+	{
+		for (uint32_t j = 0; i + j <= degree; j++)
+		{
+			const uint32_t k = degree - i - j;
+			const double basis = BarycentricBasis::Multinomial(degree, i, j) * std::pow(u, i) * std::pow(v, j) * std::pow(w, k);
+
+			sum += basis * glm::dvec3(patch.getControlPoint(i + shiftI, j + shiftJ));
+		}
+	}
+
+	return sum;
+}
+
+TEST(BezierTriangle, MatchesBernsteinSum)
+{
+	for (uint32_t degree = 1; degree <= 9; degree++)
+	{
+		for (uint32_t level : { 1u, 2u, 7u, 32u })
+		{
+			SCOPED_TRACE(testing::Message() << "degree " << degree << ", level " << level);
+
+			const BezierTriangle patch = makePatch(degree, level, degree);
+			const vrm::MeshData& mesh = patch.polygonize();
+			ASSERT_EQ(mesh.getVertexCount(), patch.getSampleCount());
+
+			for (uint32_t a = 0; a <= level; a++)
+			{
+				for (uint32_t b = 0; a + b <= level; b++)
+				{
+					const vrm::Vertex& vertex = mesh.getVertices()[BarycentricBasis::Index(level, a, b)];
+					const double u = static_cast<double>(a) / level, v = static_cast<double>(b) / level;
+
+					const glm::dvec3 position = bernsteinSum(patch, degree, u, v, 0, 0);
+					ASSERT_LE(glm::length(glm::dvec3(vertex.position) - position), 1e-5 * 10.0) << "sample (" << a << ", " << b << ")";
+
+					// dS/du and dS/dv with w = 1 - u - v: n times the differences P(i + 1, j, k) - P(i, j, k + 1) and P(i, j + 1, k) - P(i, j, k + 1)
+					const glm::dvec3 base = bernsteinSum(patch, degree - 1, u, v, 0, 0);
+					const glm::dvec3 tangentU = static_cast<double>(degree) * (bernsteinSum(patch, degree - 1, u, v, 1, 0) - base);
+					const glm::dvec3 tangentV = static_cast<double>(degree) * (bernsteinSum(patch, degree - 1, u, v, 0, 1) - base);
+					const glm::dvec3 normal = glm::normalize(glm::cross(tangentU, tangentV));
+
+					ASSERT_GT(glm::dot(glm::dvec3(vertex.normal), normal), 1.0 - 1e-6) << "sample (" << a << ", " << b << ")";
+				}
+			}
+
+			const Bezier::EvaluationError error = patch.measureEvaluationError();
+			EXPECT_LT(error.maxPositionError, 1e-5f * 10.f);
+			EXPECT_LT(error.maxNormalAngle, 0.1f);
+		}
+	}
+}
+
+TEST(BezierTriangle, TrianglesAreCounterClockwise)
+{
+	for (uint32_t degree : { 1u, 3u, 5u })
+	{
+		for (uint32_t level : { 1u, 2u, 7u, 100u })
+		{
+			SCOPED_TRACE(testing::Message() << "degree " << degree << ", level " << level);
+
+			const BezierTriangle patch = makePatch(degree, level, degree + level);
+			const vrm::MeshData& mesh = patch.polygonize();
+			const std::vector<uint32_t>& indices = mesh.getIndices();
+
+			ASSERT_EQ(indices.size(), static_cast<size_t>(level) * level * 3);
+
+			std::vector<bool> used(mesh.getVertexCount(), false);
+
+			for (size_t t = 0; t < indices.size(); t += 3)
+			{
+				const vrm::Vertex& a = mesh.getVertices()[indices[t]];
+				const vrm::Vertex& b = mesh.getVertices()[indices[t + 1]];
+				const vrm::Vertex& c = mesh.getVertices()[indices[t + 2]];
+
+				// Counter-clockwise in (u, v), like the grids of Bezier
+				const glm::vec2 ab = b.texCoords - a.texCoords, ac = c.texCoords - a.texCoords;
+				ASSERT_GT(ab.x * ac.y - ab.y * ac.x, 0.f) << "triangle " << t / 3;
+
+				// So the faces turn towards the analytic normals
+				const glm::vec3 face = glm::cross(b.position - a.position, c.position - a.position);
+				ASSERT_GT(glm::dot(face, a.normal + b.normal + c.normal), 0.f) << "triangle " << t / 3;
+
+				used[indices[t]] = used[indices[t + 1]] = used[indices[t + 2]] = true;
+			}
+
+			EXPECT_EQ(std::count(used.begin(), used.end(), false), 0);
+		}
+	}
+}
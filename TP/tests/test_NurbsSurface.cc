@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include "NurbsSurface.h"
+
+#include <cmath>
+#include <random>
+
+// Cox-de Boor recurrence as written, in double: N(i, degree) at t, half-open spans
+static double coxDeBoor(uint32_t i, uint32_t degree, double t, const std::vector<float>& knots)
+{
+	if (degree == 0)
+		return knots[i] <= t && t < knots[i + 1] ? 1.0 : 0.0;
+
+	double value = 0.0;
+
+	if (knots[i + degree] > knots[i])
+		value += (t - knots[i]) / (knots[i + degree] - knots[i]) * coxDeBoor(i, degree - 1, t, knots);
+	if (knots[i + degree + 1] > knots[i + 1])
+		value += (knots[i + degree + 1] - t) / (knots[i + degree + 1] - knots[i + 1]) * coxDeBoor(i + 1, degree - 1, t, knots);
+
+	return value;
+}
+
+// Clamped, non-uniform, with a double interior knot
+static const std::vector<float> s_KnotsU = { 0.f, 0.f, 0.f, 0.f, 0.1f, 0.4f, 0.4f, 0.7f, 1.f, 1.f, 1.f, 1.f };
+
+TEST(NurbsBasis, MatchesCoxDeBoor)
+{
+	const uint32_t degree = 3;
+	const uint32_t resolution = 53;
+	const NurbsBasis basis(degree, s_KnotsU, resolution);
+
+	for (uint32_t sample = 0; sample < resolution; sample++)
+	{
+		const double t = static_cast<double>(static_cast<float>(sample) / static_cast<float>(resolution));
+		const uint32_t span = basis.getSpan(sample);
+
+		ASSERT_LE(s_KnotsU[span], t) << "sample " << sample;
+		ASSERT_LT(t, s_KnotsU[span + 1]) << "sample " << sample;
+
+		for (uint32_t k = 0; k <= degree; k++)
+		{
+			const uint32_t i = span - degree + k;
+			EXPECT_NEAR(basis.getValues(sample)[k], coxDeBoor(i, degree, t, s_KnotsU), 1e-5) << "sample " << sample << ", N" << i;
+
+			// dN(i, p) = p / (u[i + p] - u[i]) N(i, p - 1) - p / (u[i + p + 1] - u[i + 1]) N(i + 1, p - 1)
+			double derivative = 0.0;
+			if (s_KnotsU[i + degree] > s_KnotsU[i])
+				derivative += degree / static_cast<double>(s_KnotsU[i + degree] - s_KnotsU[i]) * coxDeBoor(i, degree - 1, t, s_KnotsU);
+			if (s_KnotsU[i + degree + 1] > s_KnotsU[i + 1])
+				derivative -= degree / static_cast<double>(s_KnotsU[i + degree + 1] - s_KnotsU[i + 1]) * coxDeBoor(i + 1, degree - 1, t, s_KnotsU);
+
+			EXPECT_NEAR(basis.getDerivatives(sample)[k], derivative, 1e-3 * std::max(1.0, std::abs(derivative))) << "sample " << sample << ", N" << i;
+		}
+	}
+}
+
+TEST(NurbsSurface, OneSpanMatchesBezier)
+{
+	const uint32_t resolution = 37;
+
+	for (uint32_t degree : { 1u, 2u, 3u, 6u })
+	{
+		SCOPED_TRACE(testing::Message() << "degree " << degree);
+
+		NurbsSurface nurbs(degree, degree, degree + 1, degree + 1, resolution, resolution);
+		Bezier bezier(degree, degree, resolution, resolution);
+		bezier.setMeshLayout(Bezier::MeshLayout::IndexedGrid);
+		bezier.setNormalMode(Bezier::NormalMode::Analytic);
+		bezier.setEvaluationMode(Bezier::EvaluationMode::Direct);
+		bezier.setSimdLevel(SimdLevel::Scalar);
+
+		std::mt19937 random(degree);
+		std::uniform_real_distribution<float> height(0.f, 1.f);
+
+		for (uint32_t u = 0; u <= degree; u++)
+		{
+			for (uint32_t v = 0; v <= degree; v++)
+			{
+				const glm::vec3 p = { static_cast<float>(u), height(random), static_cast<float>(v) };
+				nurbs.setControlPoint(u, v, p);
+				bezier.setControlPoint(u, v, p);
+			}
+		}
+
+		const vrm::MeshData& nurbsMesh = nurbs.polygonize();
+		const vrm::MeshData& bezierMesh = bezier.polygonize();
+
+		ASSERT_EQ(nurbsMesh.getVertexCount(), bezierMesh.getVertexCount());
+		EXPECT_EQ(nurbsMesh.getIndices(), bezierMesh.getIndices());
+
+		for (size_t i = 0; i < nurbsMesh.getVertexCount(); i++)
+		{
+			ASSERT_LE(glm::length(nurbsMesh.getVertices()[i].position - bezierMesh.getVertices()[i].position), 1e-5f) << "vertex " << i;
+			ASSERT_LE(glm::length(nurbsMesh.getVertices()[i].normal - bezierMesh.getVertices()[i].normal), 1e-4f) << "vertex " << i;
+		}
+	}
+}
+
+TEST(NurbsSurface, RationalMatchesCoxDeBoor)
+{
+	const uint32_t degreeU = 3, degreeV = 2;
+	const uint32_t countU = 8, countV = 6;
+	const uint32_t resolution = 53;
+
+	NurbsSurface surface(degreeU, degreeV, countU, countV, resolution, resolution);
+	surface.setKnotsU(s_KnotsU);
+	const std::vector<float> knotsV = surface.getKnotsV();
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> height(0.f, 3.f), weight(0.5f, 2.5f);
+
+	for (uint32_t u = 0; u < countU; u++)
+	{
+		for (uint32_t v = 0; v < countV; v++)
+		{
+			surface.setControlPoint(u, v, { static_cast<float>(u), height(random), static_cast<float>(v) });
+			surface.setWeight(u, v, weight(random));
+		}
+	}
+
+	const vrm::MeshData& mesh = surface.polygonize();
+	ASSERT_EQ(mesh.getVertexCount(), static_cast<size_t>(resolution) * resolution);
+
+	for (uint32_t sampleU = 0; sampleU < resolution; sampleU++)
+	{
+		for (uint32_t sampleV = 0; sampleV < resolution; sampleV++)
+		{
+			const double u = static_cast<double>(static_cast<float>(sampleU) / static_cast<float>(resolution));
+			const double v = static_cast<double>(static_cast<float>(sampleV) / static_cast<float>(resolution));
+
+			glm::dvec3 numerator = glm::dvec3{ 0.0, 0.0, 0.0 };
+			double denominator = 0.0;
+
+			for (uint32_t i = 0; i < countU; i++)
+			{
+				for (uint32_t j = 0; j < countV; j++)
+				{
+					const double w = coxDeBoor(i, degreeU, u, s_KnotsU) * coxDeBoor(j, degreeV, v, knotsV) * surface.getWeight(i, j);
+					numerator += w * glm::dvec3(surface.getControlPoint(i, j));
+					denominator += w;
+				}
+			}
+
+			const glm::dvec3 expected = numerator / denominator;
+			const glm::dvec3 actual = glm::dvec3(mesh.getVertices()[static_cast<size_t>(sampleU) * resolution + sampleV].position);
+			ASSERT_LE(glm::length(actual - expected), 1e-4) << "sample (" << sampleU << ", " << sampleV << ")";
+		}
+	}
+}
+
+TEST(NurbsSurface, QuarterCylinderIsExact)
+{
+	// Quarter circle of radius 1 as a degree 2 rational curve, extruded along z
+	NurbsSurface surface(2, 1, 3, 2, 64, 8);
+	const glm::vec3 arc[3] = { { 1.f, 0.f, 0.f }, { 1.f, 1.f, 0.f }, { 0.f, 1.f, 0.f } };
+	const float weights[3] = { 1.f, std::sqrt(0.5f), 1.f };
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		for (uint32_t j = 0; j < 2; j++)
+		{
+			surface.setControlPoint(i, j, arc[i] + glm::vec3{ 0.f, 0.f, static_cast<float>(j) });
+			surface.setWeight(i, j, weights[i]);
+		}
+	}
+
+	for (const vrm::Vertex& vertex : surface.polygonize().getVertices())
+	{
+		const glm::vec3 radial = glm::vec3{ vertex.position.x, vertex.position.y, 0.f };
+
+		ASSERT_NEAR(glm::length(radial), 1.f, 1e-5f);
+		ASSERT_NEAR(std::abs(glm::dot(radial / glm::length(radial), vertex.normal)), 1.f, 1e-5f);
+	}
+}
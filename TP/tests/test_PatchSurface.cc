@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+
+#include "PatchSurface.h"
+
+#include <random>
+
+static void randomizeNet(PatchSurface& surface, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> height(-1.f, 1.f);
+
+	for (uint32_t u = 0; u < surface.getControlPointCountU(); u++)
+		for (uint32_t v = 0; v < surface.getControlPointCountV(); v++)
+			surface.setControlPoint(u, v, { static_cast<float>(u), height(random), static_cast<float>(v) });
+}
+
+// Position and partial derivatives of one patch at its own (u, v), from its sub-net
+static void evaluatePatch(const PatchSurface& surface, uint32_t patchU, uint32_t patchV, float u, float v, glm::vec3& position, glm::vec3& tangentU, glm::vec3& tangentV)
+{
+	const uint32_t degreeU = surface.getDegreeU(), degreeV = surface.getDegreeV();
+	std::vector<glm::vec3> net;
+
+	for (uint32_t i = 0; i <= degreeU; i++)
+		for (uint32_t j = 0; j <= degreeV; j++)
+			net.push_back(surface.getControlPoint(patchU * degreeU + i, patchV * degreeV + j));
+
+	const SoaPoints soaNet(net.data(), net.size());
+	SimdDeCasteljau::EvaluateSurface(SimdLevel::Scalar, degreeU, degreeV, soaNet, &u, &v, 1, &position, sizeof(glm::vec3), &tangentU, &tangentV, sizeof(glm::vec3));
+}
+
+static float distance(const glm::vec3& a, const glm::vec3& b)
+{
+	return glm::length(a - b);
+}
+
+// Compares both sides of every seam at a few points along it: positions always, first derivatives across the seam for C1
+static void expectSeamsContinuous(const PatchSurface& surface, bool c1)
+{
+	const float tolerance = 1e-4f;
+	glm::vec3 positionA, tangentUA, tangentVA, positionB, tangentUB, tangentVB;
+
+	for (float t : { 0.f, 0.3f, 0.5f, 1.f })
+	{
+		for (uint32_t patchU = 0; patchU + 1 < surface.getPatchCountU(); patchU++)
+		{
+			for (uint32_t patchV = 0; patchV < surface.getPatchCountV(); patchV++)
+			{
+				evaluatePatch(surface, patchU, patchV, 1.f, t, positionA, tangentUA, tangentVA);
+				evaluatePatch(surface, patchU + 1, patchV, 0.f, t, positionB, tangentUB, tangentVB);
+
+				EXPECT_LE(distance(positionA, positionB), tolerance) << "U seam after patch (" << patchU << ", " << patchV << ") at " << t;
+				if (c1)
+				{
+					EXPECT_LE(distance(tangentUA, tangentUB), tolerance * std::max(1.f, glm::length(tangentUA))) << "U seam after patch (" << patchU << ", " << patchV << ") at " << t;
+				}
+			}
+		}
+
+		for (uint32_t patchU = 0; patchU < surface.getPatchCountU(); patchU++)
+		{
+			for (uint32_t patchV = 0; patchV + 1 < surface.getPatchCountV(); patchV++)
+			{
+				evaluatePatch(surface, patchU, patchV, t, 1.f, positionA, tangentUA, tangentVA);
+				evaluatePatch(surface, patchU, patchV + 1, t, 0.f, positionB, tangentUB, tangentVB);
+
+				EXPECT_LE(distance(positionA, positionB), tolerance) << "V seam after patch (" << patchU << ", " << patchV << ") at " << t;
+				if (c1)
+				{
+					EXPECT_LE(distance(tangentVA, tangentVB), tolerance * std::max(1.f, glm::length(tangentVA))) << "V seam after patch (" << patchU << ", " << patchV << ") at " << t;
+				}
+			}
+		}
+	}
+}
+
+using PatchList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+static PatchList getDirtyPatches(const PatchSurface& surface)
+{
+	PatchList patches;
+
+	for (uint32_t patchU = 0; patchU < surface.getPatchCountU(); patchU++)
+		for (uint32_t patchV = 0; patchV < surface.getPatchCountV(); patchV++)
+			if (surface.isPatchDirty(patchU, patchV))
+				patches.push_back({ patchU, patchV });
+
+	return patches;
+}
+
+TEST(PatchSurface, C0SeamsMatch)
+{
+	std::mt19937 random(3);
+
+	for (uint32_t degree : { 1u, 2u, 3u })
+	{
+		SCOPED_TRACE(testing::Message() << "degree " << degree);
+
+		PatchSurface surface(3, 2, degree, degree, 4, 4);
+		randomizeNet(surface, random);
+
+		expectSeamsContinuous(surface, false);
+
+		// Seam vertices are shared: every sample of the grid is one vertex, written once
+		const vrm::MeshData& mesh = surface.polygonize();
+		EXPECT_EQ(mesh.getVertexCount(), static_cast<size_t>(3 * 4 + 1) * (2 * 4 + 1));
+	}
+}
+
+TEST(PatchSurface, C1SeamsMatchAfterMoves)
+{
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> offset(-1.f, 1.f);
+
+	for (auto [degreeU, degreeV] : { std::pair{ 2u, 2u }, { 3u, 3u }, { 2u, 4u } })
+	{
+		SCOPED_TRACE(testing::Message() << "degrees " << degreeU << "x" << degreeV);
+
+		PatchSurface surface(3, 3, degreeU, degreeV, 4, 4);
+		randomizeNet(surface, random);
+		surface.setContinuity(PatchSurface::Continuity::C1);
+		expectSeamsContinuous(surface, true);
+
+		// Boundary points, their neighbours and inner points alike
+		for (int move = 0; move < 40; move++)
+		{
+			const uint32_t u = random() % surface.getControlPointCountU();
+			const uint32_t v = random() % surface.getControlPointCountV();
+			const glm::vec3 p = surface.getControlPoint(u, v) + glm::vec3{ offset(random), offset(random), offset(random) };
+
+			surface.setControlPoint(u, v, p);
+
+			EXPECT_EQ(surface.getControlPoint(u, v), p);
+		}
+
+		expectSeamsContinuous(surface, true);
+	}
+}
+
+TEST(PatchSurface, MovesRetessellateDirtyPatchesOnly)
+{
+	std::mt19937 random(9);
+
+	PatchSurface surface(3, 3, 3, 3, 5, 5);
+	randomizeNet(surface, random);
+	surface.polygonize();
+	surface.clearDirtyVertexRange();
+	EXPECT_TRUE(surface.isMeshUpToDate());
+
+	// Inner point of patch (1, 2)
+	surface.setControlPoint(4, 7, glm::vec3{ 4.f, 2.f, 7.f });
+	EXPECT_EQ(getDirtyPatches(surface), PatchList({ { 1, 2 } }));
+
+	// Corner shared by patches (0, 0), (0, 1), (1, 0) and (1, 1)
+	surface.setControlPoint(3, 3, glm::vec3{ 3.f, -2.f, 3.f });
+	EXPECT_EQ(getDirtyPatches(surface), PatchList({ { 0, 0 }, { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, 2 } }));
+
+	EXPECT_FALSE(surface.isMeshUpToDate());
+
+	surface.polygonize();
+	EXPECT_EQ(surface.getLastTessellatedPatchCount(), 5);
+	EXPECT_TRUE(getDirtyPatches(surface).empty());
+}
+
+TEST(PatchSurface, DirtyRangeCoversChangedVertices)
+{
+	std::mt19937 random(13);
+
+	PatchSurface surface(3, 4, 3, 2, 5, 6);
+	randomizeNet(surface, random);
+	const std::vector<vrm::Vertex> before = surface.polygonize().getVertices();
+	surface.clearDirtyVertexRange();
+
+	// Inner point of patch (2, 1), then a point on the seam between patches (0, 3) and (1, 3)
+	surface.setControlPoint(7, 3, glm::vec3{ 7.f, 3.f, 3.f });
+	surface.setControlPoint(3, 7, glm::vec3{ 3.f, -3.f, 7.f });
+	EXPECT_EQ(getDirtyPatches(surface), PatchList({ { 0, 3 }, { 1, 3 }, { 2, 1 } }));
+
+	const std::vector<vrm::Vertex> after = surface.polygonize().getVertices();
+	const PatchSurface::VertexRange range = surface.getDirtyVertexRange();
+
+	EXPECT_EQ(surface.getLastTessellatedPatchCount(), 3);
+	EXPECT_TRUE(surface.isMeshUpToDate());
+	ASSERT_LE(range.first + range.count, after.size());
+
+	size_t changedCount = 0;
+	for (size_t i = 0; i < after.size(); i++)
+	{
+		if (after[i].position == before[i].position && after[i].normal == before[i].normal)
+			continue;
+
+		changedCount++;
+		EXPECT_GE(i, range.first) << "vertex " << i;
+		EXPECT_LT(i, range.first + range.count) << "vertex " << i;
+	}
+	EXPECT_GT(changedCount, 0);
+
+	// Patched in place, the mesh is the one of a surface tessellated from scratch
+	PatchSurface reference(3, 4, 3, 2, 5, 6);
+	for (uint32_t u = 0; u < surface.getControlPointCountU(); u++)
+		for (uint32_t v = 0; v < surface.getControlPointCountV(); v++)
+			reference.setControlPoint(u, v, surface.getControlPoint(u, v));
+
+	const std::vector<vrm::Vertex>& expected = reference.polygonize().getVertices();
+	ASSERT_EQ(expected.size(), after.size());
+	for (size_t i = 0; i < after.size(); i++)
+	{
+		ASSERT_EQ(after[i].position, expected[i].position) << "vertex " << i;
+		ASSERT_EQ(after[i].normal, expected[i].normal) << "vertex " << i;
+	}
+
+	// Nothing left to tessellate
+	surface.clearDirtyVertexRange();
+	surface.polygonize();
+	EXPECT_EQ(surface.getDirtyVertexRange().count, 0);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include "SimdDeCasteljau.h"
+
+#include <random>
+
+// Sample counts around the lane widths, so that every kernel runs partial batches as well as full ones
+static const uint32_t s_SampleCounts[] = { 1, 3, 7, 8, 9, 15, 16, 17, 31, 33, 100 };
+
+struct Samples
+{
+	std::vector<glm::vec3> positions, tangentsU, tangentsV;
+};
+
+static std::vector<glm::vec3> makeNet(uint32_t degreeU, uint32_t degreeV, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> height(-1.f, 1.f);
+	std::vector<glm::vec3> net;
+
+	for (uint32_t i = 0; i <= degreeU; i++)
+		for (uint32_t j = 0; j <= degreeV; j++)
+			net.push_back({ static_cast<float>(i), height(random), static_cast<float>(j) });
+
+	return net;
+}
+
+// One sample more than count in every output, left untouched by the kernel
+static Samples evaluate(SimdLevel level, uint32_t degreeU, uint32_t degreeV, const SoaPoints& net, const std::vector<float>& u, const std::vector<float>& v, uint32_t count)
+{
+	const glm::vec3 guard = glm::vec3{ 1e9f, 1e9f, 1e9f };
+	Samples samples = { std::vector<glm::vec3>(count + 1, guard), std::vector<glm::vec3>(count + 1, guard), std::vector<glm::vec3>(count + 1, guard) };
+
+	SimdDeCasteljau::EvaluateSurface(level, degreeU, degreeV, net, u.data(), v.data(), count,
+		samples.positions.data(), sizeof(glm::vec3), samples.tangentsU.data(), samples.tangentsV.data(), sizeof(glm::vec3));
+
+	return samples;
+}
+
+static void expectNear(const std::vector<glm::vec3>& actual, const std::vector<glm::vec3>& expected, float tolerance)
+{
+	ASSERT_EQ(actual.size(), expected.size());
+
+	for (size_t s = 0; s < actual.size(); s++)
+	{
+		const float scale = std::max(1.f, glm::length(expected[s]));
+		ASSERT_LE(glm::length(actual[s] - expected[s]), tolerance * scale) << "sample " << s;
+	}
+}
+
+TEST(SimdDeCasteljau, LevelsMatchScalar)
+{
+	if (SimdDeCasteljau::BestLevel() == SimdLevel::Scalar)
+		GTEST_SKIP() << "No SIMD level supported by this CPU";
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> parameter(0.f, 1.f);
+
+	for (SimdLevel level : { SimdLevel::AVX2, SimdLevel::AVX512 })
+	{
+		if (!SimdDeCasteljau::IsSupported(level))
+			continue;
+
+		for (auto [degreeU, degreeV] : { std::pair{ 0u, 0u }, { 1u, 1u }, { 1u, 3u }, { 3u, 3u }, { 5u, 2u }, { 7u, 9u }, { 12u, 12u } })
+		{
+			const std::vector<glm::vec3> points = makeNet(degreeU, degreeV, random);
+			const SoaPoints net(points.data(), points.size());
+
+			for (uint32_t count : s_SampleCounts)
+			{
+				SCOPED_TRACE(testing::Message() << SimdDeCasteljau::LevelName(level) << ", degrees " << degreeU << "x" << degreeV << ", " << count << " samples");
+
+				std::vector<float> u(count), v(count);
+				for (uint32_t s = 0; s < count; s++)
+				{
+					u[s] = parameter(random);
+					v[s] = parameter(random);
+				}
+
+				const Samples expected = evaluate(SimdLevel::Scalar, degreeU, degreeV, net, u, v, count);
+				const Samples actual = evaluate(level, degreeU, degreeV, net, u, v, count);
+
+				// Fused multiply-adds round differently than the scalar kernel, and the guard sample is compared exactly
+				expectNear(actual.positions, expected.positions, 1e-5f);
+				expectNear(actual.tangentsU, expected.tangentsU, 1e-4f);
+				expectNear(actual.tangentsV, expected.tangentsV, 1e-4f);
+				EXPECT_EQ(actual.positions[count], expected.positions[count]);
+				EXPECT_EQ(actual.tangentsU[count], expected.tangentsU[count]);
+			}
+		}
+	}
+}
+
+TEST(SimdDeCasteljau, PositionsOnly)
+{
+	std::mt19937 random(11);
+	const std::vector<glm::vec3> points = makeNet(4, 3, random);
+	const SoaPoints net(points.data(), points.size());
+
+	// Positions written into the vertices of a mesh, tangents not asked for
+	constexpr uint32_t count = 19;
+	std::vector<float> u(count), v(count);
+	for (uint32_t s = 0; s < count; s++)
+	{
+		u[s] = static_cast<float>(s) / (count - 1);
+		v[s] = 1.f - u[s];
+	}
+
+	const Samples expected = evaluate(SimdLevel::Scalar, 4, 3, net, u, v, count);
+
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512 })
+	{
+		if (!SimdDeCasteljau::IsSupported(level))
+			continue;
+
+		SCOPED_TRACE(SimdDeCasteljau::LevelName(level));
+
+		struct Vertex
+		{
+			glm::vec3 position;
+			glm::vec3 normal;
+		};
+		std::vector<Vertex> vertices(count, Vertex{ glm::vec3{ 0.f, 0.f, 0.f }, glm::vec3{ 2.f, 2.f, 2.f } });
+
+		SimdDeCasteljau::EvaluateSurface(level, 4, 3, net, u.data(), v.data(), count, &vertices.data()->position, sizeof(Vertex), nullptr, nullptr, 0);
+
+		for (uint32_t s = 0; s < count; s++)
+		{
+			ASSERT_LE(glm::length(vertices[s].position - expected.positions[s]), 1e-5f * std::max(1.f, glm::length(expected.positions[s])));
+			ASSERT_EQ(vertices[s].normal, glm::vec3(2.f, 2.f, 2.f));
+		}
+	}
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 #include "Vroom/Asset/AssetData/Vertex.h"
@@ -10,8 +12,41 @@ namespace vrm
 class MeshData
 {
 public:
-    MeshData(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
-    MeshData(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices);
+    enum class PrimitiveType
+    {
+        // 3 indices per triangle
+        Triangles = 0,
+        // Strips of triangles, separated by RestartIndex
+        TriangleStrip
+    };
+
+    enum class IndexFormat
+    {
+        UInt32 = 0,
+        UInt16
+    };
+
+    // Ends a strip. Narrowed to 16 bits it stays all ones, the fixed restart index of the GPU.
+    static constexpr uint32_t RestartIndex = 0xFFFFFFFF;
+    // Most vertices that 16 bit indices can address, 0xFFFF being the restart index
+    static constexpr size_t MaxUInt16VertexCount = 0xFFFF;
+
+    /**
+     * @brief A coarser level of detail: its own indices into the vertices of the mesh.
+     */
+    struct LodLevel
+    {
+        std::vector<uint32_t> indices;
+        // Largest projected size, in fraction of the viewport height, at which this level is drawn
+        float screenSize;
+    };
+
+public:
+    /**
+     * @brief Indices are kept in 32 bits. The index format tells whether they fit in 16 bits, which is the case whenever the vertex count allows.
+     */
+    MeshData(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, PrimitiveType primitiveType = PrimitiveType::Triangles);
+    MeshData(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices, PrimitiveType primitiveType = PrimitiveType::Triangles);
 
     MeshData();
     MeshData(const MeshData& other);
@@ -21,18 +56,69 @@ public:
     ~MeshData();
 
     const Vertex* getRawVericesData() const { return m_Vertices.data(); }
+    Vertex* getRawVericesData() { return m_Vertices.data(); }
     const uint32_t* getRawIndicesData() const { return m_Indices.data(); }
 
     const std::vector<Vertex>& getVertices() const { return m_Vertices; }
     const std::vector<uint32_t>& getIndices() const { return m_Indices; }
 
-    size_t getIndexCount() const { return m_Indices.size(); }
-    size_t getTriangleCount() const { return getIndexCount() / 3; }
-    size_t getVertexCount() const { return m_Vertices.size(); }
+    /**
+     * @brief Overwrites vertexCount vertices starting at firstVertex. Indices are left untouched.
+     */
+    void updateVertices(size_t firstVertex, const Vertex* vertices, size_t vertexCount);
+
+    /**
+     * @brief Frees the vertices and the indices of every level, for meshes that only need to live on the GPU once uploaded.
+     * Counts, formats and LOD screen sizes are kept, so that the mesh can still be described and its levels selected.
+     */
+    void releaseGeometry();
+    bool isGeometryReleased() const { return m_GeometryReleased; }
+
+    /**
+     * @brief Describes geometry held elsewhere, such as a mapped file, without copying it: the mesh is created released, with the counts and formats of that geometry.
+     */
+    static MeshData Released(size_t vertexCount, const uint32_t* indices, size_t indexCount, PrimitiveType primitiveType = PrimitiveType::Triangles);
+
+    // Counts stay valid after releaseGeometry
+    size_t getIndexCount() const { return m_IndexCount; }
+    // Counted once, strips included
+    size_t getTriangleCount() const { return m_TriangleCount; }
+    size_t getVertexCount() const { return m_VertexCount; }
+
+    PrimitiveType getPrimitiveType() const { return m_PrimitiveType; }
+    IndexFormat getIndexFormat() const { return m_IndexFormat; }
+
+    /**
+     * @brief Adds a coarser level of detail, sharing the vertices and the primitive type of the mesh. The indices of the mesh are level 0.
+     * Levels go from the finest to the coarsest, so screen sizes must decrease from one level to the next.
+     */
+    void addLodLevel(std::vector<uint32_t>&& indices, float screenSize);
+    void clearLodLevels();
+
+    const std::vector<LodLevel>& getLodLevels() const { return m_LodLevels; }
+    // Level 0 included
+    size_t getLodCount() const { return m_LodLevels.size() + 1; }
+    const std::vector<uint32_t>& getLodIndices(size_t lod) const;
+
+    /**
+     * @brief Gets the coarsest level that may be drawn at a projected size, in fraction of the viewport height. 0 when no coarser level may.
+     */
+    size_t selectLod(float screenSize) const;
+
+    static IndexFormat SmallestIndexFormat(size_t vertexCount);
+    static size_t CountTriangles(const std::vector<uint32_t>& indices, PrimitiveType primitiveType);
+    static size_t CountTriangles(const uint32_t* indices, size_t indexCount, PrimitiveType primitiveType);
 
 private:
     std::vector<Vertex> m_Vertices;
     std::vector<uint32_t> m_Indices;
+    std::vector<LodLevel> m_LodLevels;
+    PrimitiveType m_PrimitiveType = PrimitiveType::Triangles;
+    IndexFormat m_IndexFormat = IndexFormat::UInt16;
+    size_t m_TriangleCount = 0;
+    size_t m_VertexCount = 0;
+    size_t m_IndexCount = 0;
+    bool m_GeometryReleased = false;
 };
 
 } // namespace vrm
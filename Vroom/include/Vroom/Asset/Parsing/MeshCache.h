@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Vroom/Asset/AssetData/MeshData.h"
+#include "Vroom/Core/MappedFile.h"
+
+namespace vrm
+{
+
+/**
+ * @brief Binary copy of the meshes parsed from a source file, written next to it as <source>.vmesh and mapped in memory on later loads.
+ * Vertices are stored as Vertex, back to back for every mesh of the file, then indices as 32 bit ones relative to their mesh:
+ * exactly the arrays of MeshData, so that loading uploads contiguous ranges of the mapping with no conversion, and copies them only to keep them on the CPU.
+ *
+ * The file records the size, modification time and hash of its source. Size and time matching, the cache is used without reading the source.
+ * When only the time changed, the source is hashed: same content, the cache is kept and its time updated, else it is outdated.
+ * Files of another version or vertex layout are outdated too, and so are files whose meshes were processed differently after parsing, as told by their processing key.
+ */
+class MeshCache
+{
+public:
+    // Bumped whenever the layout of the file, or the meshes parsed from a source, change
+    static constexpr uint32_t Version = 3;
+
+    /**
+     * @brief A mesh of the cache, pointing into the mapped file. Valid while the cache is open.
+     */
+    struct MeshView
+    {
+        std::string_view name;
+        std::string_view materialName;
+        MeshData::PrimitiveType primitiveType;
+        const Vertex* vertices;
+        size_t vertexCount;
+        const uint32_t* indices;
+        size_t indexCount;
+    };
+
+public:
+    MeshCache() = default;
+
+    /**
+     * @brief Maps the cache of a source file.
+     *
+     * @param sourcePath  The source file, not the cache.
+     * @param processingKey  What was done to the meshes after parsing, 0 for nothing. Must match the key the cache was written with.
+     * @return False if there is no cache, or if it is outdated, truncated or of another version.
+     */
+    bool open(const std::string& sourcePath, uint64_t processingKey = 0);
+    void close();
+
+    bool isOpen() const { return m_Header != nullptr; }
+
+    size_t getMeshCount() const;
+    MeshView getMesh(size_t index) const;
+
+    /**
+     * @brief Writes the cache of a source file, replacing the previous one. The file is written aside, then renamed, so that readers never see half of it.
+     *
+     * @param sourcePath  The source file the meshes were parsed from.
+     * @param meshes  The meshes, level 0 only, with their geometry.
+     * @param names  The name of every mesh.
+     * @param materialNames  The material of every mesh, as named by the source.
+     * @param processingKey  What was done to the meshes after parsing, 0 for nothing.
+     * @return False if the source or the cache could not be accessed.
+     */
+    static bool Write(const std::string& sourcePath, const std::vector<MeshData>& meshes, const std::vector<std::string>& names, const std::vector<std::string>& materialNames,
+        uint64_t processingKey = 0);
+
+    static std::string CachePath(const std::string& sourcePath) { return sourcePath + ".vmesh"; }
+
+    // 64 bit hash of a buffer, for change detection only
+    static uint64_t Hash(const std::byte* data, size_t size);
+
+private:
+    struct FileHeader;
+    struct MeshEntry;
+
+    // Reads the source to hash it, 0 if it cannot be read
+    static uint64_t HashFile(const std::string& filePath);
+    bool validate() const;
+
+private:
+    MappedFile m_File;
+    const FileHeader* m_Header = nullptr;
+    const MeshEntry* m_Entries = nullptr;
+};
+
+} // namespace vrm
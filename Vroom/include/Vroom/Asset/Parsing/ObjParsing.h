@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Vroom/Asset/AssetData/MeshData.h"
+
+namespace vrm
+{
+
+/**
+ * @brief Wavefront OBJ parser, producing MeshData directly.
+ * The file is mapped in memory and cut into chunks at line ends, which are parsed in parallel with std::from_chars. Chunks are then stitched in order:
+ * a mesh is a run of faces sharing their object or group and their material, and every distinct position/texture coordinate/normal triplet
+ * of a mesh becomes one vertex, found again through a flat hash table. Meshes are built in parallel too.
+ * Polygons are triangulated as fans. Vertices without a normal get the area weighted average of the normals of their faces.
+ */
+class ObjParsing
+{
+public:
+    struct ParsedMesh
+    {
+        // From the last o or g statement
+        std::string name;
+        // From the last usemtl statement, empty if none
+        std::string materialName;
+        MeshData meshData;
+    };
+
+    struct ParsingResults
+    {
+        std::vector<ParsedMesh> meshes;
+        // Chunks the text was cut into, 1 if the calling thread parsed it alone
+        size_t chunkCount = 0;
+    };
+
+public:
+    ObjParsing() = delete;
+
+    /**
+     * @brief Parses an OBJ file.
+     *
+     * @param filePath  The file to parse.
+     * @param threadCount  Threads parsing the file, 0 for every hardware thread.
+     * @return Nothing if the file cannot be read, has a malformed statement, references a missing element or has no face.
+     */
+    static std::optional<ParsingResults> Parse(const std::string& filePath, uint32_t threadCount = 0);
+
+    // Same, from the text of an OBJ file
+    static std::optional<ParsingResults> ParseText(std::string_view text, uint32_t threadCount = 0);
+
+    // Chunks are at least this large, so that small files are parsed by the calling thread alone
+    static constexpr size_t MinChunkSize = 1 << 20;
+};
+
+} // namespace vrm
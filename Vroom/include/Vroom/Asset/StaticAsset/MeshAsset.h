@@ -1,28 +1,52 @@
 #pragma once
 
-#include <list>
+#include <cstdint>
+#include <vector>
 
 #include "Vroom/Asset/StaticAsset/StaticAsset.h"
 #include "Vroom/Asset/AssetInstance/MeshInstance.h"
 #include "Vroom/Asset/AssetData/MeshData.h"
+#include "Vroom/Asset/AssetData/MeshOptimizer.h"
 #include "Vroom/Render/RenderObject/RenderMesh.h"
 #include "Vroom/Asset/AssetInstance/MaterialInstance.h"
+#include "Vroom/Render/Camera/CameraBasic.h"
 
 namespace vrm
 {
 
+class MeshCache;
+
 class MeshAsset : public StaticAsset
 {
 public:
     using InstanceType = MeshInstance;
 
+    // Index of a submesh in getSubMeshes(), valid until clear
+    using SubMeshHandle = uint32_t;
+
     struct SubMesh
     {
-        SubMesh(RenderMesh&& render, MeshData&& data, MaterialInstance instance);
+        // The bounds are computed from vertices, which are those of data unless its geometry is held elsewhere
+        SubMesh(MeshData&& data, const Vertex* vertices, size_t vertexCount, MaterialInstance instance, uint32_t renderMeshIndex, uint32_t meshIndex);
+
+        /**
+         * @brief Gets the level of detail to draw with a model matrix, from the size of the bounding sphere on screen.
+         * 
+         * @param model  The model matrix.
+         * @param camera  The camera drawing the submesh.
+         */
+        size_t selectLod(const glm::mat4& model, const CameraBasic& camera) const;
 
-        RenderMesh renderMesh;
         MeshData meshData;
         MaterialInstance materialInstance;
+
+        // Buffers the submesh is drawn from, and its mesh in them
+        uint32_t renderMeshIndex;
+        uint32_t meshIndex;
+
+        // Bounding sphere of the vertices, in model space
+        glm::vec3 boundsCenter;
+        float boundsRadius;
     };
 
 public:
@@ -31,10 +55,77 @@ public:
 
     [[nodiscard]] MeshInstance createInstance();
 
-    const std::list<SubMesh>& getSubMeshes() const { return m_SubMeshes; }
+    // Stored contiguously, in the order they were added
+    const std::vector<SubMesh>& getSubMeshes() const { return m_SubMeshes; }
+    const SubMesh& getSubMesh(SubMeshHandle handle) const;
+    const RenderMesh& getRenderMesh(const SubMesh& subMesh) const { return m_RenderMeshes[subMesh.renderMeshIndex]; }
+    // Vertex and index buffer pairs, shared by the submeshes added together
+    size_t getRenderMeshCount() const { return m_RenderMeshes.size(); }
+
+    /**
+     * @brief Gets the indices drawing a level of detail of a submesh, in the index buffer of its render mesh.
+     * 
+     * @param handle  The submesh.
+     * @param lod  The level of detail, 0 being the submesh itself.
+     */
+    const RenderMesh::DrawRange& getDrawRange(SubMeshHandle handle, size_t lod = 0) const;
+
+    SubMeshHandle addSubmesh(const MeshData& mesh, MaterialInstance instance);
+    SubMeshHandle addSubmesh(const MeshData& mesh);
+    // Take the mesh over: its vertices and indices are moved into the submesh, never copied
+    SubMeshHandle addSubmesh(MeshData&& mesh, MaterialInstance instance);
+    SubMeshHandle addSubmesh(MeshData&& mesh);
+
+    /**
+     * @brief Adds submeshes sharing one vertex buffer and one index buffer, so that drawing them binds the buffers once.
+     * They must share their primitive type.
+     * 
+     * @param meshes  The meshes, taken over.
+     * @param instances  The material of every mesh.
+     * @return The handles of the submeshes, in the order of the meshes.
+     */
+    std::vector<SubMeshHandle> addSharedSubmeshes(std::vector<MeshData>&& meshes, const std::vector<MaterialInstance>& instances);
 
-    void addSubmesh(const MeshData& mesh, MaterialInstance instance);
-    void addSubmesh(const MeshData& mesh);
+    /**
+     * @brief Sets whether the submeshes added from now on keep their mesh data once uploaded, which is the default.
+     * Without it, vertices and indices only live on the GPU, for meshes that are never read back.
+     * Counts, bounds and LOD selection still work.
+     * 
+     * @param keepMeshData  False to release the mesh data right after the upload.
+     */
+    void setKeepMeshData(bool keepMeshData) { m_KeepMeshData = keepMeshData; }
+    bool getKeepMeshData() const { return m_KeepMeshData; }
+
+    /**
+     * @brief Sets whether the submeshes added from now on, files loaded included, are reordered by MeshOptimizer before the upload.
+     * The mesh cache of a file is written optimized, and only used when optimized with the same settings.
+     * 
+     * @param optimizeMeshes  True to optimize.
+     * @param settings  The steps to run. Vertex fetch reordering renumbers vertices: leave it off for submeshes updated with updateSubmeshVertices.
+     */
+    void setOptimizeMeshes(bool optimizeMeshes, const MeshOptimizer::Settings& settings = MeshOptimizer::Settings());
+    bool getOptimizeMeshes() const { return m_OptimizeMeshes; }
+    const MeshOptimizer::Settings& getOptimizerSettings() const { return m_OptimizerSettings; }
+
+    // Vertex cache statistics of every submesh optimized since the last clear, summed
+    const MeshOptimizer::Report& getOptimizationReport() const { return m_OptimizationReport; }
+
+    /**
+     * @brief Sets whether mesh assets created from now on optimize their meshes, with the default settings, which is off by default.
+     * This is how assets loaded through the AssetManager opt in, since they load as soon as they are created.
+     */
+    static void SetOptimizeMeshesByDefault(bool optimizeMeshes) { s_OptimizeMeshesByDefault = optimizeMeshes; }
+    static bool GetOptimizeMeshesByDefault() { return s_OptimizeMeshesByDefault; }
+
+    /**
+     * @brief Overwrites a range of vertices of a submesh, both in its mesh data, unless released, and in its GPU buffer.
+     * 
+     * @param handle  The submesh.
+     * @param firstVertex  First vertex to overwrite, from the start of the submesh.
+     * @param vertices  The new vertices.
+     * @param vertexCount  Number of vertices to overwrite.
+     */
+    void updateSubmeshVertices(SubMeshHandle handle, size_t firstVertex, const Vertex* vertices, size_t vertexCount);
 
     void clear();
 
@@ -42,10 +133,31 @@ protected:
     bool loadImpl(const std::string& filePath) override;
 
 private:
+    // Maps the mesh cache of the file when it is up to date, else parses the file and writes the cache
     bool loadObj(const std::string& filePath);
+    bool loadCache(const MeshCache& cache, const std::string& filePath, const std::string& fileDirectoryPath);
+
+    // Optimizes the meshes if set to
+    void optimizeMeshes(std::vector<MeshData>& meshes);
+    std::vector<SubMeshHandle> uploadSubmeshes(std::vector<MeshData>&& meshes, const std::vector<MaterialInstance>& instances);
+    // Uploads the geometries, which may be held outside of the meshes, the meshes only becoming the CPU side of the submeshes
+    std::vector<SubMeshHandle> uploadSubmeshes(const std::vector<RenderMesh::MeshGeometry>& geometries, std::vector<MeshData>&& meshes, const std::vector<MaterialInstance>& instances);
+    // Identifies the optimizer settings in the mesh cache, 0 when not optimizing
+    uint64_t getCacheProcessingKey() const;
+
+    // With its trailing separator, empty when the path has none
+    static std::string GetDirectoryPath(const std::string& filePath);
+    static MaterialInstance GetObjMaterial(const std::string& fileDirectoryPath, const std::string& materialName);
 
 private:
-    std::list<SubMesh> m_SubMeshes;
+    std::vector<SubMesh> m_SubMeshes;
+    std::vector<RenderMesh> m_RenderMeshes;
+    bool m_KeepMeshData = true;
+    bool m_OptimizeMeshes;
+    MeshOptimizer::Settings m_OptimizerSettings;
+    MeshOptimizer::Report m_OptimizationReport;
+
+    static bool s_OptimizeMeshesByDefault;
 };
 
 } // namespace vrm
\ No newline at end of file
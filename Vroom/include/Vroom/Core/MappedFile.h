@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace vrm
+{
+
+/**
+ * @brief Read only view of a whole file, mapped in memory. Pages are read by the system when first touched, and shared with its file cache.
+ *
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+
+    ~MappedFile();
+
+    /**
+     * @brief Maps a file, unmapping the previous one.
+     *
+     * @param filePath  The file to map.
+     * @return False if the file could not be opened or mapped. Empty files open, with a null data pointer.
+     */
+    bool open(const std::string& filePath);
+
+    /**
+     * @brief Unmaps the file. Pointers into it become invalid.
+     *
+     */
+    void close();
+
+    bool isOpen() const { return m_IsOpen; }
+
+    const std::byte* getData() const { return m_Data; }
+    size_t getSize() const { return m_Size; }
+
+private:
+    const std::byte* m_Data = nullptr;
+    size_t m_Size = 0;
+    bool m_IsOpen = false;
+};
+
+} // namespace vrm
@@ -10,6 +10,13 @@ public:
 	 */
 	IndexBuffer(const unsigned int* data, unsigned int count);
 
+	/**
+	 * @brief Constructs an IndexBuffer object of 16 bit indices.
+	 * @param data Raw pointer to indices data.
+	 * @param count Total indices count.
+	 */
+	IndexBuffer(const unsigned short* data, unsigned int count);
+
 	IndexBuffer(const IndexBuffer&) = delete;
 	IndexBuffer& operator=(const IndexBuffer&) = delete;
 
@@ -37,7 +44,28 @@ public:
 	 */
 	inline unsigned int getCount() const { return m_Count; }
 
+	/**
+	 * @brief Gets the OpenGL type of the indices.
+	 * @return GL_UNSIGNED_INT or GL_UNSIGNED_SHORT.
+	 */
+	inline unsigned int getIndexType() const { return m_IndexType; }
+
+	/**
+	 * @brief Gets the size of an index.
+	 * @return Size of an index in bytes.
+	 */
+	unsigned int getIndexSize() const;
+
+	/**
+	 * @brief Overwrites a part of the buffer. The buffer keeps its size.
+	 * @param data Raw pointer to the new indices, of the type of the buffer.
+	 * @param count Count of the new indices.
+	 * @param firstIndex Index of the first one to overwrite.
+	 */
+	void setSubData(const void* data, unsigned int count, unsigned int firstIndex);
+
 private:
 	unsigned int m_RendererID;
 	unsigned int m_Count;
+	unsigned int m_IndexType;
 };
\ No newline at end of file
@@ -32,6 +32,14 @@ public:
 	 */
 	void unbind() const;
 
+	/**
+	 * @brief Overwrites a part of the buffer. The buffer keeps its size.
+	 * @param data Raw pointer to the new data.
+	 * @param size Size of the new data in bytes.
+	 * @param offset Offset in bytes from the beginning of the buffer.
+	 */
+	void setSubData(const void* data, unsigned int size, unsigned int offset);
+
 private:
 	unsigned int m_RendererID;
 };
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
+#include <vector>
+
 #include "Vroom/Asset/AssetData/MeshData.h"
 
 #include "Vroom/Render/Abstraction/VertexArray.h"
@@ -10,11 +14,51 @@
 namespace vrm
 {
 
+/**
+ * @brief One vertex buffer and one index buffer on the GPU, holding one or more meshes one after the other.
+ * Every level of detail of every mesh is a range of the index buffer, drawn with the base vertex of its mesh,
+ * so that indices stay relative to the vertices of their own mesh.
+ */
 class RenderMesh
 {
+public:
+    struct DrawRange
+    {
+        // In indices, from the start of the index buffer
+        size_t firstIndex = 0;
+        size_t indexCount = 0;
+        // Added by the GPU to every index of the range
+        int32_t baseVertex = 0;
+    };
+
+    /**
+     * @brief The geometry of one mesh, read where it is held, so that it can be uploaded from memory that is not a MeshData, such as a mapped file.
+     */
+    struct MeshGeometry
+    {
+        const Vertex* vertices = nullptr;
+        size_t vertexCount = 0;
+        // Level 0 first, then every coarser level
+        std::vector<std::span<const uint32_t>> lodIndices;
+        MeshData::PrimitiveType primitiveType = MeshData::PrimitiveType::Triangles;
+
+        // Points into meshData, which must keep its geometry while this is used
+        static MeshGeometry FromMeshData(const MeshData& meshData);
+    };
+
 public:
     RenderMesh(const MeshData& meshData);
 
+    /**
+     * @brief Packs several meshes in the same buffers. They must share their primitive type.
+     * Indices are 16 bit ones when the largest mesh allows it, whatever the total vertex count.
+     *
+     * @param meshes  The meshes, in the order of their index in getDrawRange.
+     */
+    RenderMesh(const std::vector<const MeshData*>& meshes);
+    // Same, from geometry held by the caller, which is only read during the upload
+    RenderMesh(const std::vector<MeshGeometry>& meshes);
+
     RenderMesh(const RenderMesh&) = delete;
     RenderMesh& operator=(const RenderMesh&) = delete;
 
@@ -23,14 +67,44 @@ public:
 
     ~RenderMesh();
 
+    /**
+     * @brief Uploads a range of vertices of meshData again, without touching the rest of the GPU buffer.
+     * meshData must have the same vertex count as the mesh this RenderMesh was created from.
+     */
+    void updateVertices(const MeshData& meshData, size_t firstVertex, size_t vertexCount);
+    // Same, from vertices held by the caller, for meshes whose data was released. firstVertex counts from the start of the buffer.
+    void updateVertices(size_t firstVertex, const Vertex* vertices, size_t vertexCount);
+
     const VertexArray& getVertexArray() const { return m_VertexArray; }
     const IndexBuffer& getIndexBuffer() const { return m_IndexBuffer; }
 
+    size_t getMeshCount() const { return m_DrawRanges.size(); }
+    // Levels of detail of a mesh, level 0 included
+    size_t getLodCount(size_t mesh) const { return m_DrawRanges[mesh].size(); }
+    /**
+     * @brief Gets the indices drawing a level of detail of a mesh. Level 0 is the mesh itself.
+     */
+    const DrawRange& getDrawRange(size_t mesh, size_t lod = 0) const { return m_DrawRanges[mesh][lod]; }
+    MeshData::PrimitiveType getPrimitiveType() const { return m_PrimitiveType; }
+
+private:
+    static std::vector<MeshGeometry> GetGeometries(const std::vector<const MeshData*>& meshes);
+    static size_t CountVertices(const std::vector<MeshGeometry>& meshes);
+    static size_t CountIndices(const std::vector<MeshGeometry>& meshes);
+    static MeshData::IndexFormat SharedIndexFormat(const std::vector<MeshGeometry>& meshes);
+    // Allocated only, the indices are uploaded range by range
+    static IndexBuffer AllocateIndexBuffer(size_t indexCount, MeshData::IndexFormat format);
+    // Uploads indices in the format of the buffer, 16 bit ones narrowed from the 32 bit indices of the mesh data
+    static void UploadIndices(IndexBuffer& indexBuffer, std::span<const uint32_t> indices, size_t firstIndex);
+
 private:
     VertexBuffer m_VertexBuffer;
     IndexBuffer m_IndexBuffer;
     VertexArray m_VertexArray;
     VertexBufferLayout m_VertexBufferLayout;
+    MeshData::PrimitiveType m_PrimitiveType;
+    // Per mesh, then per level of detail
+    std::vector<std::vector<DrawRange>> m_DrawRanges;
 };
 
 } // namespace vrm
@@ -97,6 +97,8 @@ public:
 
 	/**
 	 * @brief  Draws a mesh with a shader and a camera.
+	 * Submeshes with levels of detail are drawn at the level matching their projected size.
+	 * Buffers are bound once for consecutive submeshes sharing them, each submesh being drawn from its base vertex.
 	 * 
 	 * @param mesh  The mesh to draw.
 	 * @param model  The model matrix.
@@ -1,15 +1,21 @@
 #include "Vroom/Asset/AssetData/MeshData.h"
 
+#include <algorithm>
+
+#include "Vroom/Core/Assert.h"
+
 namespace vrm
 {
 
-MeshData::MeshData(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
-    : m_Vertices(vertices), m_Indices(indices)
+MeshData::MeshData(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, PrimitiveType primitiveType)
+    : m_Vertices(vertices), m_Indices(indices), m_PrimitiveType(primitiveType), m_IndexFormat(SmallestIndexFormat(m_Vertices.size())), m_TriangleCount(CountTriangles(m_Indices, primitiveType)),
+      m_VertexCount(m_Vertices.size()), m_IndexCount(m_Indices.size())
 {
 }
 
-MeshData::MeshData(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices)
-    : m_Vertices(std::move(vertices)), m_Indices(std::move(indices))
+MeshData::MeshData(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices, PrimitiveType primitiveType)
+    : m_Vertices(std::move(vertices)), m_Indices(std::move(indices)), m_PrimitiveType(primitiveType), m_IndexFormat(SmallestIndexFormat(m_Vertices.size())), m_TriangleCount(CountTriangles(m_Indices, primitiveType)),
+      m_VertexCount(m_Vertices.size()), m_IndexCount(m_Indices.size())
 {
 }
 
@@ -19,13 +25,21 @@ MeshData::MeshData()
 }
 
 MeshData::MeshData(const MeshData& other)
-    : m_Vertices(other.m_Vertices), m_Indices(other.m_Indices)
+    : m_Vertices(other.m_Vertices), m_Indices(other.m_Indices), m_LodLevels(other.m_LodLevels),
+      m_PrimitiveType(other.m_PrimitiveType), m_IndexFormat(other.m_IndexFormat), m_TriangleCount(other.m_TriangleCount),
+      m_VertexCount(other.m_VertexCount), m_IndexCount(other.m_IndexCount), m_GeometryReleased(other.m_GeometryReleased)
 {
 }
 
 MeshData::MeshData(MeshData&& other)
-    : m_Vertices(std::move(other.m_Vertices)), m_Indices(std::move(other.m_Indices))
+    : m_Vertices(std::move(other.m_Vertices)), m_Indices(std::move(other.m_Indices)), m_LodLevels(std::move(other.m_LodLevels)),
+      m_PrimitiveType(other.m_PrimitiveType), m_IndexFormat(other.m_IndexFormat), m_TriangleCount(other.m_TriangleCount),
+      m_VertexCount(other.m_VertexCount), m_IndexCount(other.m_IndexCount), m_GeometryReleased(other.m_GeometryReleased)
 {
+    other.m_TriangleCount = 0;
+    other.m_VertexCount = 0;
+    other.m_IndexCount = 0;
+    other.m_GeometryReleased = false;
 }
 
 MeshData& MeshData::operator=(const MeshData& other)
@@ -34,6 +48,13 @@ MeshData& MeshData::operator=(const MeshData& other)
     {
         m_Vertices = other.m_Vertices;
         m_Indices = other.m_Indices;
+        m_LodLevels = other.m_LodLevels;
+        m_PrimitiveType = other.m_PrimitiveType;
+        m_IndexFormat = other.m_IndexFormat;
+        m_TriangleCount = other.m_TriangleCount;
+        m_VertexCount = other.m_VertexCount;
+        m_IndexCount = other.m_IndexCount;
+        m_GeometryReleased = other.m_GeometryReleased;
     }
 
     return *this;
@@ -45,6 +66,17 @@ MeshData& MeshData::operator=(MeshData&& other)
     {
         m_Vertices = std::move(other.m_Vertices);
         m_Indices = std::move(other.m_Indices);
+        m_LodLevels = std::move(other.m_LodLevels);
+        m_PrimitiveType = other.m_PrimitiveType;
+        m_IndexFormat = other.m_IndexFormat;
+        m_TriangleCount = other.m_TriangleCount;
+        m_VertexCount = other.m_VertexCount;
+        m_IndexCount = other.m_IndexCount;
+        m_GeometryReleased = other.m_GeometryReleased;
+        other.m_TriangleCount = 0;
+        other.m_VertexCount = 0;
+        other.m_IndexCount = 0;
+        other.m_GeometryReleased = false;
     }
 
     return *this;
@@ -54,6 +86,102 @@ MeshData::~MeshData()
 {
 }
 
+void MeshData::updateVertices(size_t firstVertex, const Vertex* vertices, size_t vertexCount)
+{
+    VRM_ASSERT_MSG(!m_GeometryReleased, "The vertices of the mesh have been released.");
+    VRM_ASSERT_MSG(firstVertex + vertexCount <= m_Vertices.size(), "Vertex range [{}, {}) is out of the mesh ({} vertices).", firstVertex, firstVertex + vertexCount, m_Vertices.size());
+
+    std::copy(vertices, vertices + vertexCount, m_Vertices.begin() + firstVertex);
+}
+
+void MeshData::releaseGeometry()
+{
+    // Swapped with empty vectors, clear would keep the capacity
+    std::vector<Vertex>().swap(m_Vertices);
+    std::vector<uint32_t>().swap(m_Indices);
+
+    for (auto& level : m_LodLevels)
+        std::vector<uint32_t>().swap(level.indices);
+
+    m_GeometryReleased = true;
+}
+
+MeshData MeshData::Released(size_t vertexCount, const uint32_t* indices, size_t indexCount, PrimitiveType primitiveType)
+{
+    MeshData meshData;
+    meshData.m_PrimitiveType = primitiveType;
+    meshData.m_IndexFormat = SmallestIndexFormat(vertexCount);
+    meshData.m_TriangleCount = CountTriangles(indices, indexCount, primitiveType);
+    meshData.m_VertexCount = vertexCount;
+    meshData.m_IndexCount = indexCount;
+    meshData.m_GeometryReleased = true;
+
+    return meshData;
+}
+
+void MeshData::addLodLevel(std::vector<uint32_t>&& indices, float screenSize)
+{
+    VRM_ASSERT_MSG(m_LodLevels.empty() || screenSize < m_LodLevels.back().screenSize, "LOD levels go from the finest to the coarsest: screen size {} follows {}.", screenSize, m_LodLevels.back().screenSize);
+
+    m_LodLevels.push_back({ std::move(indices), screenSize });
+}
+
+void MeshData::clearLodLevels()
+{
+    m_LodLevels.clear();
+}
+
+const std::vector<uint32_t>& MeshData::getLodIndices(size_t lod) const
+{
+    VRM_ASSERT_MSG(lod < getLodCount(), "LOD {} does not exist, the mesh has {} levels.", lod, getLodCount());
+
+    return lod == 0 ? m_Indices : m_LodLevels[lod - 1].indices;
+}
+
+size_t MeshData::selectLod(float screenSize) const
+{
+    // Screen sizes decrease with the levels: the coarsest allowed one is the last one still at least screenSize
+    size_t lod = 0;
+
+    while (lod < m_LodLevels.size() && screenSize <= m_LodLevels[lod].screenSize)
+        lod++;
+
+    return lod;
+}
+
+MeshData::IndexFormat MeshData::SmallestIndexFormat(size_t vertexCount)
+{
+    return vertexCount <= MaxUInt16VertexCount ? IndexFormat::UInt16 : IndexFormat::UInt32;
+}
+
+size_t MeshData::CountTriangles(const std::vector<uint32_t>& indices, PrimitiveType primitiveType)
+{
+    return CountTriangles(indices.data(), indices.size(), primitiveType);
+}
+
+size_t MeshData::CountTriangles(const uint32_t* indices, size_t indexCount, PrimitiveType primitiveType)
+{
+    if (primitiveType == PrimitiveType::Triangles)
+        return indexCount / 3;
+
+    // Every index past the first two of a strip adds a triangle
+    size_t triangleCount = 0, stripLength = 0;
+
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        if (indices[i] == RestartIndex)
+        {
+            stripLength = 0;
+            continue;
+        }
+
+        if (++stripLength >= 3)
+            triangleCount++;
+    }
+
+    return triangleCount;
+}
+
 
 
 } // namespace vrm
@@ -0,0 +1,375 @@
+#include "Vroom/Asset/AssetData/MeshOptimizer.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "Vroom/Core/Assert.h"
+
+namespace vrm
+{
+
+static constexpr uint32_t NoVertex = std::numeric_limits<uint32_t>::max();
+
+MeshOptimizer::CacheStats& MeshOptimizer::CacheStats::operator+=(const CacheStats& other)
+{
+    triangleCount += other.triangleCount;
+    vertexCount += other.vertexCount;
+    transformedVertexCount += other.transformedVertexCount;
+
+    return *this;
+}
+
+MeshOptimizer::Report& MeshOptimizer::Report::operator+=(const Report& other)
+{
+    before += other.before;
+    after += other.after;
+
+    return *this;
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::AnalyzeVertexCache(const MeshData& mesh, uint32_t cacheSize)
+{
+    VRM_ASSERT_MSG(!mesh.isGeometryReleased(), "Cannot analyze a mesh whose geometry was released.");
+
+    CacheStats stats;
+    stats.triangleCount = mesh.getTriangleCount();
+    stats.vertexCount = mesh.getVertexCount();
+    stats.transformedVertexCount = CountTransformedVertices(mesh.getIndices(), mesh.getVertexCount(), cacheSize);
+
+    return stats;
+}
+
+MeshOptimizer::Report MeshOptimizer::Optimize(MeshData& mesh, const Settings& settings)
+{
+    Report report;
+    report.before = AnalyzeVertexCache(mesh, settings.cacheSize);
+    report.after = report.before;
+
+    if (mesh.getPrimitiveType() != MeshData::PrimitiveType::Triangles || mesh.getIndexCount() == 0
+        || (!settings.reorderVertexCache && !settings.reorderVertexFetch))
+        return report;
+
+    const size_t vertexCount = mesh.getVertexCount();
+
+    // Level 0 first, then every coarser level
+    std::vector<std::vector<uint32_t>> levels;
+    levels.reserve(mesh.getLodCount());
+    levels.push_back(mesh.getIndices());
+    for (const MeshData::LodLevel& level : mesh.getLodLevels())
+        levels.push_back(level.indices);
+
+    if (settings.reorderVertexCache)
+    {
+        for (std::vector<uint32_t>& indices : levels)
+        {
+            std::vector<size_t> clusters;
+            indices = ReorderVertexCache(indices, vertexCount, settings.cacheSize, clusters);
+
+            if (settings.reorderOverdraw)
+                ReorderOverdraw(indices, mesh.getVertices(), clusters, settings.cacheSize, settings.overdrawThreshold);
+        }
+    }
+
+    std::vector<Vertex> vertices;
+    if (settings.reorderVertexFetch)
+    {
+        std::vector<const std::vector<uint32_t>*> levelPointers;
+        levelPointers.reserve(levels.size());
+        for (const std::vector<uint32_t>& indices : levels)
+            levelPointers.push_back(&indices);
+
+        const std::vector<uint32_t> remap = ComputeVertexFetchRemap(levelPointers, vertexCount);
+
+        vertices.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++)
+            vertices[remap[i]] = mesh.getVertices()[i];
+
+        for (std::vector<uint32_t>& indices : levels)
+            for (uint32_t& index : indices)
+                index = remap[index];
+    }
+    else
+        vertices = mesh.getVertices();
+
+    std::vector<float> screenSizes;
+    screenSizes.reserve(mesh.getLodLevels().size());
+    for (const MeshData::LodLevel& level : mesh.getLodLevels())
+        screenSizes.push_back(level.screenSize);
+
+    mesh = MeshData(std::move(vertices), std::move(levels[0]), MeshData::PrimitiveType::Triangles);
+    for (size_t i = 0; i < screenSizes.size(); i++)
+        mesh.addLodLevel(std::move(levels[i + 1]), screenSizes[i]);
+
+    report.after = AnalyzeVertexCache(mesh, settings.cacheSize);
+    return report;
+}
+
+MeshOptimizer::Report MeshOptimizer::Optimize(MeshData& mesh)
+{
+    return Optimize(mesh, Settings());
+}
+
+std::vector<uint32_t> MeshOptimizer::ReorderVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize, std::vector<size_t>& clusters)
+{
+    const size_t triangleCount = indices.size() / 3;
+
+    // Triangles using every vertex, packed, and how many of them are still to emit
+    std::vector<uint32_t> liveTriangleCounts(vertexCount, 0);
+    for (uint32_t index : indices)
+        liveTriangleCounts[index]++;
+
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < vertexCount; i++)
+        adjacencyOffsets[i + 1] = adjacencyOffsets[i] + liveTriangleCounts[i];
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<size_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+            adjacency[cursors[indices[i]]++] = (uint32_t)(i / 3);
+    }
+
+    // A vertex is in the cache while fewer than cacheSize vertices were transformed since it was
+    std::vector<size_t> cacheTimes(vertexCount, 0);
+    size_t time = cacheSize + 1;
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnds, candidates;
+    deadEnds.reserve(indices.size());
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    size_t scanCursor = 0;
+    uint32_t fanningVertex = triangleCount > 0 ? indices[0] : NoVertex;
+    if (triangleCount > 0)
+        clusters.push_back(0);
+
+    while (fanningVertex != NoVertex)
+    {
+        // Every triangle left around the fanning vertex
+        candidates.clear();
+        for (size_t i = adjacencyOffsets[fanningVertex]; i < adjacencyOffsets[fanningVertex + 1]; i++)
+        {
+            const uint32_t triangle = adjacency[i];
+            if (emitted[triangle])
+                continue;
+
+            for (size_t k = 0; k < 3; k++)
+            {
+                const uint32_t vertex = indices[3 * triangle + k];
+                result.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangleCounts[vertex]--;
+
+                if (time - cacheTimes[vertex] > cacheSize)
+                    cacheTimes[vertex] = time++;
+            }
+
+            emitted[triangle] = true;
+        }
+
+        // Next, the oldest vertex just used that stays in the cache while its own triangles are emitted, else any with triangles left
+        uint32_t nextVertex = NoVertex;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates)
+        {
+            if (liveTriangleCounts[vertex] == 0)
+                continue;
+
+            int64_t priority = 0;
+            const size_t age = time - cacheTimes[vertex];
+            if (age + 2 * liveTriangleCounts[vertex] <= cacheSize)
+                priority = (int64_t)age;
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                nextVertex = vertex;
+            }
+        }
+
+        if (nextVertex == NoVertex)
+        {
+            // Dead end: back to a recent vertex with triangles left, else to the next one in order. The fan is no longer local, a cluster starts.
+            while (nextVertex == NoVertex && !deadEnds.empty())
+            {
+                const uint32_t vertex = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangleCounts[vertex] > 0)
+                    nextVertex = vertex;
+            }
+
+            for (; nextVertex == NoVertex && scanCursor < vertexCount; scanCursor++)
+            {
+                if (liveTriangleCounts[scanCursor] > 0)
+                    nextVertex = (uint32_t)scanCursor;
+            }
+
+            if (nextVertex != NoVertex && clusters.back() != result.size() / 3)
+                clusters.push_back(result.size() / 3);
+        }
+
+        fanningVertex = nextVertex;
+    }
+
+    return result;
+}
+
+void MeshOptimizer::ReorderOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<size_t>& clusters, uint32_t cacheSize, float threshold)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount <= 1)
+        return;
+
+    // Cut the clusters further wherever the cluster so far, drawn from a cold cache, is about as cache efficient as the whole mesh: sorting them then costs little
+    const float clusterAcmr = threshold * (float)CountTransformedVertices(indices, vertices.size(), cacheSize) / (float)triangleCount;
+
+    std::vector<size_t> cacheTimes(vertices.size(), 0);
+    size_t time = cacheSize + 1;
+
+    std::vector<size_t> clusterStarts;
+    for (size_t i = 0; i < clusters.size(); i++)
+    {
+        const size_t end = i + 1 < clusters.size() ? clusters[i + 1] : triangleCount;
+        size_t start = clusters[i];
+        size_t transformedVertexCount = 0;
+
+        clusterStarts.push_back(start);
+        time += cacheSize + 1;
+
+        for (size_t triangle = start; triangle < end; triangle++)
+        {
+            for (size_t k = 0; k < 3; k++)
+            {
+                const uint32_t vertex = indices[3 * triangle + k];
+                if (time - cacheTimes[vertex] > cacheSize)
+                {
+                    cacheTimes[vertex] = time++;
+                    transformedVertexCount++;
+                }
+            }
+
+            if (triangle + 1 < end && (float)transformedVertexCount <= clusterAcmr * (float)(triangle + 1 - start))
+            {
+                start = triangle + 1;
+                transformedVertexCount = 0;
+                clusterStarts.push_back(start);
+                time += cacheSize + 1;
+            }
+        }
+    }
+
+    struct Cluster
+    {
+        size_t start;
+        size_t end;
+        // Area weighted, not divided yet
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        float area;
+        float sortKey;
+    };
+
+    std::vector<Cluster> sortedClusters(clusterStarts.size());
+    glm::vec3 meshCentroid(0.f);
+    float meshArea = 0.f;
+
+    for (size_t i = 0; i < clusterStarts.size(); i++)
+    {
+        Cluster& cluster = sortedClusters[i];
+        cluster.start = clusterStarts[i];
+        cluster.end = i + 1 < clusterStarts.size() ? clusterStarts[i + 1] : triangleCount;
+        cluster.centroid = glm::vec3(0.f);
+        cluster.normal = glm::vec3(0.f);
+        cluster.area = 0.f;
+
+        for (size_t triangle = cluster.start; triangle < cluster.end; triangle++)
+        {
+            const glm::vec3& a = vertices[indices[3 * triangle]].position;
+            const glm::vec3& b = vertices[indices[3 * triangle + 1]].position;
+            const glm::vec3& c = vertices[indices[3 * triangle + 2]].position;
+
+            // Twice the area, in length
+            const glm::vec3 normal = glm::cross(b - a, c - a);
+            const float area = glm::length(normal);
+
+            cluster.centroid += (a + b + c) * (area / 3.f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+
+        meshCentroid += cluster.centroid;
+        meshArea += cluster.area;
+    }
+
+    if (meshArea > 0.f)
+        meshCentroid /= meshArea;
+
+    // Clusters far out along their own normal are likely in front of the others from where they are seen, so they go first
+    for (Cluster& cluster : sortedClusters)
+    {
+        const float normalLength = glm::length(cluster.normal);
+        if (cluster.area > 0.f && normalLength > 0.f)
+            cluster.sortKey = glm::dot(cluster.centroid / cluster.area - meshCentroid, cluster.normal / normalLength);
+        else
+            cluster.sortKey = 0.f;
+    }
+
+    std::stable_sort(sortedClusters.begin(), sortedClusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (const Cluster& cluster : sortedClusters)
+        result.insert(result.end(), indices.begin() + 3 * cluster.start, indices.begin() + 3 * cluster.end);
+
+    indices = std::move(result);
+}
+
+std::vector<uint32_t> MeshOptimizer::ComputeVertexFetchRemap(const std::vector<const std::vector<uint32_t>*>& levels, size_t vertexCount)
+{
+    std::vector<uint32_t> remap(vertexCount, NoVertex);
+    uint32_t nextVertex = 0;
+
+    for (const std::vector<uint32_t>* indices : levels)
+    {
+        for (uint32_t index : *indices)
+        {
+            if (remap[index] == NoVertex)
+                remap[index] = nextVertex++;
+        }
+    }
+
+    // Vertices no level uses are kept, last
+    for (uint32_t& vertex : remap)
+    {
+        if (vertex == NoVertex)
+            vertex = nextVertex++;
+    }
+
+    return remap;
+}
+
+size_t MeshOptimizer::CountTransformedVertices(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+{
+    std::vector<size_t> cacheTimes(vertexCount, 0);
+    size_t time = cacheSize + 1;
+    size_t transformedVertexCount = 0;
+
+    for (uint32_t index : indices)
+    {
+        if (index == MeshData::RestartIndex)
+            continue;
+
+        if (time - cacheTimes[index] > cacheSize)
+        {
+            cacheTimes[index] = time++;
+            transformedVertexCount++;
+        }
+    }
+
+    return transformedVertexCount;
+}
+
+} // namespace vrm
@@ -0,0 +1,343 @@
+#include "Vroom/Asset/Parsing/MeshCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+#include "Vroom/Core/Assert.h"
+#include "Vroom/Core/Log.h"
+
+namespace vrm
+{
+
+static_assert(std::is_trivially_copyable_v<Vertex>, "Vertices are written and read as raw bytes.");
+
+// Payloads start on this boundary, wide enough for any member of Vertex
+static constexpr uint64_t PayloadAlignment = 16;
+
+static constexpr char Magic[4] = { 'V', 'M', 'S', 'H' };
+
+struct MeshCache::FileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t vertexSize;
+    uint32_t meshCount;
+
+    uint64_t sourceSize;
+    int64_t sourceModificationTime;
+    uint64_t sourceHash;
+    uint64_t processingKey;
+
+    // In bytes from the start of the file for offsets, in elements for counts
+    uint64_t vertexOffset;
+    uint64_t vertexCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    uint64_t stringOffset;
+    uint64_t stringSize;
+};
+
+struct MeshCache::MeshEntry
+{
+    // In elements, from the start of the vertex and index payloads
+    uint64_t firstVertex;
+    uint64_t vertexCount;
+    uint64_t firstIndex;
+    uint64_t indexCount;
+
+    // In bytes, from the start of the string payload
+    uint32_t nameOffset;
+    uint32_t nameSize;
+    uint32_t materialNameOffset;
+    uint32_t materialNameSize;
+
+    uint32_t primitiveType;
+    uint32_t padding;
+};
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+    return (offset + PayloadAlignment - 1) / PayloadAlignment * PayloadAlignment;
+}
+
+static bool GetSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& modificationTime)
+{
+    std::error_code error;
+    size = std::filesystem::file_size(sourcePath, error);
+    if (error)
+        return false;
+
+    const auto time = std::filesystem::last_write_time(sourcePath, error);
+    if (error)
+        return false;
+
+    modificationTime = (int64_t)time.time_since_epoch().count();
+    return true;
+}
+
+bool MeshCache::open(const std::string& sourcePath, uint64_t processingKey)
+{
+    close();
+
+    uint64_t sourceSize;
+    int64_t sourceModificationTime;
+    if (!GetSourceStamp(sourcePath, sourceSize, sourceModificationTime))
+        return false;
+
+    const std::string cachePath = CachePath(sourcePath);
+    if (!m_File.open(cachePath) || m_File.getSize() < sizeof(FileHeader))
+    {
+        m_File.close();
+        return false;
+    }
+
+    m_Header = reinterpret_cast<const FileHeader*>(m_File.getData());
+    m_Entries = reinterpret_cast<const MeshEntry*>(m_File.getData() + sizeof(FileHeader));
+
+    if (!validate() || m_Header->sourceSize != sourceSize || m_Header->processingKey != processingKey)
+    {
+        close();
+        return false;
+    }
+
+    if (m_Header->sourceModificationTime == sourceModificationTime)
+        return true;
+
+    // Touched, maybe not changed
+    const uint64_t sourceHash = HashFile(sourcePath);
+    if (sourceHash != m_Header->sourceHash)
+    {
+        close();
+        return false;
+    }
+
+    // Same content: the new time saves the hash next time. The file is unmapped meanwhile, as some systems refuse writes to mapped files.
+    close();
+    {
+        std::fstream file(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+        if (file)
+        {
+            file.seekp(offsetof(FileHeader, sourceModificationTime));
+            file.write(reinterpret_cast<const char*>(&sourceModificationTime), sizeof(sourceModificationTime));
+            file.flush();
+        }
+
+        // The cache still holds the source, it is only hashed again at every load
+        if (!file)
+            VRM_LOG_WARN("Failed to update the source time of mesh cache: {}", cachePath);
+    }
+
+    if (!m_File.open(cachePath))
+        return false;
+
+    m_Header = reinterpret_cast<const FileHeader*>(m_File.getData());
+    m_Entries = reinterpret_cast<const MeshEntry*>(m_File.getData() + sizeof(FileHeader));
+
+    if (!validate())
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MeshCache::close()
+{
+    m_File.close();
+    m_Header = nullptr;
+    m_Entries = nullptr;
+}
+
+size_t MeshCache::getMeshCount() const
+{
+    return m_Header != nullptr ? m_Header->meshCount : 0;
+}
+
+MeshCache::MeshView MeshCache::getMesh(size_t index) const
+{
+    VRM_ASSERT_MSG(index < getMeshCount(), "Mesh {} is not in the cache, which has {} meshes.", index, getMeshCount());
+
+    const MeshEntry& entry = m_Entries[index];
+    const std::byte* data = m_File.getData();
+    const char* strings = reinterpret_cast<const char*>(data + m_Header->stringOffset);
+
+    MeshView mesh;
+    mesh.name = std::string_view(strings + entry.nameOffset, entry.nameSize);
+    mesh.materialName = std::string_view(strings + entry.materialNameOffset, entry.materialNameSize);
+    mesh.primitiveType = (MeshData::PrimitiveType)entry.primitiveType;
+    mesh.vertices = reinterpret_cast<const Vertex*>(data + m_Header->vertexOffset) + entry.firstVertex;
+    mesh.vertexCount = (size_t)entry.vertexCount;
+    mesh.indices = reinterpret_cast<const uint32_t*>(data + m_Header->indexOffset) + entry.firstIndex;
+    mesh.indexCount = (size_t)entry.indexCount;
+
+    return mesh;
+}
+
+bool MeshCache::validate() const
+{
+    const FileHeader& header = *m_Header;
+    const uint64_t fileSize = m_File.getSize();
+
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version || header.vertexSize != sizeof(Vertex))
+        return false;
+
+    // Every range must be inside the file, so that a truncated one is caught here rather than when reading it
+    const uint64_t entriesEnd = sizeof(FileHeader) + (uint64_t)header.meshCount * sizeof(MeshEntry);
+    if (entriesEnd > fileSize)
+        return false;
+
+    auto fits = [fileSize](uint64_t offset, uint64_t count, uint64_t elementSize)
+    {
+        return offset % PayloadAlignment == 0 && offset <= fileSize && count <= (fileSize - offset) / elementSize;
+    };
+
+    if (!fits(header.vertexOffset, header.vertexCount, sizeof(Vertex))
+        || !fits(header.indexOffset, header.indexCount, sizeof(uint32_t))
+        || header.stringOffset > fileSize || header.stringSize > fileSize - header.stringOffset)
+        return false;
+
+    for (uint32_t i = 0; i < header.meshCount; i++)
+    {
+        const MeshEntry& entry = m_Entries[i];
+
+        if (entry.firstVertex > header.vertexCount || entry.vertexCount > header.vertexCount - entry.firstVertex
+            || entry.firstIndex > header.indexCount || entry.indexCount > header.indexCount - entry.firstIndex
+            || (uint64_t)entry.nameOffset + entry.nameSize > header.stringSize
+            || (uint64_t)entry.materialNameOffset + entry.materialNameSize > header.stringSize
+            || entry.primitiveType > (uint32_t)MeshData::PrimitiveType::TriangleStrip)
+            return false;
+    }
+
+    return true;
+}
+
+bool MeshCache::Write(const std::string& sourcePath, const std::vector<MeshData>& meshes, const std::vector<std::string>& names, const std::vector<std::string>& materialNames,
+    uint64_t processingKey)
+{
+    VRM_ASSERT_MSG(meshes.size() == names.size() && meshes.size() == materialNames.size(), "{} meshes were given {} names and {} materials.", meshes.size(), names.size(), materialNames.size());
+
+    FileHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.vertexSize = sizeof(Vertex);
+    header.meshCount = (uint32_t)meshes.size();
+
+    if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceModificationTime))
+        return false;
+    header.sourceHash = HashFile(sourcePath);
+    header.processingKey = processingKey;
+
+    std::vector<MeshEntry> entries(meshes.size());
+    std::string strings;
+
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        const MeshData& mesh = meshes[i];
+        VRM_ASSERT_MSG(!mesh.isGeometryReleased(), "Mesh {} has no geometry left to cache.", names[i]);
+
+        MeshEntry& entry = entries[i];
+        entry.firstVertex = header.vertexCount;
+        entry.vertexCount = mesh.getVertexCount();
+        entry.firstIndex = header.indexCount;
+        entry.indexCount = mesh.getIndexCount();
+        entry.primitiveType = (uint32_t)mesh.getPrimitiveType();
+
+        entry.nameOffset = (uint32_t)strings.size();
+        entry.nameSize = (uint32_t)names[i].size();
+        strings += names[i];
+        entry.materialNameOffset = (uint32_t)strings.size();
+        entry.materialNameSize = (uint32_t)materialNames[i].size();
+        strings += materialNames[i];
+
+        header.vertexCount += entry.vertexCount;
+        header.indexCount += entry.indexCount;
+    }
+
+    header.vertexOffset = AlignOffset(sizeof(FileHeader) + entries.size() * sizeof(MeshEntry));
+    header.indexOffset = AlignOffset(header.vertexOffset + header.vertexCount * sizeof(Vertex));
+    header.stringOffset = header.indexOffset + header.indexCount * sizeof(uint32_t);
+    header.stringSize = strings.size();
+
+    const std::string cachePath = CachePath(sourcePath);
+    const std::string temporaryPath = cachePath + ".tmp";
+
+    {
+        std::ofstream file(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        const char padding[PayloadAlignment] = {};
+        auto pad = [&file, &padding](uint64_t offset)
+        {
+            file.write(padding, (std::streamsize)(offset - (uint64_t)file.tellp()));
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), (std::streamsize)(entries.size() * sizeof(MeshEntry)));
+
+        pad(header.vertexOffset);
+        for (const MeshData& mesh : meshes)
+            file.write(reinterpret_cast<const char*>(mesh.getRawVericesData()), (std::streamsize)(mesh.getVertexCount() * sizeof(Vertex)));
+
+        pad(header.indexOffset);
+        for (const MeshData& mesh : meshes)
+            file.write(reinterpret_cast<const char*>(mesh.getRawIndicesData()), (std::streamsize)(mesh.getIndexCount() * sizeof(uint32_t)));
+
+        file.write(strings.data(), (std::streamsize)strings.size());
+
+        if (!file)
+        {
+            file.close();
+            std::filesystem::remove(temporaryPath);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+uint64_t MeshCache::Hash(const std::byte* data, size_t size)
+{
+    // FNV-1a over 8 bytes at a time, then the tail byte by byte, and a final mix so that every input bit reaches every output bit
+    constexpr uint64_t prime = 0x100000001b3ull;
+    uint64_t hash = 0xcbf29ce484222325ull ^ size;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+
+    for (; i < size; i++)
+        hash = (hash ^ (uint64_t)data[i]) * prime;
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+uint64_t MeshCache::HashFile(const std::string& filePath)
+{
+    MappedFile file;
+    if (!file.open(filePath))
+        return 0;
+
+    return Hash(file.getData(), file.getSize());
+}
+
+} // namespace vrm
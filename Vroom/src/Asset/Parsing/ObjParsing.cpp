@@ -0,0 +1,624 @@
+#include "Vroom/Asset/Parsing/ObjParsing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <thread>
+
+#include "Vroom/Core/Log.h"
+#include "Vroom/Core/MappedFile.h"
+
+namespace vrm
+{
+
+namespace
+{
+
+// Texture coordinate or normal left out of a corner
+constexpr int32_t NoIndex = std::numeric_limits<int32_t>::min();
+
+enum RelativeBits : uint8_t
+{
+    RelativePosition = 1 << 0,
+    RelativeTexCoord = 1 << 1,
+    RelativeNormal = 1 << 2
+};
+
+struct Corner
+{
+    // 0 based. Negative indices of the file count back from the last element of the chunk until the chunks are stitched.
+    int32_t position;
+    int32_t texCoord;
+    int32_t normal;
+    uint8_t relative;
+};
+
+// An o, g or usemtl statement
+struct Statement
+{
+    // Faces of the chunk before the statement
+    size_t faceIndex;
+    bool isMaterial;
+    std::string name;
+};
+
+struct Chunk
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+    std::vector<Corner> corners;
+    // First corner of every face
+    std::vector<uint32_t> faceStarts;
+    std::vector<Statement> statements;
+
+    // First line that could not be parsed
+    std::string_view error;
+
+    // Elements of the previous chunks
+    size_t positionOffset = 0;
+    size_t texCoordOffset = 0;
+    size_t normalOffset = 0;
+
+    size_t getFaceCount() const { return faceStarts.size(); }
+    size_t getFaceEnd(size_t face) const { return face + 1 < faceStarts.size() ? faceStarts[face + 1] : corners.size(); }
+};
+
+// Faces [firstFace, lastFace) of a chunk
+struct FaceSpan
+{
+    size_t chunk;
+    size_t firstFace;
+    size_t lastFace;
+};
+
+struct MeshSpans
+{
+    std::string name;
+    std::string materialName;
+    std::vector<FaceSpan> spans;
+};
+
+/**
+ * @brief Open addressing table from position/texture coordinate/normal triplets to vertex indices, with linear probing.
+ * Slots hold the key and the value side by side, so that a lookup usually touches a single cache line. The table doubles when half full.
+ */
+class VertexTable
+{
+public:
+    static constexpr uint32_t Missing = std::numeric_limits<uint32_t>::max();
+
+    explicit VertexTable(size_t expectedVertexCount)
+    {
+        size_t capacity = 16;
+        while (capacity < expectedVertexCount * 2)
+            capacity *= 2;
+
+        m_Slots.assign(capacity, Slot{ Missing, Missing, Missing, 0 });
+    }
+
+    // Index of the vertex of a triplet, nextVertex when it is new
+    uint32_t findOrInsert(uint32_t position, uint32_t texCoord, uint32_t normal, uint32_t nextVertex, bool& inserted)
+    {
+        const size_t mask = m_Slots.size() - 1;
+
+        for (size_t i = Hash(position, texCoord, normal) & mask;; i = (i + 1) & mask)
+        {
+            Slot& slot = m_Slots[i];
+
+            if (slot.position == Missing)
+            {
+                slot = { position, texCoord, normal, nextVertex };
+                inserted = true;
+
+                if (++m_Size * 2 > m_Slots.size())
+                    grow();
+
+                return nextVertex;
+            }
+
+            if (slot.position == position && slot.texCoord == texCoord && slot.normal == normal)
+            {
+                inserted = false;
+                return slot.vertex;
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t position;
+        uint32_t texCoord;
+        uint32_t normal;
+        uint32_t vertex;
+    };
+
+    // Faces mostly reference positions in file order, so the home slot follows the position: consecutive lookups stay in neighbouring
+    // slots rather than jumping across the table. Texture coordinate and normal only pick one of the slots of their position.
+    static uint64_t Hash(uint32_t position, uint32_t texCoord, uint32_t normal)
+    {
+        constexpr uint32_t slotsPerPosition = 4;
+        return (uint64_t)position * slotsPerPosition + ((texCoord * 0x9E3779B1u ^ normal * 0x85EBCA77u) >> 30);
+    }
+
+    void grow()
+    {
+        std::vector<Slot> slots(m_Slots.size() * 2, Slot{ Missing, Missing, Missing, 0 });
+        const size_t mask = slots.size() - 1;
+
+        for (const Slot& slot : m_Slots)
+        {
+            if (slot.position == Missing)
+                continue;
+
+            size_t i = Hash(slot.position, slot.texCoord, slot.normal) & mask;
+            while (slots[i].position != Missing)
+                i = (i + 1) & mask;
+
+            slots[i] = slot;
+        }
+
+        m_Slots = std::move(slots);
+    }
+
+private:
+    std::vector<Slot> m_Slots;
+    size_t m_Size = 0;
+};
+
+void ParallelFor(size_t count, uint32_t threadCount, const std::function<void(size_t)>& job)
+{
+    if (count == 0)
+        return;
+
+    std::atomic<size_t> next = 0;
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < count; i = next++)
+            job(i);
+    };
+
+    // The calling thread works too
+    std::vector<std::thread> threads;
+    const size_t helperCount = std::min<size_t>(threadCount, count) - 1;
+    threads.reserve(helperCount);
+
+    for (size_t i = 0; i < helperCount; i++)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+bool IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* SkipSpaces(const char* p, const char* end)
+{
+    while (p < end && IsSpace(*p))
+        p++;
+
+    return p;
+}
+
+bool ParseFloat(const char*& p, const char* end, float& value)
+{
+    p = SkipSpaces(p, end);
+
+    // from_chars rejects a leading plus sign
+    if (p < end && *p == '+')
+        p++;
+
+    const auto [next, error] = std::from_chars(p, end, value);
+    if (error != std::errc())
+        return false;
+
+    p = next;
+    return true;
+}
+
+// 0 based, relative when negative in the file. 0 is not an index.
+bool ParseIndex(const char*& p, const char* end, size_t localCount, int32_t& index, bool& relative)
+{
+    int64_t value;
+    const auto [next, error] = std::from_chars(p, end, value);
+    if (error != std::errc() || value == 0 || value > std::numeric_limits<int32_t>::max() || value < -std::numeric_limits<int32_t>::max())
+        return false;
+
+    p = next;
+    relative = value < 0;
+    index = (int32_t)(relative ? (int64_t)localCount + value : value - 1);
+
+    return true;
+}
+
+bool ParseCorner(const char*& p, const char* end, const Chunk& chunk, Corner& corner)
+{
+    bool relative;
+    corner = { NoIndex, NoIndex, NoIndex, 0 };
+
+    if (!ParseIndex(p, end, chunk.positions.size(), corner.position, relative))
+        return false;
+    corner.relative |= relative ? RelativePosition : 0;
+
+    // p, p/t, p//n or p/t/n
+    if (p == end || *p != '/')
+        return true;
+    p++;
+
+    if (p < end && *p != '/')
+    {
+        if (!ParseIndex(p, end, chunk.texCoords.size(), corner.texCoord, relative))
+            return false;
+        corner.relative |= relative ? RelativeTexCoord : 0;
+    }
+
+    if (p == end || *p != '/')
+        return true;
+    p++;
+
+    if (!ParseIndex(p, end, chunk.normals.size(), corner.normal, relative))
+        return false;
+    corner.relative |= relative ? RelativeNormal : 0;
+
+    return true;
+}
+
+// False if the line is malformed
+bool ParseLine(const char* p, const char* end, Chunk& chunk)
+{
+    p = SkipSpaces(p, end);
+    if (p == end || *p == '#')
+        return true;
+
+    const char* keywordEnd = p;
+    while (keywordEnd < end && !IsSpace(*keywordEnd))
+        keywordEnd++;
+
+    const std::string_view keyword(p, keywordEnd - p);
+    p = keywordEnd;
+
+    if (keyword == "v")
+    {
+        glm::vec3& position = chunk.positions.emplace_back();
+        return ParseFloat(p, end, position.x) && ParseFloat(p, end, position.y) && ParseFloat(p, end, position.z);
+    }
+
+    if (keyword == "vt")
+    {
+        // v is optional
+        glm::vec2& texCoord = chunk.texCoords.emplace_back(0.f);
+        if (!ParseFloat(p, end, texCoord.x))
+            return false;
+
+        const char* next = p;
+        if (ParseFloat(next, end, texCoord.y))
+            p = next;
+
+        return true;
+    }
+
+    if (keyword == "vn")
+    {
+        glm::vec3& normal = chunk.normals.emplace_back();
+        return ParseFloat(p, end, normal.x) && ParseFloat(p, end, normal.y) && ParseFloat(p, end, normal.z);
+    }
+
+    if (keyword == "f")
+    {
+        const size_t firstCorner = chunk.corners.size();
+
+        for (p = SkipSpaces(p, end); p < end; p = SkipSpaces(p, end))
+        {
+            Corner corner;
+            if (!ParseCorner(p, end, chunk, corner))
+                return false;
+
+            chunk.corners.push_back(corner);
+        }
+
+        // Points and lines do not make triangles
+        if (chunk.corners.size() - firstCorner < 3)
+            chunk.corners.resize(firstCorner);
+        else
+            chunk.faceStarts.push_back((uint32_t)firstCorner);
+
+        return true;
+    }
+
+    if (keyword == "o" || keyword == "g" || keyword == "usemtl")
+    {
+        p = SkipSpaces(p, end);
+        const char* nameEnd = end;
+        while (nameEnd > p && IsSpace(nameEnd[-1]))
+            nameEnd--;
+
+        chunk.statements.push_back({ chunk.getFaceCount(), keyword == "usemtl", std::string(p, nameEnd - p) });
+        return true;
+    }
+
+    // Smoothing groups, material libraries, lines, free form geometry...
+    return true;
+}
+
+void ParseChunk(std::string_view text, Chunk& chunk)
+{
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    while (p < end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr)
+            lineEnd = end;
+
+        if (!ParseLine(p, lineEnd, chunk) && chunk.error.empty())
+            chunk.error = std::string_view(p, lineEnd - p);
+
+        p = lineEnd + 1;
+    }
+}
+
+// Ranges of text ending at line ends, the last one excepted
+std::vector<std::string_view> SplitText(std::string_view text, size_t chunkCount)
+{
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+
+    for (size_t i = 1; i <= chunkCount && begin < text.size(); i++)
+    {
+        size_t end = text.size();
+
+        if (i < chunkCount)
+        {
+            end = text.find('\n', std::max(begin, text.size() / chunkCount * i));
+            end = end == std::string_view::npos ? text.size() : end + 1;
+        }
+
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    return chunks;
+}
+
+// Global 0 based index of an element of a chunk, Missing if left out, false if out of range
+bool ResolveIndex(int32_t index, bool relative, size_t offset, size_t count, uint32_t& resolved)
+{
+    if (index == NoIndex)
+    {
+        resolved = VertexTable::Missing;
+        return true;
+    }
+
+    const int64_t global = relative ? (int64_t)offset + index : index;
+    if (global < 0 || global >= (int64_t)count)
+        return false;
+
+    resolved = (uint32_t)global;
+    return true;
+}
+
+} // namespace
+
+std::optional<ObjParsing::ParsingResults> ObjParsing::Parse(const std::string& filePath, uint32_t threadCount)
+{
+    MappedFile file;
+    if (!file.open(filePath))
+    {
+        VRM_LOG_ERROR("Failed to open obj file: {}", filePath);
+        return std::nullopt;
+    }
+
+    return ParseText(std::string_view(reinterpret_cast<const char*>(file.getData()), file.getSize()), threadCount);
+}
+
+std::optional<ObjParsing::ParsingResults> ObjParsing::ParseText(std::string_view text, uint32_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // A few chunks per thread, so that a thread finishing early takes another one. A single thread has nothing to balance
+    const size_t maxChunkCount = threadCount == 1 ? 1 : (size_t)threadCount * 4;
+    const size_t chunkCount = std::clamp<size_t>(text.size() / MinChunkSize, 1, maxChunkCount);
+    const std::vector<std::string_view> texts = SplitText(text, chunkCount);
+    std::vector<Chunk> chunks(texts.size());
+
+    ParallelFor(chunks.size(), threadCount, [&](size_t i)
+    {
+        ParseChunk(texts[i], chunks[i]);
+    });
+
+    // Stitching: elements in file order, and faces grouped in meshes
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+
+    for (Chunk& chunk : chunks)
+    {
+        if (!chunk.error.empty())
+        {
+            VRM_LOG_ERROR("Malformed obj statement: {}", chunk.error);
+            return std::nullopt;
+        }
+
+        chunk.positionOffset = positions.size();
+        chunk.texCoordOffset = texCoords.size();
+        chunk.normalOffset = normals.size();
+
+        positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+        texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+    }
+
+    std::vector<MeshSpans> meshes;
+    std::string name, materialName;
+    // A statement changing the name or the material starts a new mesh at the next face
+    bool meshStarted = false;
+
+    for (size_t c = 0; c < chunks.size(); c++)
+    {
+        const Chunk& chunk = chunks[c];
+        size_t face = 0;
+
+        auto addFaces = [&](size_t lastFace)
+        {
+            if (lastFace == face)
+                return;
+
+            if (!meshStarted)
+            {
+                meshes.push_back({ name, materialName, {} });
+                meshStarted = true;
+            }
+
+            meshes.back().spans.push_back({ c, face, lastFace });
+            face = lastFace;
+        };
+
+        for (const Statement& statement : chunk.statements)
+        {
+            addFaces(statement.faceIndex);
+
+            std::string& target = statement.isMaterial ? materialName : name;
+            if (target != statement.name)
+            {
+                target = statement.name;
+                meshStarted = false;
+            }
+        }
+
+        addFaces(chunk.getFaceCount());
+    }
+
+    if (meshes.empty())
+    {
+        VRM_LOG_ERROR("Obj file has no face.");
+        return std::nullopt;
+    }
+
+    ParsingResults results;
+    results.meshes.resize(meshes.size());
+    results.chunkCount = chunks.size();
+    std::atomic<bool> outOfRange = false;
+
+    ParallelFor(meshes.size(), threadCount, [&](size_t m)
+    {
+        const MeshSpans& mesh = meshes[m];
+
+        size_t cornerCount = 0, indexCount = 0;
+        for (const FaceSpan& span : mesh.spans)
+        {
+            const Chunk& chunk = chunks[span.chunk];
+            const size_t corners = chunk.getFaceEnd(span.lastFace - 1) - chunk.faceStarts[span.firstFace];
+
+            cornerCount += corners;
+            indexCount += (corners - 2 * (span.lastFace - span.firstFace)) * 3;
+        }
+
+        // Most files have about one vertex per position, texture coordinate or normal: the table grows if not
+        VertexTable table(std::min(cornerCount, std::max({ positions.size(), texCoords.size(), normals.size() })));
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        // Vertices whose corners had no normal
+        std::vector<uint32_t> unnormalized;
+        std::vector<uint32_t> faceVertices;
+
+        indices.reserve(indexCount);
+
+        for (const FaceSpan& span : mesh.spans)
+        {
+            const Chunk& chunk = chunks[span.chunk];
+
+            for (size_t face = span.firstFace; face < span.lastFace; face++)
+            {
+                faceVertices.clear();
+
+                for (size_t i = chunk.faceStarts[face]; i < chunk.getFaceEnd(face); i++)
+                {
+                    const Corner& corner = chunk.corners[i];
+                    uint32_t position, texCoord, normal;
+
+                    if (!ResolveIndex(corner.position, corner.relative & RelativePosition, chunk.positionOffset, positions.size(), position)
+                        || !ResolveIndex(corner.texCoord, corner.relative & RelativeTexCoord, chunk.texCoordOffset, texCoords.size(), texCoord)
+                        || !ResolveIndex(corner.normal, corner.relative & RelativeNormal, chunk.normalOffset, normals.size(), normal))
+                    {
+                        outOfRange = true;
+                        return;
+                    }
+
+                    bool inserted;
+                    const uint32_t vertex = table.findOrInsert(position, texCoord, normal, (uint32_t)vertices.size(), inserted);
+
+                    if (inserted)
+                    {
+                        vertices.push_back({
+                            positions[position],
+                            normal != VertexTable::Missing ? normals[normal] : glm::vec3(0.f),
+                            texCoord != VertexTable::Missing ? texCoords[texCoord] : glm::vec2(0.f)
+                        });
+
+                        if (normal == VertexTable::Missing)
+                            unnormalized.push_back(vertex);
+                    }
+
+                    faceVertices.push_back(vertex);
+                }
+
+                for (size_t i = 1; i + 1 < faceVertices.size(); i++)
+                {
+                    indices.push_back(faceVertices[0]);
+                    indices.push_back(faceVertices[i]);
+                    indices.push_back(faceVertices[i + 1]);
+                }
+            }
+        }
+
+        if (!unnormalized.empty())
+        {
+            // Cross products are twice the triangle areas, which weights them
+            std::vector<uint8_t> needsNormal(vertices.size(), 0);
+            for (uint32_t vertex : unnormalized)
+                needsNormal[vertex] = 1;
+
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+                const glm::vec3 normal = glm::cross(vertices[b].position - vertices[a].position, vertices[c].position - vertices[a].position);
+
+                for (uint32_t vertex : { a, b, c })
+                    if (needsNormal[vertex])
+                        vertices[vertex].normal += normal;
+            }
+
+            for (uint32_t vertex : unnormalized)
+            {
+                const float length = glm::length(vertices[vertex].normal);
+                vertices[vertex].normal = length > 0.f ? vertices[vertex].normal / length : glm::vec3(0.f, 1.f, 0.f);
+            }
+        }
+
+        ParsedMesh& parsed = results.meshes[m];
+        parsed.name = mesh.name;
+        parsed.materialName = mesh.materialName;
+        parsed.meshData = MeshData(std::move(vertices), std::move(indices));
+    });
+
+    if (outOfRange)
+    {
+        VRM_LOG_ERROR("Obj file references a missing vertex element.");
+        return std::nullopt;
+    }
+
+    return results;
+}
+
+} // namespace vrm
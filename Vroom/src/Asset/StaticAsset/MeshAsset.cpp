@@ -1,23 +1,65 @@
 #include "Vroom/Asset/StaticAsset/MeshAsset.h"
 
-#include <OBJ_Loader/OBJ_Loader.h>
+#include <algorithm>
+#include <bit>
 
 #include "Vroom/Core/Assert.h"
 #include "Vroom/Asset/AssetInstance/MeshInstance.h"
 
 #include "Vroom/Asset/AssetManager.h"
+#include "Vroom/Asset/Parsing/MeshCache.h"
+#include "Vroom/Asset/Parsing/ObjParsing.h"
 #include "Vroom/Asset/StaticAsset/MaterialAsset.h"
 
 namespace vrm
 {
 
-MeshAsset::SubMesh::SubMesh(RenderMesh&& render, MeshData&& data, MaterialInstance instance)
-    : renderMesh(std::move(render)), meshData(std::move(data)), materialInstance(instance)
+bool MeshAsset::s_OptimizeMeshesByDefault = false;
+
+MeshAsset::SubMesh::SubMesh(MeshData&& data, const Vertex* vertices, size_t vertexCount, MaterialInstance instance, uint32_t renderMeshIndex, uint32_t meshIndex)
+    : meshData(std::move(data)), materialInstance(instance), renderMeshIndex(renderMeshIndex), meshIndex(meshIndex), boundsCenter(0.f), boundsRadius(0.f)
+{
+    if (vertexCount == 0)
+        return;
+
+    // Centered on the bounding box, which is close enough to the smallest sphere for LOD selection
+    glm::vec3 min = vertices[0].position, max = min;
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        min = glm::min(min, vertices[i].position);
+        max = glm::max(max, vertices[i].position);
+    }
+
+    boundsCenter = (min + max) * 0.5f;
+    for (size_t i = 0; i < vertexCount; i++)
+        boundsRadius = std::max(boundsRadius, glm::length(vertices[i].position - boundsCenter));
+}
+
+size_t MeshAsset::SubMesh::selectLod(const glm::mat4& model, const CameraBasic& camera) const
 {
+    if (meshData.getLodCount() == 1)
+        return 0;
+
+    const float scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+    const float radius = boundsRadius * scale;
+    const glm::mat4& projection = camera.getProjection();
+
+    // projection[1][1] is 1 / tan(fovy / 2) in perspective, 2 / height in orthographic projection, where the distance does not matter
+    float distance = 1.f;
+    if (projection[3][3] != 1.f)
+    {
+        distance = glm::length(glm::vec3(model * glm::vec4(boundsCenter, 1.f)) - camera.getPosition());
+
+        // The camera is inside the bounds
+        if (distance <= radius)
+            return 0;
+    }
+
+    return meshData.selectLod(radius * projection[1][1] / distance);
 }
 
 MeshAsset::MeshAsset()
-    : StaticAsset()
+    : StaticAsset(), m_OptimizeMeshes(s_OptimizeMeshesByDefault)
 {
 }
 
@@ -30,20 +72,129 @@ MeshInstance MeshAsset::createInstance()
     return MeshInstance(this);
 }
 
-void MeshAsset::addSubmesh(const MeshData& mesh, MaterialInstance instance)
+const MeshAsset::SubMesh& MeshAsset::getSubMesh(SubMeshHandle handle) const
+{
+    VRM_ASSERT_MSG(handle < m_SubMeshes.size(), "Submesh {} does not exist.", handle);
+
+    return m_SubMeshes[handle];
+}
+
+const RenderMesh::DrawRange& MeshAsset::getDrawRange(SubMeshHandle handle, size_t lod) const
+{
+    const SubMesh& subMesh = getSubMesh(handle);
+    VRM_ASSERT_MSG(lod < subMesh.meshData.getLodCount(), "LOD {} does not exist, submesh {} has {} levels.", lod, handle, subMesh.meshData.getLodCount());
+
+    return m_RenderMeshes[subMesh.renderMeshIndex].getDrawRange(subMesh.meshIndex, lod);
+}
+
+MeshAsset::SubMeshHandle MeshAsset::addSubmesh(const MeshData& mesh, MaterialInstance instance)
+{
+    return addSubmesh(MeshData(mesh), instance);
+}
+
+MeshAsset::SubMeshHandle MeshAsset::addSubmesh(const MeshData& mesh)
+{
+    return addSubmesh(MeshData(mesh));
+}
+
+MeshAsset::SubMeshHandle MeshAsset::addSubmesh(MeshData&& mesh, MaterialInstance instance)
 {
-    m_SubMeshes.emplace_back(SubMesh(RenderMesh(mesh), MeshData(mesh), instance));
+    std::vector<MeshData> meshes;
+    meshes.push_back(std::move(mesh));
+
+    return addSharedSubmeshes(std::move(meshes), { instance }).front();
 }
 
-void MeshAsset::addSubmesh(const MeshData& mesh)
+MeshAsset::SubMeshHandle MeshAsset::addSubmesh(MeshData&& mesh)
 {
     MaterialInstance materialInstance = AssetManager::Get().getAsset<MaterialAsset>("Resources/Engine/Material/Mat_Default.asset");
-    m_SubMeshes.emplace_back(SubMesh(RenderMesh(mesh), MeshData(mesh), materialInstance));
+    return addSubmesh(std::move(mesh), materialInstance);
+}
+
+std::vector<MeshAsset::SubMeshHandle> MeshAsset::addSharedSubmeshes(std::vector<MeshData>&& meshes, const std::vector<MaterialInstance>& instances)
+{
+    VRM_ASSERT_MSG(meshes.size() == instances.size(), "{} meshes were given {} materials.", meshes.size(), instances.size());
+
+    optimizeMeshes(meshes);
+
+    return uploadSubmeshes(std::move(meshes), instances);
+}
+
+void MeshAsset::setOptimizeMeshes(bool optimizeMeshes, const MeshOptimizer::Settings& settings)
+{
+    m_OptimizeMeshes = optimizeMeshes;
+    m_OptimizerSettings = settings;
+}
+
+void MeshAsset::optimizeMeshes(std::vector<MeshData>& meshes)
+{
+    if (!m_OptimizeMeshes)
+        return;
+
+    MeshOptimizer::Report report;
+    for (MeshData& mesh : meshes)
+        report += MeshOptimizer::Optimize(mesh, m_OptimizerSettings);
+
+    m_OptimizationReport += report;
+
+    VRM_LOG_TRACE("Optimized {} meshes. ACMR: {:.3f} -> {:.3f}, ATVR: {:.3f} -> {:.3f}",
+        meshes.size(), report.before.getAcmr(), report.after.getAcmr(), report.before.getAtvr(), report.after.getAtvr());
+}
+
+std::vector<MeshAsset::SubMeshHandle> MeshAsset::uploadSubmeshes(std::vector<MeshData>&& meshes, const std::vector<MaterialInstance>& instances)
+{
+    // Moving a mesh keeps its storage, so the geometries stay valid once the meshes are moved into the submeshes
+    std::vector<RenderMesh::MeshGeometry> geometries;
+    geometries.reserve(meshes.size());
+    for (const auto& mesh : meshes)
+        geometries.push_back(RenderMesh::MeshGeometry::FromMeshData(mesh));
+
+    return uploadSubmeshes(geometries, std::move(meshes), instances);
+}
+
+std::vector<MeshAsset::SubMeshHandle> MeshAsset::uploadSubmeshes(const std::vector<RenderMesh::MeshGeometry>& geometries, std::vector<MeshData>&& meshes, const std::vector<MaterialInstance>& instances)
+{
+    const uint32_t renderMeshIndex = (uint32_t)m_RenderMeshes.size();
+    m_RenderMeshes.emplace_back(geometries);
+
+    std::vector<SubMeshHandle> handles;
+    handles.reserve(meshes.size());
+    m_SubMeshes.reserve(m_SubMeshes.size() + meshes.size());
+
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        handles.push_back((SubMeshHandle)m_SubMeshes.size());
+        SubMesh& subMesh = m_SubMeshes.emplace_back(std::move(meshes[i]), geometries[i].vertices, geometries[i].vertexCount, instances[i], renderMeshIndex, (uint32_t)i);
+
+        // The bounds were computed from the vertices by the submesh
+        if (!m_KeepMeshData)
+            subMesh.meshData.releaseGeometry();
+    }
+
+    return handles;
+}
+
+void MeshAsset::updateSubmeshVertices(SubMeshHandle handle, size_t firstVertex, const Vertex* vertices, size_t vertexCount)
+{
+    VRM_ASSERT_MSG(handle < m_SubMeshes.size(), "Submesh {} does not exist.", handle);
+
+    SubMesh& subMesh = m_SubMeshes[handle];
+    if (!subMesh.meshData.isGeometryReleased())
+        subMesh.meshData.updateVertices(firstVertex, vertices, vertexCount);
+
+    RenderMesh& renderMesh = m_RenderMeshes[subMesh.renderMeshIndex];
+    renderMesh.updateVertices(renderMesh.getDrawRange(subMesh.meshIndex).baseVertex + firstVertex, vertices, vertexCount);
+
+    // The bounds only grow, so that they stay conservative without a pass over every vertex
+    for (size_t i = 0; i < vertexCount; i++)
+        subMesh.boundsRadius = std::max(subMesh.boundsRadius, glm::length(vertices[i].position - subMesh.boundsCenter));
 }
 
 void MeshAsset::clear()
 {
     m_SubMeshes.clear();
+    m_RenderMeshes.clear();
+    m_OptimizationReport = MeshOptimizer::Report();
 }
 
 bool MeshAsset::loadImpl(const std::string& filePath)
@@ -64,85 +215,140 @@ bool MeshAsset::loadImpl(const std::string& filePath)
 
 bool MeshAsset::loadObj(const std::string& filePath)
 {
-    objl::Loader loader;
-    if (!loader.LoadFile(filePath))
+    const std::string fileDirectoryPath = GetDirectoryPath(filePath);
+
+    MeshCache cache;
+    if (cache.open(filePath, getCacheProcessingKey()))
+        return loadCache(cache, filePath, fileDirectoryPath);
+
+    VRM_LOG_INFO("Loading mesh from file: {}", filePath);
+
+    std::optional<ObjParsing::ParsingResults> results = ObjParsing::Parse(filePath);
+    if (!results)
     {
         VRM_LOG_ERROR("Failed to load obj file: {}", filePath);
         return false;
     }
 
-    std::string fileDirectoryPath;
-    size_t lastSlashIndex = filePath.find_last_of('/');
-    if (lastSlashIndex != std::string::npos)
+    VRM_LOG_TRACE("| Loading {} submeshes.", results->meshes.size());
+
+    // Every submesh of the file goes in the same buffers
+    std::vector<MeshData> meshes;
+    std::vector<std::string> meshNames, materialNames;
+    std::vector<MaterialInstance> materialInstances;
+    meshes.reserve(results->meshes.size());
+    meshNames.reserve(results->meshes.size());
+    materialNames.reserve(results->meshes.size());
+    materialInstances.reserve(results->meshes.size());
+
+    for (auto& mesh : results->meshes)
     {
-        fileDirectoryPath = filePath.substr(0, lastSlashIndex + 1);
+        VRM_LOG_TRACE("| | SubMesh: {}", mesh.name);
+        VRM_LOG_TRACE("| | | Vertices count: {}", mesh.meshData.getVertexCount());
+        VRM_LOG_TRACE("| | | Indices count: {}", mesh.meshData.getIndexCount());
+        VRM_LOG_TRACE("| | | Material: {}", mesh.materialName);
+
+        materialInstances.push_back(GetObjMaterial(fileDirectoryPath, mesh.materialName));
+        meshNames.push_back(std::move(mesh.name));
+        materialNames.push_back(std::move(mesh.materialName));
+        meshes.push_back(std::move(mesh.meshData));
     }
+
+    // Before the cache is written, so that next loads skip it too
+    optimizeMeshes(meshes);
+
+    // Next loads map this instead of parsing the text again. Not fatal, the mesh is loaded either way.
+    if (MeshCache::Write(filePath, meshes, meshNames, materialNames, getCacheProcessingKey()))
+        VRM_LOG_TRACE("| Wrote mesh cache: {}", MeshCache::CachePath(filePath));
     else
-    {
-        lastSlashIndex = filePath.find_last_of('\\');
-        if (lastSlashIndex != std::string::npos)
-        {
-            fileDirectoryPath = filePath.substr(0, lastSlashIndex + 1);
-        }
-    }
+        VRM_LOG_WARN("Failed to write mesh cache: {}", MeshCache::CachePath(filePath));
 
-    VRM_LOG_INFO("Loading mesh from file: {}", filePath);
-    VRM_LOG_TRACE("| Loading {} submeshes.", loader.LoadedMeshes.size());
+    uploadSubmeshes(std::move(meshes), materialInstances);
+
+    VRM_LOG_TRACE("| Submeshes loaded.");
 
-    for (const auto& mesh : loader.LoadedMeshes)
+    VRM_LOG_INFO("Mesh loaded.");
+
+    return true;
+}
+
+bool MeshAsset::loadCache(const MeshCache& cache, const std::string& filePath, const std::string& fileDirectoryPath)
+{
+    VRM_LOG_INFO("Loading mesh from cache: {}", MeshCache::CachePath(filePath));
+    VRM_LOG_TRACE("| Loading {} submeshes.", cache.getMeshCount());
+
+    std::vector<RenderMesh::MeshGeometry> geometries;
+    std::vector<MeshData> meshes;
+    std::vector<MaterialInstance> materialInstances;
+    geometries.reserve(cache.getMeshCount());
+    meshes.reserve(cache.getMeshCount());
+    materialInstances.reserve(cache.getMeshCount());
+
+    for (size_t i = 0; i < cache.getMeshCount(); i++)
     {
-        VRM_LOG_TRACE("| | SubMesh: {}", mesh.MeshName);
-        VRM_LOG_TRACE("| | | Vertices count: {}", mesh.Vertices.size());
-        VRM_LOG_TRACE("| | | Indices count: {}", mesh.Indices.size());
-        VRM_LOG_TRACE("| | | Material: {}", mesh.MaterialName);
-
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
-
-        vertices.reserve(mesh.Vertices.size());
-        indices.reserve(mesh.Indices.size());
-
-        for (const auto& vertex : mesh.Vertices)
-        {
-            vertices.emplace_back(
-                Vertex{ 
-                    { vertex.Position.X         , vertex.Position.Y         , vertex.Position.Z },
-                    { vertex.Normal.X           , vertex.Normal.Y           , vertex.Normal.Z },
-                    { vertex.TextureCoordinate.X, vertex.TextureCoordinate.Y }
-                }
-            );
-        }
-
-        for (const auto& index : mesh.Indices)
-        {
-            indices.emplace_back(index);
-        }
-        
-        if (!mesh.MaterialName.empty())
-        {
-            MaterialInstance materialInstance = AssetManager::Get().getAsset<MaterialAsset>(fileDirectoryPath + mesh.MaterialName + ".asset");
-            MeshData meshData(std::move(vertices), std::move(indices));
-            RenderMesh renderMesh(meshData);
-
-            m_SubMeshes.emplace_back(std::move(renderMesh), std::move(meshData), materialInstance);
-        }
-        else
-        {
-            MaterialInstance materialInstance = AssetManager::Get().getAsset<MaterialAsset>("Resources/Engine/Material/Mat_Default.asset");
-            MeshData meshData(std::move(vertices), std::move(indices));
-            RenderMesh renderMesh(meshData);
+        const MeshCache::MeshView mesh = cache.getMesh(i);
+
+        VRM_LOG_TRACE("| | SubMesh: {}", mesh.name);
+        VRM_LOG_TRACE("| | | Vertices count: {}", mesh.vertexCount);
+        VRM_LOG_TRACE("| | | Indices count: {}", mesh.indexCount);
+        VRM_LOG_TRACE("| | | Material: {}", mesh.materialName);
 
-            m_SubMeshes.emplace_back(std::move(renderMesh), std::move(meshData), materialInstance);
-        }
+        // The buffers are filled straight from the mapped pages
+        geometries.push_back({ mesh.vertices, mesh.vertexCount, { std::span<const uint32_t>(mesh.indices, mesh.indexCount) }, mesh.primitiveType });
 
-        VRM_LOG_TRACE("| | Loaded sub mesh: {}", mesh.MeshName);
+        // Stored as MeshData stores them, so a kept copy is one block copy each. Otherwise only the counts are.
+        if (m_KeepMeshData)
+            meshes.emplace_back(std::vector<Vertex>(mesh.vertices, mesh.vertices + mesh.vertexCount), std::vector<uint32_t>(mesh.indices, mesh.indices + mesh.indexCount), mesh.primitiveType);
+        else
+            meshes.push_back(MeshData::Released(mesh.vertexCount, mesh.indices, mesh.indexCount, mesh.primitiveType));
+
+        materialInstances.push_back(GetObjMaterial(fileDirectoryPath, std::string(mesh.materialName)));
     }
 
-    VRM_LOG_TRACE("| Submeshes loaded.");
+    // Optimized already if the asset optimizes, the processing key of the cache matching
+    uploadSubmeshes(geometries, std::move(meshes), materialInstances);
 
     VRM_LOG_INFO("Mesh loaded.");
 
     return true;
 }
 
+uint64_t MeshAsset::getCacheProcessingKey() const
+{
+    if (!m_OptimizeMeshes)
+        return 0;
+
+    // Everything that changes the optimized meshes
+    const MeshOptimizer::Settings& settings = m_OptimizerSettings;
+    const uint32_t fields[] = {
+        MeshOptimizer::Version,
+        settings.cacheSize,
+        (uint32_t)settings.reorderVertexCache | (uint32_t)settings.reorderOverdraw << 1 | (uint32_t)settings.reorderVertexFetch << 2,
+        std::bit_cast<uint32_t>(settings.overdrawThreshold)
+    };
+
+    const uint64_t key = MeshCache::Hash(reinterpret_cast<const std::byte*>(fields), sizeof(fields));
+    return key != 0 ? key : 1;
+}
+
+std::string MeshAsset::GetDirectoryPath(const std::string& filePath)
+{
+    size_t lastSlashIndex = filePath.find_last_of('/');
+    if (lastSlashIndex == std::string::npos)
+        lastSlashIndex = filePath.find_last_of('\\');
+
+    if (lastSlashIndex == std::string::npos)
+        return "";
+
+    return filePath.substr(0, lastSlashIndex + 1);
+}
+
+MaterialInstance MeshAsset::GetObjMaterial(const std::string& fileDirectoryPath, const std::string& materialName)
+{
+    if (!materialName.empty())
+        return AssetManager::Get().getAsset<MaterialAsset>(fileDirectoryPath + materialName + ".asset");
+
+    return AssetManager::Get().getAsset<MaterialAsset>("Resources/Engine/Material/Mat_Default.asset");
+}
+
 } // namespace vrm
\ No newline at end of file
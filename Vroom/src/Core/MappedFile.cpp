@@ -0,0 +1,154 @@
+#include "Vroom/Core/MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace vrm
+{
+
+MappedFile::MappedFile(MappedFile&& other)
+    : m_Data(std::exchange(other.m_Data, nullptr)),
+      m_Size(std::exchange(other.m_Size, 0)),
+      m_IsOpen(std::exchange(other.m_IsOpen, false))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this != &other)
+    {
+        close();
+
+        m_Data = std::exchange(other.m_Data, nullptr);
+        m_Size = std::exchange(other.m_Size, 0);
+        m_IsOpen = std::exchange(other.m_IsOpen, false);
+    }
+
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filePath)
+{
+    close();
+
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Empty files cannot be mapped, but they are valid files
+    if (size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        // The view keeps the file mapped once both handles are closed
+        m_Data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+
+        if (m_Data == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+    }
+
+    CloseHandle(file);
+
+    m_Size = (size_t)size.QuadPart;
+    m_IsOpen = true;
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_Data != nullptr)
+        UnmapViewOfFile(m_Data);
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filePath)
+{
+    close();
+
+    int file = ::open(filePath.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    // Empty files cannot be mapped, but they are valid files
+    if (status.st_size > 0)
+    {
+        void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(file);
+            return false;
+        }
+
+        // Files are read front to back, let the system read ahead
+        madvise(data, (size_t)status.st_size, MADV_SEQUENTIAL);
+        m_Data = static_cast<const std::byte*>(data);
+    }
+
+    // The mapping stays valid once the descriptor is closed
+    ::close(file);
+
+    m_Size = (size_t)status.st_size;
+    m_IsOpen = true;
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_Data != nullptr)
+        munmap(const_cast<std::byte*>(m_Data), m_Size);
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
+
+#endif
+
+} // namespace vrm
@@ -3,15 +3,23 @@
 #include "Vroom/Render/Abstraction/GLCall.h"
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
-	: m_RendererID(0), m_Count(count)
+	: m_RendererID(0), m_Count(count), m_IndexType(GL_UNSIGNED_INT)
 {
 	GLCall(glGenBuffers(1, &m_RendererID));
 	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
 	GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
 }
 
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int count)
+	: m_RendererID(0), m_Count(count), m_IndexType(GL_UNSIGNED_SHORT)
+{
+	GLCall(glGenBuffers(1, &m_RendererID));
+	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+	GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned short), data, GL_STATIC_DRAW));
+}
+
 IndexBuffer::IndexBuffer(IndexBuffer&& other)
-	: m_RendererID(other.m_RendererID), m_Count(other.m_Count)
+	: m_RendererID(other.m_RendererID), m_Count(other.m_Count), m_IndexType(other.m_IndexType)
 {
 	other.m_RendererID = 0;
 }
@@ -22,6 +30,7 @@ IndexBuffer& IndexBuffer::operator=(IndexBuffer&& other)
 	{
 		m_RendererID = other.m_RendererID;
 		m_Count = other.m_Count;
+		m_IndexType = other.m_IndexType;
 		other.m_RendererID = 0;
 	}
 
@@ -42,3 +51,14 @@ void IndexBuffer::unbind() const
 {
 	GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
+
+unsigned int IndexBuffer::getIndexSize() const
+{
+	return m_IndexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+}
+
+void IndexBuffer::setSubData(const void* data, unsigned int count, unsigned int firstIndex)
+{
+	bind();
+	GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, firstIndex * getIndexSize(), count * getIndexSize(), data));
+}
@@ -41,3 +41,9 @@ void VertexBuffer::unbind() const
 {
 	GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
+
+void VertexBuffer::setSubData(const void* data, unsigned int size, unsigned int offset)
+{
+	bind();
+	GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
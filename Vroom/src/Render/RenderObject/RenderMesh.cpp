@@ -1,26 +1,82 @@
 #include "Vroom/Render/RenderObject/RenderMesh.h"
 
+#include <algorithm>
+
+#include "Vroom/Core/Assert.h"
 #include "Vroom/Core/Log.h"
 
 namespace vrm
 {
 
 RenderMesh::RenderMesh(const MeshData& meshData)
-    : m_VertexBuffer(meshData.getRawVericesData(), (unsigned int)meshData.getVertexCount() * sizeof(Vertex)),
-      m_IndexBuffer(meshData.getRawIndicesData(), (unsigned int)meshData.getIndexCount())
+    : RenderMesh(std::vector<const MeshData*>{ &meshData })
+{
+}
+
+RenderMesh::MeshGeometry RenderMesh::MeshGeometry::FromMeshData(const MeshData& meshData)
+{
+    VRM_ASSERT_MSG(!meshData.isGeometryReleased(), "Cannot upload a mesh whose geometry was released.");
+
+    MeshGeometry geometry;
+    geometry.vertices = meshData.getRawVericesData();
+    geometry.vertexCount = meshData.getVertexCount();
+    geometry.primitiveType = meshData.getPrimitiveType();
+
+    geometry.lodIndices.reserve(meshData.getLodCount());
+    for (size_t lod = 0; lod < meshData.getLodCount(); lod++)
+        geometry.lodIndices.emplace_back(meshData.getLodIndices(lod));
+
+    return geometry;
+}
+
+RenderMesh::RenderMesh(const std::vector<const MeshData*>& meshes)
+    : RenderMesh(GetGeometries(meshes))
+{
+}
+
+RenderMesh::RenderMesh(const std::vector<MeshGeometry>& meshes)
+    : m_VertexBuffer(nullptr, (unsigned int)(CountVertices(meshes) * sizeof(Vertex))),
+      m_IndexBuffer(AllocateIndexBuffer(CountIndices(meshes), SharedIndexFormat(meshes))),
+      m_PrimitiveType(meshes.empty() ? MeshData::PrimitiveType::Triangles : meshes.front().primitiveType)
 {
     m_VertexBufferLayout.pushFloat(3);
     m_VertexBufferLayout.pushFloat(3);
     m_VertexBufferLayout.pushFloat(2);
 
     m_VertexArray.addBuffer(m_VertexBuffer, m_VertexBufferLayout);
+
+    // Vertices, then every level of every mesh, one after the other
+    size_t vertexOffset = 0, indexOffset = 0;
+    m_DrawRanges.reserve(meshes.size());
+
+    for (const MeshGeometry& mesh : meshes)
+    {
+        VRM_ASSERT_MSG(mesh.primitiveType == m_PrimitiveType, "Meshes sharing buffers must share their primitive type.");
+
+        m_VertexBuffer.setSubData(mesh.vertices, (unsigned int)(mesh.vertexCount * sizeof(Vertex)), (unsigned int)(vertexOffset * sizeof(Vertex)));
+
+        auto& ranges = m_DrawRanges.emplace_back();
+        ranges.reserve(mesh.lodIndices.size());
+
+        for (std::span<const uint32_t> indices : mesh.lodIndices)
+        {
+            UploadIndices(m_IndexBuffer, indices, indexOffset);
+
+            ranges.push_back({ indexOffset, indices.size(), (int32_t)vertexOffset });
+            indexOffset += indices.size();
+        }
+
+        vertexOffset += mesh.vertexCount;
+    }
 }
 
 RenderMesh::RenderMesh(RenderMesh&& other)
     : m_VertexBuffer(std::move(other.m_VertexBuffer)),
       m_IndexBuffer(std::move(other.m_IndexBuffer)),
       m_VertexArray(std::move(other.m_VertexArray)),
-      m_VertexBufferLayout(std::move(other.m_VertexBufferLayout))
+      m_VertexBufferLayout(std::move(other.m_VertexBufferLayout)),
+      m_PrimitiveType(other.m_PrimitiveType),
+      m_DrawRanges(std::move(other.m_DrawRanges))
 {
 }
 
@@ -32,6 +88,8 @@ RenderMesh& RenderMesh::operator=(RenderMesh&& other)
         m_IndexBuffer = std::move(other.m_IndexBuffer);
         m_VertexArray = std::move(other.m_VertexArray);
         m_VertexBufferLayout = std::move(other.m_VertexBufferLayout);
+        m_PrimitiveType = other.m_PrimitiveType;
+        m_DrawRanges = std::move(other.m_DrawRanges);
     }
 
     return *this;
@@ -41,4 +99,77 @@ RenderMesh::~RenderMesh()
 {
 }
 
-} // namespace vrm
\ No newline at end of file
+std::vector<RenderMesh::MeshGeometry> RenderMesh::GetGeometries(const std::vector<const MeshData*>& meshes)
+{
+    std::vector<MeshGeometry> geometries;
+    geometries.reserve(meshes.size());
+    for (const MeshData* mesh : meshes)
+        geometries.push_back(MeshGeometry::FromMeshData(*mesh));
+
+    return geometries;
+}
+
+size_t RenderMesh::CountVertices(const std::vector<MeshGeometry>& meshes)
+{
+    size_t vertexCount = 0;
+    for (const MeshGeometry& mesh : meshes)
+        vertexCount += mesh.vertexCount;
+
+    return vertexCount;
+}
+
+size_t RenderMesh::CountIndices(const std::vector<MeshGeometry>& meshes)
+{
+    size_t indexCount = 0;
+    for (const MeshGeometry& mesh : meshes)
+        for (std::span<const uint32_t> indices : mesh.lodIndices)
+            indexCount += indices.size();
+
+    return indexCount;
+}
+
+MeshData::IndexFormat RenderMesh::SharedIndexFormat(const std::vector<MeshGeometry>& meshes)
+{
+    // Indices are relative to their mesh, so only the largest one matters
+    size_t largestVertexCount = 0;
+    for (const MeshGeometry& mesh : meshes)
+        largestVertexCount = std::max(largestVertexCount, mesh.vertexCount);
+
+    return MeshData::SmallestIndexFormat(largestVertexCount);
+}
+
+IndexBuffer RenderMesh::AllocateIndexBuffer(size_t indexCount, MeshData::IndexFormat format)
+{
+    if (format == MeshData::IndexFormat::UInt32)
+        return IndexBuffer(static_cast<const unsigned int*>(nullptr), (unsigned int)indexCount);
+
+    return IndexBuffer(static_cast<const unsigned short*>(nullptr), (unsigned int)indexCount);
+}
+
+void RenderMesh::UploadIndices(IndexBuffer& indexBuffer, std::span<const uint32_t> indices, size_t firstIndex)
+{
+    if (indices.empty())
+        return;
+
+    if (indexBuffer.getIndexSize() == sizeof(uint32_t))
+    {
+        indexBuffer.setSubData(indices.data(), (unsigned int)indices.size(), (unsigned int)firstIndex);
+        return;
+    }
+
+    // Narrowing keeps the low bits: the 32 bit restart index becomes the 16 bit one
+    std::vector<uint16_t> narrowIndices(indices.begin(), indices.end());
+    indexBuffer.setSubData(narrowIndices.data(), (unsigned int)narrowIndices.size(), (unsigned int)firstIndex);
+}
+
+void RenderMesh::updateVertices(const MeshData& meshData, size_t firstVertex, size_t vertexCount)
+{
+    updateVertices(firstVertex, meshData.getRawVericesData() + firstVertex, vertexCount);
+}
+
+void RenderMesh::updateVertices(size_t firstVertex, const Vertex* vertices, size_t vertexCount)
+{
+    m_VertexBuffer.setSubData(vertices, (unsigned int)(vertexCount * sizeof(Vertex)), (unsigned int)(firstVertex * sizeof(Vertex)));
+}
+
+} // namespace vrm
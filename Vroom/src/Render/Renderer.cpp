@@ -57,6 +57,9 @@ Renderer::Renderer()
     GLCall(glEnable(GL_CULL_FACE));
     GLCall(glCullFace(GL_BACK));
     GLCall(glFrontFace(GL_CCW));
+
+    // Strips end on an all ones index, whichever the index type
+    GLCall(glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX));
 }
 
 Renderer::~Renderer()
@@ -127,15 +130,23 @@ void Renderer::drawMesh(const MeshInstance& mesh, const glm::mat4& model) const
 {
     VRM_DEBUG_ASSERT_MSG(m_Camera, "No camera set for rendering. Did you call beginScene?");
 
-    const auto& subMeshes = mesh.getStaticAsset()->getSubMeshes();
+    const MeshAsset* meshAsset = mesh.getStaticAsset();
 
     const auto cameraPos = m_Camera->getPosition();
+    const RenderMesh* boundRenderMesh = nullptr;
 
-    for (const auto& subMesh : subMeshes)
+    for (const auto& subMesh : meshAsset->getSubMeshes())
     {
-        // Binding data
-        subMesh.renderMesh.getVertexArray().bind();
-        subMesh.renderMesh.getIndexBuffer().bind();
+        const RenderMesh& renderMesh = meshAsset->getRenderMesh(subMesh);
+        const IndexBuffer& indexBuffer = renderMesh.getIndexBuffer();
+
+        // Binding data, once for the submeshes sharing buffers
+        if (&renderMesh != boundRenderMesh)
+        {
+            renderMesh.getVertexArray().bind();
+            indexBuffer.bind();
+            boundRenderMesh = &renderMesh;
+        }
 
         const Shader& shader = subMesh.materialInstance.getStaticAsset()->getShader();
         shader.bind();
@@ -165,8 +176,11 @@ void Renderer::drawMesh(const MeshInstance& mesh, const glm::mat4& model) const
             shader.setUniform1iv("u_Texture", (int)textureCount, textureSlots.data());
         }
 
-        // Drawing data
-        GLCall(glDrawElements(GL_TRIANGLES, (GLsizei)subMesh.renderMesh.getIndexBuffer().getCount(), GL_UNSIGNED_INT, nullptr));
+        // Drawing data: coarser levels of detail are other ranges of the same index buffer
+        const RenderMesh::DrawRange& range = renderMesh.getDrawRange(subMesh.meshIndex, subMesh.selectLod(model, *m_Camera));
+        const GLenum primitive = renderMesh.getPrimitiveType() == MeshData::PrimitiveType::TriangleStrip ? GL_TRIANGLE_STRIP : GL_TRIANGLES;
+        const void* firstIndexOffset = reinterpret_cast<const void*>(range.firstIndex * indexBuffer.getIndexSize());
+        GLCall(glDrawElementsBaseVertex(primitive, (GLsizei)range.indexCount, indexBuffer.getIndexType(), firstIndexOffset, range.baseVertex));
     }
 
 }
@@ -28,8 +28,9 @@ protected:
         delete meshAsset;
         delete app;
 
-        // Remove the fake obj file
+        // Remove the fake obj file, and the cache written when loading it
         std::remove(pathOK.c_str());
+        std::remove((pathOK + ".vmesh").c_str());
     }
 
     vrm::Application* app;
@@ -73,8 +74,22 @@ TEST_F(TestMeshAsset, LoadObjCorrect)
     EXPECT_EQ(indices[2], 2);
 }
 
+TEST_F(TestMeshAsset, LoadObjOptimized)
+{
+    meshAsset->setOptimizeMeshes(true);
+    ASSERT_TRUE(meshAsset->load(pathOK));
+    EXPECT_EQ(meshAsset->getOptimizationReport().before.triangleCount, 1);
+    EXPECT_EQ(meshAsset->getOptimizationReport().after.transformedVertexCount, 3);
+
+    // The cache was written optimized, so the next asset optimizing the same way maps it and has nothing left to do
+    vrm::MeshAsset cachedAsset;
+    cachedAsset.setOptimizeMeshes(true);
+    ASSERT_TRUE(cachedAsset.load(pathOK));
+    EXPECT_EQ(cachedAsset.getOptimizationReport().before.triangleCount, 0);
+}
+
 TEST_F(TestMeshAsset, GetRenderMesh)
 {
     meshAsset->load(pathOK);
-    EXPECT_NO_THROW(const vrm::RenderMesh& renderMesh = meshAsset->getSubMeshes().begin()->renderMesh;);
+    EXPECT_NO_THROW(const vrm::RenderMesh& renderMesh = meshAsset->getRenderMesh(meshAsset->getSubMesh(0)););
 }
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <Vroom/Asset/Parsing/MeshCache.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+class TestMeshCache : public testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        writeSource("o Triangle\n");
+
+        std::vector<vrm::Vertex> vertices = {
+            { { 0.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 0.f } },
+            { { 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, { 1.f, 0.f } },
+            { { 1.f, 1.f, 0.f }, { 0.f, 0.f, 1.f }, { 1.f, 1.f } }
+        };
+        meshes.emplace_back(std::move(vertices), std::vector<uint32_t>{ 0, 1, 2 });
+        meshes.emplace_back(std::vector<vrm::Vertex>(4), std::vector<uint32_t>{ 0, 1, 2, 3 }, vrm::MeshData::PrimitiveType::TriangleStrip);
+    }
+
+    void TearDown() override
+    {
+        std::remove(sourcePath.c_str());
+        std::remove(vrm::MeshCache::CachePath(sourcePath).c_str());
+    }
+
+    void writeSource(const std::string& content)
+    {
+        std::ofstream file(sourcePath, std::ios::out | std::ios::trunc);
+        file << content;
+    }
+
+    void writeCache()
+    {
+        ASSERT_TRUE(vrm::MeshCache::Write(sourcePath, meshes, { "Triangle", "Strip" }, { "Mat_Red", "" }));
+    }
+
+    std::string sourcePath = "test_mesh_cache.obj";
+    std::vector<vrm::MeshData> meshes;
+};
+
+TEST_F(TestMeshCache, MissingCache)
+{
+    vrm::MeshCache cache;
+    EXPECT_FALSE(cache.open(sourcePath));
+    EXPECT_FALSE(cache.isOpen());
+}
+
+TEST_F(TestMeshCache, RoundTrip)
+{
+    writeCache();
+
+    vrm::MeshCache cache;
+    ASSERT_TRUE(cache.open(sourcePath));
+    ASSERT_EQ(cache.getMeshCount(), 2);
+
+    vrm::MeshCache::MeshView triangle = cache.getMesh(0);
+    EXPECT_EQ(triangle.name, "Triangle");
+    EXPECT_EQ(triangle.materialName, "Mat_Red");
+    EXPECT_EQ(triangle.primitiveType, vrm::MeshData::PrimitiveType::Triangles);
+    ASSERT_EQ(triangle.vertexCount, 3);
+    EXPECT_EQ(triangle.vertices[2].position, glm::vec3(1.f, 1.f, 0.f));
+    EXPECT_EQ(triangle.vertices[1].texCoords, glm::vec2(1.f, 0.f));
+    EXPECT_EQ(std::vector<uint32_t>(triangle.indices, triangle.indices + triangle.indexCount), meshes[0].getIndices());
+
+    vrm::MeshCache::MeshView strip = cache.getMesh(1);
+    EXPECT_EQ(strip.materialName, "");
+    EXPECT_EQ(strip.primitiveType, vrm::MeshData::PrimitiveType::TriangleStrip);
+    EXPECT_EQ(strip.vertexCount, 4);
+    EXPECT_EQ(strip.indexCount, 4);
+}
+
+TEST_F(TestMeshCache, ChangedSourceInvalidates)
+{
+    writeCache();
+    writeSource("o Triangle\nv 0 0 0\n");
+
+    vrm::MeshCache cache;
+    EXPECT_FALSE(cache.open(sourcePath));
+}
+
+TEST_F(TestMeshCache, SameSizeChangeInvalidates)
+{
+    writeCache();
+    writeSource("o Tangle!!\n");
+    std::filesystem::last_write_time(sourcePath, std::filesystem::last_write_time(sourcePath) + std::chrono::seconds(1));
+
+    vrm::MeshCache cache;
+    EXPECT_FALSE(cache.open(sourcePath));
+}
+
+TEST_F(TestMeshCache, TouchedSourceKeepsCache)
+{
+    writeCache();
+    writeSource("o Triangle\n");
+    std::filesystem::last_write_time(sourcePath, std::filesystem::last_write_time(sourcePath) + std::chrono::seconds(1));
+
+    vrm::MeshCache cache;
+    EXPECT_TRUE(cache.open(sourcePath));
+    cache.close();
+
+    // The new time was recorded
+    EXPECT_TRUE(cache.open(sourcePath));
+}
+
+TEST_F(TestMeshCache, OtherProcessingInvalidates)
+{
+    ASSERT_TRUE(vrm::MeshCache::Write(sourcePath, meshes, { "Triangle", "Strip" }, { "Mat_Red", "" }, 42));
+
+    vrm::MeshCache cache;
+    EXPECT_FALSE(cache.open(sourcePath));
+    EXPECT_FALSE(cache.open(sourcePath, 7));
+    EXPECT_TRUE(cache.open(sourcePath, 42));
+}
+
+TEST_F(TestMeshCache, TruncatedCacheIsRejected)
+{
+    writeCache();
+    const std::string cachePath = vrm::MeshCache::CachePath(sourcePath);
+    std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 8);
+
+    vrm::MeshCache cache;
+    EXPECT_FALSE(cache.open(sourcePath));
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <Vroom/Asset/AssetData/MeshData.h>
+
+static vrm::MeshData makeQuad()
+{
+    std::vector<vrm::Vertex> vertices(4);
+    std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+    return vrm::MeshData(std::move(vertices), std::move(indices));
+}
+
+TEST(MeshDataLod, NoLevels)
+{
+    vrm::MeshData meshData = makeQuad();
+
+    EXPECT_EQ(meshData.getLodCount(), 1);
+    EXPECT_EQ(meshData.selectLod(0.f), 0);
+    EXPECT_EQ(&meshData.getLodIndices(0), &meshData.getIndices());
+}
+
+TEST(MeshDataLod, SelectLod)
+{
+    vrm::MeshData meshData = makeQuad();
+    meshData.addLodLevel({ 0, 1, 2 }, 0.5f);
+    meshData.addLodLevel({ 0, 2, 3 }, 0.1f);
+
+    EXPECT_EQ(meshData.getLodCount(), 3);
+    EXPECT_EQ(meshData.selectLod(2.f), 0);
+    EXPECT_EQ(meshData.selectLod(0.5f), 1);
+    EXPECT_EQ(meshData.selectLod(0.2f), 1);
+    EXPECT_EQ(meshData.selectLod(0.05f), 2);
+    EXPECT_EQ(meshData.getLodIndices(2), std::vector<uint32_t>({ 0, 2, 3 }));
+}
+
+TEST(MeshDataLod, CopyKeepsLevels)
+{
+    vrm::MeshData meshData = makeQuad();
+    meshData.addLodLevel({ 0, 1, 2 }, 0.5f);
+
+    vrm::MeshData copy = meshData;
+    vrm::MeshData moved = std::move(meshData);
+
+    EXPECT_EQ(copy.getLodCount(), 2);
+    EXPECT_EQ(moved.getLodCount(), 2);
+    EXPECT_EQ(moved.getLodIndices(1), std::vector<uint32_t>({ 0, 1, 2 }));
+
+    copy.clearLodLevels();
+    EXPECT_EQ(copy.getLodCount(), 1);
+}
+
+TEST(MeshDataPrimitives, StripTriangleCount)
+{
+    std::vector<vrm::Vertex> vertices(8);
+    const uint32_t restart = vrm::MeshData::RestartIndex;
+    vrm::MeshData meshData(vertices, { 0, 1, 2, 3, restart, 4, 5, 6, 7 }, vrm::MeshData::PrimitiveType::TriangleStrip);
+
+    EXPECT_EQ(meshData.getPrimitiveType(), vrm::MeshData::PrimitiveType::TriangleStrip);
+    EXPECT_EQ(meshData.getTriangleCount(), 4);
+    EXPECT_EQ(makeQuad().getTriangleCount(), 2);
+}
+
+TEST(MeshDataPrimitives, IndexFormat)
+{
+    EXPECT_EQ(makeQuad().getIndexFormat(), vrm::MeshData::IndexFormat::UInt16);
+
+    std::vector<vrm::Vertex> vertices(vrm::MeshData::MaxUInt16VertexCount + 1);
+    vrm::MeshData meshData(std::move(vertices), { 0, 1, 2 });
+
+    EXPECT_EQ(meshData.getIndexFormat(), vrm::MeshData::IndexFormat::UInt32);
+}
+
+TEST(MeshDataRelease, KeepsCountsAndLevels)
+{
+    vrm::MeshData meshData = makeQuad();
+    meshData.addLodLevel({ 0, 1, 2 }, 0.5f);
+    meshData.releaseGeometry();
+
+    EXPECT_TRUE(meshData.isGeometryReleased());
+    EXPECT_TRUE(meshData.getVertices().empty());
+    EXPECT_TRUE(meshData.getIndices().empty());
+    EXPECT_EQ(meshData.getVertexCount(), 4);
+    EXPECT_EQ(meshData.getIndexCount(), 6);
+    EXPECT_EQ(meshData.getTriangleCount(), 2);
+    EXPECT_EQ(meshData.getLodCount(), 2);
+    EXPECT_EQ(meshData.selectLod(0.1f), 1);
+}
+
+TEST(MeshDataRelease, MoveTakesTheVertices)
+{
+    vrm::MeshData meshData = makeQuad();
+    const vrm::Vertex* vertices = meshData.getRawVericesData();
+
+    vrm::MeshData moved = std::move(meshData);
+
+    EXPECT_EQ(moved.getRawVericesData(), vertices);
+    EXPECT_EQ(moved.getVertexCount(), 4);
+    EXPECT_EQ(meshData.getVertexCount(), 0);
+}
+
+TEST(MeshDataPrimitives, ReleasedDescribesGeometry)
+{
+    const uint32_t restart = vrm::MeshData::RestartIndex;
+    const uint32_t indices[] = { 0, 1, 2, 3, restart, 4, 5, 6 };
+    vrm::MeshData meshData = vrm::MeshData::Released(70000, indices, 8, vrm::MeshData::PrimitiveType::TriangleStrip);
+
+    EXPECT_TRUE(meshData.isGeometryReleased());
+    EXPECT_TRUE(meshData.getVertices().empty());
+    EXPECT_EQ(meshData.getVertexCount(), 70000);
+    EXPECT_EQ(meshData.getIndexCount(), 8);
+    EXPECT_EQ(meshData.getTriangleCount(), 3);
+    EXPECT_EQ(meshData.getIndexFormat(), vrm::MeshData::IndexFormat::UInt32);
+}
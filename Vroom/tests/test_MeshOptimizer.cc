@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <Vroom/Asset/AssetData/MeshOptimizer.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+// n x n quads, triangles and vertices shuffled so that neither the cache nor the fetches get any locality for free
+static vrm::MeshData makeShuffledGrid(uint32_t n)
+{
+    std::mt19937 random(42);
+
+    std::vector<uint32_t> order((n + 1) * (n + 1));
+    for (uint32_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), random);
+
+    std::vector<vrm::Vertex> vertices(order.size());
+    for (uint32_t i = 0; i <= n; i++)
+        for (uint32_t j = 0; j <= n; j++)
+            vertices[order[i * (n + 1) + j]].position = glm::vec3((float)i, 0.f, (float)j);
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            const uint32_t a = order[i * (n + 1) + j], b = order[i * (n + 1) + j + 1];
+            const uint32_t c = order[(i + 1) * (n + 1) + j], d = order[(i + 1) * (n + 1) + j + 1];
+            triangles.push_back({ a, b, d });
+            triangles.push_back({ a, d, c });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), random);
+
+    std::vector<uint32_t> indices;
+    for (const auto& triangle : triangles)
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+
+    return vrm::MeshData(std::move(vertices), std::move(indices));
+}
+
+using Triangle = std::array<float, 9>;
+
+// The triangles of a level by their positions, each starting from its smallest corner so that winding is kept, sorted
+static std::vector<Triangle> getTriangles(const vrm::MeshData& mesh, size_t lod = 0)
+{
+    const std::vector<uint32_t>& indices = mesh.getLodIndices(lod);
+    std::vector<Triangle> triangles;
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<glm::vec3, 3> corners;
+        for (size_t k = 0; k < 3; k++)
+            corners[k] = mesh.getVertices()[indices[i + k]].position;
+
+        auto less = [](const glm::vec3& a, const glm::vec3& b) { return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z); };
+        std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end(), less), corners.end());
+
+        Triangle triangle;
+        for (size_t k = 0; k < 3; k++)
+            for (size_t c = 0; c < 3; c++)
+                triangle[3 * k + c] = corners[k][(int)c];
+        triangles.push_back(triangle);
+    }
+
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+TEST(MeshOptimizer, AnalyzeVertexCache)
+{
+    std::vector<vrm::Vertex> vertices(8);
+    vrm::MeshData quad(vertices, { 0, 1, 2, 0, 2, 3 });
+
+    vrm::MeshOptimizer::CacheStats stats = vrm::MeshOptimizer::AnalyzeVertexCache(quad);
+    EXPECT_EQ(stats.transformedVertexCount, 4);
+    EXPECT_FLOAT_EQ(stats.getAcmr(), 2.f);
+    EXPECT_FLOAT_EQ(stats.getAtvr(), 0.5f);
+
+    // Vertex 0 is out of a cache of 2 when used again
+    EXPECT_EQ(vrm::MeshOptimizer::AnalyzeVertexCache(quad, 2).transformedVertexCount, 5);
+
+    const uint32_t restart = vrm::MeshData::RestartIndex;
+    vrm::MeshData strip(vertices, { 0, 1, 2, 3, restart, 4, 5, 6, 7 }, vrm::MeshData::PrimitiveType::TriangleStrip);
+    EXPECT_EQ(vrm::MeshOptimizer::AnalyzeVertexCache(strip).transformedVertexCount, 8);
+}
+
+TEST(MeshOptimizer, ReducesCacheMisses)
+{
+    vrm::MeshData mesh = makeShuffledGrid(64);
+    const std::vector<Triangle> triangles = getTriangles(mesh);
+
+    vrm::MeshOptimizer::Report report = vrm::MeshOptimizer::Optimize(mesh);
+
+    EXPECT_EQ(report.before.triangleCount, 64 * 64 * 2);
+    EXPECT_GT(report.before.getAcmr(), 2.f);
+    EXPECT_LT(report.after.getAcmr(), 0.8f);
+    EXPECT_LT(report.after.getAtvr(), 1.5f);
+    EXPECT_EQ(report.after.transformedVertexCount, vrm::MeshOptimizer::AnalyzeVertexCache(mesh).transformedVertexCount);
+
+    EXPECT_EQ(mesh.getVertexCount(), 65 * 65);
+    EXPECT_EQ(getTriangles(mesh), triangles);
+}
+
+TEST(MeshOptimizer, VertexFetchIsLinear)
+{
+    vrm::MeshData mesh = makeShuffledGrid(16);
+    vrm::MeshOptimizer::Optimize(mesh);
+
+    // Every index is either already used or the next vertex of the buffer
+    uint32_t nextVertex = 0;
+    for (uint32_t index : mesh.getIndices())
+    {
+        ASSERT_LE(index, nextVertex);
+        if (index == nextVertex)
+            nextVertex++;
+    }
+
+    EXPECT_EQ(nextVertex, mesh.getVertexCount());
+}
+
+TEST(MeshOptimizer, LodLevelsAreRemapped)
+{
+    vrm::MeshData mesh = makeShuffledGrid(16);
+
+    // Every other triangle
+    std::vector<uint32_t> lodIndices;
+    for (size_t i = 0; i < mesh.getIndexCount(); i += 6)
+        lodIndices.insert(lodIndices.end(), mesh.getIndices().begin() + i, mesh.getIndices().begin() + i + 3);
+    mesh.addLodLevel(std::move(lodIndices), 0.25f);
+
+    const std::vector<Triangle> lodTriangles = getTriangles(mesh, 1);
+    vrm::MeshOptimizer::Optimize(mesh);
+
+    ASSERT_EQ(mesh.getLodCount(), 2);
+    EXPECT_EQ(mesh.getLodLevels()[0].screenSize, 0.25f);
+    EXPECT_EQ(getTriangles(mesh, 1), lodTriangles);
+}
+
+TEST(MeshOptimizer, SettingsSkipSteps)
+{
+    vrm::MeshData mesh = makeShuffledGrid(16);
+    const std::vector<Triangle> triangles = getTriangles(mesh);
+    const size_t transformedVertexCount = vrm::MeshOptimizer::AnalyzeVertexCache(mesh).transformedVertexCount;
+
+    // Vertex numbers kept, for meshes updated in place
+    vrm::MeshOptimizer::Settings settings;
+    settings.reorderVertexFetch = false;
+
+    vrm::MeshData reordered = mesh;
+    vrm::MeshOptimizer::Optimize(reordered, settings);
+    EXPECT_EQ(getTriangles(reordered), triangles);
+    for (size_t i = 0; i < mesh.getVertexCount(); i++)
+        ASSERT_EQ(reordered.getVertices()[i].position, mesh.getVertices()[i].position);
+
+    // Fetch order alone does not change what the cache sees
+    settings.reorderVertexFetch = true;
+    settings.reorderVertexCache = false;
+
+    vrm::MeshData renumbered = mesh;
+    vrm::MeshOptimizer::Report report = vrm::MeshOptimizer::Optimize(renumbered, settings);
+    EXPECT_EQ(report.after.transformedVertexCount, transformedVertexCount);
+    EXPECT_EQ(getTriangles(renumbered), triangles);
+}
+
+TEST(MeshOptimizer, StripsAreLeftAlone)
+{
+    std::vector<vrm::Vertex> vertices(4);
+    vrm::MeshData strip(vertices, { 3, 2, 1, 0 }, vrm::MeshData::PrimitiveType::TriangleStrip);
+
+    vrm::MeshOptimizer::Report report = vrm::MeshOptimizer::Optimize(strip);
+
+    EXPECT_EQ(strip.getIndices(), std::vector<uint32_t>({ 3, 2, 1, 0 }));
+    EXPECT_EQ(report.after.transformedVertexCount, report.before.transformedVertexCount);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <Vroom/Asset/Parsing/ObjParsing.h>
+
+#include <string>
+
+static std::string corner(int64_t element, int64_t normal)
+{
+    return std::to_string(element) + "/" + std::to_string(element) + "/" + std::to_string(normal);
+}
+
+// n x n quads whose positions and texture coordinates share their index. Relative faces follow the elements they use, absolute ones come last.
+static std::string makeGrid(int64_t n, bool relativeIndices)
+{
+    std::string text = "o Grid\nusemtl Mat_Grid\nvn 0 1 0\n";
+    std::string faces;
+
+    for (int64_t i = 0; i <= n; i++)
+    {
+        for (int64_t j = 0; j <= n; j++)
+        {
+            text += "v " + std::to_string(i) + " 0 " + std::to_string(j) + "\n";
+            text += "vt " + std::to_string((float)i / n) + " " + std::to_string((float)j / n) + "\n";
+
+            if (i == 0 || j == 0)
+                continue;
+
+            if (relativeIndices)
+                text += "f " + corner(-(n + 3), -1) + " " + corner(-2, -1) + " " + corner(-1, -1) + " " + corner(-(n + 2), -1) + "\n";
+            else
+            {
+                const int64_t d = i * (n + 1) + j + 1;
+                faces += "f " + corner(d - n - 2, 1) + " " + corner(d - 1, 1) + " " + corner(d, 1) + " " + corner(d - n - 1, 1) + "\n";
+            }
+        }
+    }
+
+    return text + faces;
+}
+
+TEST(ObjParsing, Triangle)
+{
+    auto results = vrm::ObjParsing::ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\nvt 0 0\nvt 1 0\nvt 1 1\nvn 0 0 1\nf 1/1/1 2/2/1 3/3/1\n");
+
+    ASSERT_TRUE(results);
+    ASSERT_EQ(results->meshes.size(), 1);
+
+    const vrm::MeshData& mesh = results->meshes[0].meshData;
+    EXPECT_EQ(mesh.getVertexCount(), 3);
+    EXPECT_EQ(mesh.getIndices(), std::vector<uint32_t>({ 0, 1, 2 }));
+    EXPECT_EQ(mesh.getVertices()[2].position, glm::vec3(1.f, 1.f, 0.f));
+    EXPECT_EQ(mesh.getVertices()[1].texCoords, glm::vec2(1.f, 0.f));
+    EXPECT_EQ(mesh.getVertices()[0].normal, glm::vec3(0.f, 0.f, 1.f));
+}
+
+TEST(ObjParsing, PolygonsAreFans)
+{
+    auto results = vrm::ObjParsing::ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3 4\n");
+
+    ASSERT_TRUE(results);
+    EXPECT_EQ(results->meshes[0].meshData.getIndices(), std::vector<uint32_t>({ 0, 1, 2, 0, 2, 3 }));
+}
+
+TEST(ObjParsing, SharedCornersAreDeduplicated)
+{
+    auto results = vrm::ObjParsing::ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 1\nf 1/1 2/1 3/1\nf 1/1 3/1 4/1\nf 1/2 3/2 4/2\n");
+
+    ASSERT_TRUE(results);
+    const vrm::MeshData& mesh = results->meshes[0].meshData;
+
+    // The last face has other texture coordinates, so it does not share its corners
+    EXPECT_EQ(mesh.getVertexCount(), 7);
+    EXPECT_EQ(mesh.getIndices(), std::vector<uint32_t>({ 0, 1, 2, 0, 2, 3, 4, 5, 6 }));
+}
+
+TEST(ObjParsing, MissingNormalsAreComputed)
+{
+    auto results = vrm::ObjParsing::ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n");
+
+    ASSERT_TRUE(results);
+    for (const vrm::Vertex& vertex : results->meshes[0].meshData.getVertices())
+        EXPECT_EQ(vertex.normal, glm::vec3(0.f, 0.f, 1.f));
+}
+
+TEST(ObjParsing, RelativeIndices)
+{
+    auto results = vrm::ObjParsing::ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\nf -3 -2 -1\nv 2 2 0\nf -4 -2 -1\n");
+
+    ASSERT_TRUE(results);
+    const vrm::MeshData& mesh = results->meshes[0].meshData;
+    ASSERT_EQ(mesh.getIndexCount(), 6);
+    EXPECT_EQ(mesh.getVertices()[mesh.getIndices()[5]].position, glm::vec3(2.f, 2.f, 0.f));
+    EXPECT_EQ(mesh.getVertices()[mesh.getIndices()[3]].position, glm::vec3(0.f, 0.f, 0.f));
+}
+
+TEST(ObjParsing, GroupsAndMaterialsSplitMeshes)
+{
+    auto results = vrm::ObjParsing::ParseText(
+        "v 0 0 0\nv 1 0 0\nv 1 1 0\n"
+        "o First\nusemtl Red\nf 1 2 3\nusemtl Red\nf 1 2 3\nusemtl Blue\nf 1 2 3\n"
+        "o Second\nf 1 2 3\n");
+
+    ASSERT_TRUE(results);
+    ASSERT_EQ(results->meshes.size(), 3);
+
+    EXPECT_EQ(results->meshes[0].name, "First");
+    EXPECT_EQ(results->meshes[0].materialName, "Red");
+    EXPECT_EQ(results->meshes[0].meshData.getTriangleCount(), 2);
+    EXPECT_EQ(results->meshes[1].materialName, "Blue");
+    EXPECT_EQ(results->meshes[2].name, "Second");
+    EXPECT_EQ(results->meshes[2].materialName, "Blue");
+}
+
+TEST(ObjParsing, Failures)
+{
+    EXPECT_FALSE(vrm::ObjParsing::ParseText(""));
+    EXPECT_FALSE(vrm::ObjParsing::ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\n"));
+    EXPECT_FALSE(vrm::ObjParsing::ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 4\n"));
+    EXPECT_FALSE(vrm::ObjParsing::ParseText("v 0 0 zero\nv 1 0 0\nv 1 1 0\nf 1 2 3\n"));
+    EXPECT_FALSE(vrm::ObjParsing::Parse("test_obj_parsing_missing.obj"));
+}
+
+TEST(ObjParsing, ChunksMatchSingleThread)
+{
+    for (bool relativeIndices : { false, true })
+    {
+        // Several chunks of MinChunkSize
+        const std::string text = makeGrid(250, relativeIndices);
+        ASSERT_GT(text.size(), 2 * vrm::ObjParsing::MinChunkSize);
+
+        auto single = vrm::ObjParsing::ParseText(text, 1);
+        auto chunked = vrm::ObjParsing::ParseText(text, 4);
+
+        ASSERT_TRUE(single);
+        ASSERT_TRUE(chunked);
+        ASSERT_EQ(single->chunkCount, 1);
+        ASSERT_GT(chunked->chunkCount, 1);
+        ASSERT_EQ(single->meshes.size(), 1);
+        ASSERT_EQ(chunked->meshes.size(), 1);
+        EXPECT_EQ(chunked->meshes[0].name, "Grid");
+        EXPECT_EQ(chunked->meshes[0].materialName, "Mat_Grid");
+
+        const vrm::MeshData& a = single->meshes[0].meshData;
+        const vrm::MeshData& b = chunked->meshes[0].meshData;
+
+        EXPECT_EQ(a.getVertexCount(), 251 * 251);
+        EXPECT_EQ(a.getIndices(), b.getIndices());
+        ASSERT_EQ(a.getVertexCount(), b.getVertexCount());
+        for (size_t i = 0; i < a.getVertexCount(); i++)
+            ASSERT_EQ(a.getVertices()[i].position, b.getVertices()[i].position);
+    }
+}